@@ -0,0 +1,78 @@
+/** @file    bench.h
+ *  @brief   Declarations of the host-side benchmarks.
+ *  @details Each benchmark lives in its own @c bench_*.cpp file and prints a
+ *           small table to standard output. They are run one after another by
+ *           @c main() in @c bench_main.cpp when the @c native environment is
+ *           built and run.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stdint.h>
+#include <chrono>
+
+/** @brief   Return a monotonic time stamp in nanoseconds.
+ *  @returns Nanoseconds since an arbitrary fixed point in time
+ */
+inline int64_t bench_now_ns (void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (
+        std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+/// Compare @c Share<T> with @c FastShare<T> under 1, 2 and 4 threads
+void bench_share (void);
+
+/// Check @c Queue<T>'s batches, wrap-around, overflows, timeout and a
+/// producer racing a sleeping consumer, returning the number of failed checks
+int bench_queue (void);
+
+/// Time one call of @c PIDController::getCtrlOutput()
+void bench_pid (void);
+
+/// Compare separate @c PIDController objects with a @c ControllerBank<N>
+void bench_bank (void);
+
+/// Run a host copy of the IMU, controller and motor tasks for one second
+void bench_tasks (void);
+
+/// Run a host copy of the task table and print its schedule report
+void bench_sched (void);
+
+/// Compare simulated servo step responses at 20 Hz and 1 kHz
+void bench_servo (void);
+
+/// Time how quickly a @c StateMachine reacts to events and its timer
+void bench_fsm (void);
+
+/// Compare attitude estimators on a synthetic IMU trace and time the filter
+void bench_fusion (void);
+
+/// Check the timing of IMU FIFO samples, also after an overrun, and compare
+/// the I2C load of reads, returning the number of runs timed too far off
+int bench_fifo (void);
+
+/// Compare how old an IMU batch is when an interrupt or a poll wakes the task
+void bench_wake (void);
+
+/// Check the accuracy of the fast math functions and time them against libm,
+/// returning the number which exceed their error bounds
+int bench_fastmath (void);
+
+/// Count false flips of the near-ground decision on replayed ping traces
+void bench_range (void);
+
+/// Compare when the flare starts from the near-ground decision and the time to contact
+void bench_flare (void);
+
+/// Measure the noise and age of potentiometer readings, single and oversampled
+void bench_adc (void);
+
+/// Compare the accuracy and cost of the fixed potentiometer scale and calibration tables
+void bench_potcal (void);
+
+#endif // _BENCH_H_
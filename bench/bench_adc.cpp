@@ -0,0 +1,171 @@
+/** @file    bench_adc.cpp
+ *  @brief   Noise and age of potentiometer readings from single
+ *           conversions and from the oversampled @c AdcDecimator stream.
+ *  @details A potentiometer is converted at half of @c ADC_SAMPLE_RATE, as
+ *           when the stream takes both pots in turn. Each conversion has
+ *           Gaussian noise, and now and then one is wild, anywhere in the
+ *           ADC's range, as the ESP32's ADC gives. The DMA hands over a frame
+ *           of @c ADC_OVERSAMPLE conversions of each pin at a time. The
+ *           servo loop reads the pot at 1 kHz, either with one conversion
+ *           of its own, as @c analogRead() does, or by taking the latest
+ *           reading of the stream. With the pot held still, the noise of
+ *           what the servo sees and the number of reads which jump by more
+ *           than the servo task's 30 degree guard are counted; with the pot
+ *           turning steadily, the age of the data is found from the lag.
+ *           The time taken by the decimator on the host is printed last.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <random>
+#include "bench.h"
+#include "adcdecimator.h"
+
+/// ADC_SAMPLE_RATE from adcstream.h, which needs the ESP32's driver
+static const float SAMPLE_RATE = 20000.0f;
+static const int PINS = 2;                      ///< Pins sharing the ADC
+static const float DEG_PER_COUNT = 3.3f / 4096 * 60;   ///< As in Potentiometer
+static const float NOISE_COUNTS = 6.0f;         ///< Standard deviation of each conversion (counts)
+static const double WILD = 0.001;               ///< Fraction of conversions which are wild
+static const float SERVO_S = 0.001f;            ///< Period of the servo loop (s)
+static const float RUN_S = 60.0f;               ///< Time the pot is held still (s)
+static const float RAMP = 100.0f;               ///< Speed of the turning pot (deg/s)
+static const int SWEEPS = 60;                   ///< One second sweeps of the turning pot
+static const uint8_t CHANNEL = 6;               ///< ADC1 channel of GPIO 34
+
+
+/// What the servo saw over one run
+struct ServoView
+{
+    double sum_sq = 0;              ///< Total squared error of the readings (deg^2)
+    double sum_error = 0;           ///< Total error of the readings (deg)
+    double worst = 0;               ///< Largest error (deg)
+    uint32_t jumps = 0;             ///< Reads more than 30 degrees from the one before
+    uint32_t reads = 0;             ///< Reads counted
+};
+
+
+/** @brief   Simulate the servo loop reading one pot.
+ *  @param   streamed True to read the oversampled stream, false to take one
+ *           conversion per read
+ *  @param   speed Speed at which the pot turns (deg/s), zero to hold it still
+ *  @param   seconds Length of the run (s)
+ *  @param   seed Seed for the noise
+ *  @param   view Added to with what the servo saw
+ */
+static void run (bool streamed, float speed, float seconds, uint32_t seed,
+                 ServoView& view)
+{
+    std::mt19937 rng (seed);
+    std::normal_distribution<float> noise (0.0f, NOISE_COUNTS);
+    std::uniform_real_distribution<double> chance (0.0, 1.0);
+    std::uniform_int_distribution<int> anywhere (0, 4095);
+
+    // The pot's true angle, starting below the middle of its range
+    auto angle = [speed] (double t) { return -50.0 + speed * t; };
+    auto convert = [&] (double t)
+    {
+        if (chance (rng) < WILD)
+        {
+            return (uint16_t)anywhere (rng);
+        }
+        float counts = 2048.0f + (float)angle (t) / DEG_PER_COUNT + noise (rng);
+        counts = fminf (fmaxf (roundf (counts), 0.0f), 4095.0f);
+        return (uint16_t)counts;
+    };
+
+    AdcDecimator decimator;
+    AdcReading published = {};
+    const double conversion_s = 1.0 / SAMPLE_RATE;
+    const uint32_t frame = ADC_OVERSAMPLE * PINS;
+    uint32_t conversion = 0;
+    double last_deg = 0;
+    bool have_last = false;
+
+    for (double t = SERVO_S; t < seconds; t += SERVO_S)
+    {
+        double measured_deg;
+        if (streamed)
+        {
+            // Hand over every frame which has finished by now; this pot is
+            // every other conversion
+            while ((conversion + frame) * conversion_s <= t)
+            {
+                for (uint32_t index = 0; index < frame; index += PINS)
+                {
+                    double when = (conversion + index) * conversion_s;
+                    if (decimator.add (CHANNEL, convert (when), (uint32_t)(when * 1e6)))
+                    {
+                        published = decimator.reading (CHANNEL);
+                    }
+                }
+                conversion += frame;
+            }
+            if (published.sequence == 0)
+            {
+                continue;
+            }
+            measured_deg = (published.counts - 2048.0f) * DEG_PER_COUNT;
+        }
+        else
+        {
+            measured_deg = (convert (t) - 2048.0f) * DEG_PER_COUNT;
+        }
+
+        double error = measured_deg - angle (t);
+        view.sum_sq += error * error;
+        view.sum_error += error;
+        view.worst = fmax (view.worst, fabs (error));
+        if (have_last && fabs (measured_deg - last_deg) > 30.0)
+        {
+            view.jumps++;
+        }
+        last_deg = measured_deg;
+        have_last = true;
+        view.reads++;
+    }
+}
+
+
+void bench_adc (void)
+{
+    printf ("Potentiometer reads at %.0f Hz; conversions at %.0f Hz per pin, "
+            "noise %.0f counts, %.1f%% wild\n", 1.0f / SERVO_S,
+            SAMPLE_RATE / PINS, NOISE_COUNTS, 100 * WILD);
+    printf ("method                  noise rms deg  worst deg  30 deg jumps/min"
+            "  age avg ms\n");
+
+    const char* names[2] = { "analogRead()", "AdcStream" };
+    for (int m = 0; m < 2; m++)
+    {
+        ServoView still;
+        ServoView turning;
+        run (m == 1, 0.0f, RUN_S, 1, still);
+        for (int sweep = 0; sweep < SWEEPS; sweep++)
+        {
+            run (m == 1, RAMP, 1.0f, 2 + sweep, turning);
+        }
+
+        // A reading d seconds old lags a steadily turning pot by d times its speed
+        double age_ms = -1000.0 * turning.sum_error / turning.reads / RAMP;
+        printf ("%-22s  %13.3f  %9.2f  %16.1f  %10.2f\n", names[m],
+                sqrt (still.sum_sq / still.reads), still.worst,
+                still.jumps * 60.0 / RUN_S, age_ms);
+    }
+
+    // Cost of the decimator per conversion on this machine
+    AdcDecimator decimator;
+    const uint32_t conversions = 10000000;
+    volatile uint32_t completed = 0;
+    int64_t start = bench_now_ns ();
+    for (uint32_t index = 0; index < conversions; index++)
+    {
+        completed += decimator.add ((index & 1) ? 3 : 6, (uint16_t)(2000 + (index & 15)), index * 50);
+    }
+    int64_t elapsed = bench_now_ns () - start;
+    printf ("AdcDecimator::add() on the host: %.1f ns per conversion\n\n",
+            (double)elapsed / conversions);
+}
@@ -0,0 +1,112 @@
+/** @file    bench_bank.cpp
+ *  @brief   Benchmark of @c ControllerBank<N> against separate
+ *           @c PIDController objects.
+ *  @details The object version is written the way @c task_controller used to
+ *           be: one @c getCtrlOutput() call per loop, each followed by its own
+ *           saturation branches. The bank runs the same loops, gains and
+ *           limits in one @c update() call. Both are run with 4 loops (the
+ *           glider's rudder and elevator cascades) and 8 loops (as if ailerons
+ *           and flaps were added) over the same noisy measurements.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "bench.h"
+#include "PIDController.h"
+#include "controllerbank.h"
+
+/// Number of time steps in the measurement trace
+static const uint32_t STEPS = 4096;
+
+/// Number of times the trace is run through the controllers
+static const uint32_t PASSES = 100;
+
+
+/** @brief   Time N loops run as objects and as a bank.
+ *  @details Returns nothing; prints one line of results.
+ */
+template <uint8_t N>
+static void compare (void)
+{
+    // Measurements for every loop at every step, stored step by step
+    std::vector<float> measured (STEPS * N);
+    for (uint32_t step = 0; step < STEPS; step++)
+    {
+        for (uint8_t loop = 0; loop < N; loop++)
+        {
+            float t = step * 0.05f;
+            measured[step * N + loop] = 60.0f * sinf (0.3f * t + loop)
+                                        + 5.0f * sinf (11.0f * t * (loop + 1));
+        }
+    }
+    float desired[N] = {};
+    float output[N];
+    const float limit = 50.0f;
+
+    std::vector<PIDController> objects;
+    for (uint8_t loop = 0; loop < N; loop++)
+    {
+        objects.push_back (PIDController (1.5f, 0.2f, 0.05f, 0.05f));
+    }
+
+    float sink = 0.0f;
+    int64_t start = bench_now_ns ();
+    for (uint32_t pass = 0; pass < PASSES; pass++)
+    {
+        for (uint32_t step = 0; step < STEPS; step++)
+        {
+            for (uint8_t loop = 0; loop < N; loop++)
+            {
+                float out = objects[loop].getCtrlOutput (
+                    measured[step * N + loop], desired[loop]);
+                if (out > limit)
+                {
+                    out = limit;
+                }
+                else if (out < -limit)
+                {
+                    out = -limit;
+                }
+                sink += out;
+            }
+        }
+    }
+    double object_ns = (double)(bench_now_ns () - start) / (STEPS * PASSES);
+
+    ControllerBank<N> bank;
+    for (uint8_t loop = 0; loop < N; loop++)
+    {
+        bank.set_loop (loop, 1.5f, 0.2f, 0.05f, 0.05f, -limit, limit);
+    }
+
+    start = bench_now_ns ();
+    for (uint32_t pass = 0; pass < PASSES; pass++)
+    {
+        for (uint32_t step = 0; step < STEPS; step++)
+        {
+            bank.update (&measured[step * N], desired, output);
+            for (uint8_t loop = 0; loop < N; loop++)
+            {
+                sink += output[loop];
+            }
+        }
+    }
+    double bank_ns = (double)(bench_now_ns () - start) / (STEPS * PASSES);
+
+    printf ("%5u  %9.1f  %7.1f  %8.2f  (checksum %g)\n", N, object_ns,
+            bank_ns, object_ns / bank_ns, (double)sink);
+}
+
+
+void bench_bank (void)
+{
+    printf ("PIDController objects vs. ControllerBank<N> (ns per update of all loops)\n");
+    printf ("loops  objects     bank   speedup\n");
+    compare<4> ();
+    compare<8> ();
+    printf ("\n");
+}
@@ -0,0 +1,153 @@
+/** @file    bench_fastmath.cpp
+ *  @brief   Accuracy and speed of the approximations in @c fastmath.h
+ *           against @c libm.
+ *  @details Each function is swept over a dense grid of its arguments and
+ *           compared with the double precision @c libm result, and the
+ *           largest error is printed beside the bound stated in
+ *           @c fastmath.h; a line which exceeds its bound is marked FAIL,
+ *           and the failures are counted so that the run can fail.
+ *           Then each is timed over an array of arguments beside the single
+ *           precision @c libm function it replaces.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "bench.h"
+#include "fastmath.h"
+
+/// Number of arguments in each timing array
+static const size_t TIMING_COUNT = 4096;
+
+/// Number of passes over the timing array
+static const int TIMING_PASSES = 500;
+
+
+/** @brief   Print one accuracy line.
+ *  @param   label The function's name
+ *  @param   worst The largest error found
+ *  @param   bound The error bound stated in @c fastmath.h
+ *  @param   kind Whether the error is absolute or relative
+ *  @returns One if the error exceeds the bound, zero if not
+ */
+static int accuracy (const char* label, double worst, double bound,
+                     const char* kind)
+{
+    printf ("%-16s %10.2e  %10.2e  %-8s %s\n", label, worst, bound, kind,
+            (worst <= bound) ? "ok" : "FAIL");
+    return (worst <= bound) ? 0 : 1;
+}
+
+
+/** @brief   Time a function over an array of arguments.
+ *  @param   function The function, taking and returning a float
+ *  @param   args The arguments
+ *  @returns The time per call (ns)
+ */
+template <typename Function>
+static double time_per_call (Function function, const std::vector<float>& args)
+{
+    volatile float sink = 0.0f;
+    int64_t start = bench_now_ns ();
+    for (int pass = 0; pass < TIMING_PASSES; pass++)
+    {
+        float sum = 0.0f;
+        for (float arg : args)
+        {
+            sum += function (arg);
+        }
+        sink = sink + sum;
+    }
+    return (double)(bench_now_ns () - start) / (TIMING_PASSES * args.size ());
+}
+
+
+int bench_fastmath (void)
+{
+    int failures = 0;
+    printf ("fastmath accuracy against libm    max error       bound\n");
+
+    // atan2 around circles of many radii, which covers every octant
+    double worst = 0.0;
+    for (int ring = -6; ring <= 6; ring++)
+    {
+        double radius = pow (10.0, ring);
+        for (int step = 0; step < 100000; step++)
+        {
+            double angle = -M_PI + 2 * M_PI * step / 100000.0;
+            float y = (float)(radius * sin (angle));
+            float x = (float)(radius * cos (angle));
+            double err = fabs (remainder (fast_atan2 (y, x) - atan2 ((double)y, (double)x),
+                                          2 * M_PI));
+            worst = (err > worst) ? err : worst;
+        }
+    }
+    failures += accuracy ("fast_atan2", worst, 1.5e-5, "abs rad");
+
+    worst = 0.0;
+    for (int step = 0; step <= 200000; step++)
+    {
+        float x = (float)(-1.0 + 2.0 * step / 200000.0);
+        double err = fabs (fast_asin (x) - asin ((double)x));
+        worst = (err > worst) ? err : worst;
+    }
+    failures += accuracy ("fast_asin", worst, 2e-5, "abs rad");
+
+    worst = 0.0;
+    for (int step = 0; step <= 1000000; step++)
+    {
+        float x = (float)(-100.0 + 200.0 * step / 1000000.0);
+        float s, c;
+        fast_sincos (x, s, c);
+        double err_s = fabs (s - sin ((double)x));
+        double err_c = fabs (c - cos ((double)x));
+        worst = (err_s > worst) ? err_s : worst;
+        worst = (err_c > worst) ? err_c : worst;
+    }
+    failures += accuracy ("fast_sincos", worst, 1e-6, "abs");
+
+    worst = 0.0;
+    double worst_sqrt = 0.0;
+    for (int step = 0; step <= 1000000; step++)
+    {
+        float x = (float)pow (10.0, -30.0 + 60.0 * step / 1000000.0);
+        double exact = sqrt ((double)x);
+        double err = fabs (fast_inv_sqrt (x) * exact - 1.0);
+        worst = (err > worst) ? err : worst;
+        err = fabs (fast_sqrt (x) / exact - 1.0);
+        worst_sqrt = (err > worst_sqrt) ? err : worst_sqrt;
+    }
+    failures += accuracy ("fast_inv_sqrt", worst, 5e-6, "relative");
+    failures += accuracy ("fast_sqrt", worst_sqrt, 5e-6, "relative");
+
+    // Timing, on arguments the attitude filter would see
+    std::vector<float> angles (TIMING_COUNT);
+    std::vector<float> ratios (TIMING_COUNT);
+    std::vector<float> positives (TIMING_COUNT);
+    for (size_t index = 0; index < TIMING_COUNT; index++)
+    {
+        angles[index] = -3.0f + 6.0f * index / TIMING_COUNT;
+        ratios[index] = -0.99f + 1.98f * index / TIMING_COUNT;
+        positives[index] = 0.01f + 100.0f * index / TIMING_COUNT;
+    }
+
+    printf ("\nfastmath speed                  fast ns   libm ns\n");
+    printf ("%-28s %9.2f %9.2f\n", "atan2 (y, 0.7)",
+            time_per_call ([] (float a) { return fast_atan2 (a, 0.7f); }, angles),
+            time_per_call ([] (float a) { return atan2f (a, 0.7f); }, angles));
+    printf ("%-28s %9.2f %9.2f\n", "asin",
+            time_per_call ([] (float a) { return fast_asin (a); }, ratios),
+            time_per_call ([] (float a) { return asinf (a); }, ratios));
+    printf ("%-28s %9.2f %9.2f\n", "sin + cos",
+            time_per_call ([] (float a) { float s, c; fast_sincos (a, s, c);
+                                          return s + c; }, angles),
+            time_per_call ([] (float a) { return sinf (a) + cosf (a); }, angles));
+    printf ("%-28s %9.2f %9.2f\n", "1 / sqrt",
+            time_per_call ([] (float a) { return fast_inv_sqrt (a); }, positives),
+            time_per_call ([] (float a) { return 1.0f / sqrtf (a); }, positives));
+    printf ("\n");
+    return failures;
+}
@@ -0,0 +1,275 @@
+/** @file    bench_fifo.cpp
+ *  @brief   Timing accuracy, cost and bus load of reading the IMU through its
+ *           FIFO.
+ *  @details Samples are encoded into LSM6DSOX FIFO words as the sensor would
+ *           write them at 208 Hz, with a timestamp word every eighth sample,
+ *           on a sensor clock which runs 1.5% fast. Every 20 ms the words
+ *           written so far are drained through @c ImuFifoDecoder as
+ *           @c task_IMU drains them, and the times given to the samples are
+ *           compared with the times they were really taken. The same FIFO
+ *           is then drained again with the task stalled for a second, so the
+ *           FIFO overruns and keeps only its newest words, which must be
+ *           timed as well as the rest. The time to decode and fuse one
+ *           sample is then printed, followed by the I2C bytes and transfers
+ *           per second of the old one-sample-per-run reads and of FIFO
+ *           batches, at 400 kHz.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "bench.h"
+#include "imufifo.h"
+#include "mahony.h"
+
+static constexpr double SAMPLE_RATE = 208.0;    ///< Sensor output data rate (Hz)
+static constexpr double CLOCK_ERROR = 0.015;    ///< How fast the sensor's clock runs
+static constexpr uint32_t DRAIN_US = 20000;     ///< Time between drains of the FIFO (us)
+static constexpr uint32_t RUN_US = 10000000;    ///< Length of the run (us)
+static constexpr double I2C_HZ = 400000.0;      ///< I2C clock (Hz)
+static constexpr size_t STALL_FROM = 200;       ///< First drain missed by the stalled task
+static constexpr size_t STALL_TO = 250;         ///< First drain after the stall
+static constexpr size_t KEPT_WORDS = 400;       ///< Newest words the FIFO holds after the stall
+static constexpr double SETTLED_LIMIT_US = 200.0;   ///< Largest error allowed after one second (us)
+static constexpr float GYRO_LSB = 0.0175f * M_PI / 180;     ///< rad/s per count
+static constexpr float ACCEL_LSB = 0.122e-3f * 9.80665f;    ///< m/s^2 per count
+
+
+/** @brief   Append one FIFO word.
+ *  @param   fifo The FIFO contents
+ *  @param   tag The TAG_SENSOR value
+ *  @param   data The six data bytes
+ */
+static void push_word (std::vector<uint8_t>& fifo, uint8_t tag,
+                       const uint8_t data[6])
+{
+    fifo.push_back (tag << 3);
+    fifo.insert (fifo.end (), data, data + 6);
+}
+
+
+/** @brief   Append a three-axis word of signed counts.
+ *  @param   fifo The FIFO contents
+ *  @param   tag The TAG_SENSOR value
+ *  @param   x The x axis count
+ *  @param   y The y axis count
+ *  @param   z The z axis count
+ */
+static void push_axes (std::vector<uint8_t>& fifo, uint8_t tag, int16_t x,
+                       int16_t y, int16_t z)
+{
+    uint8_t data[6] = { (uint8_t)x, (uint8_t)(x >> 8), (uint8_t)y,
+                        (uint8_t)(y >> 8), (uint8_t)z, (uint8_t)(z >> 8) };
+    push_word (fifo, tag, data);
+}
+
+
+/// The FIFO as the sensor wrote it, and when the task drained it
+struct FifoTrace
+{
+    std::vector<uint8_t> fifo;              ///< Every word written, in order
+    std::vector<uint32_t> word_sample;      ///< Sample which each word belongs to
+    std::vector<uint32_t> true_us;          ///< Time each sample was really taken (us)
+    std::vector<size_t> drain_at;           ///< FIFO size at each drain (bytes)
+    std::vector<uint32_t> drain_ticks;      ///< Sensor clock at each drain
+};
+
+
+/// How well the decoder timed the samples of one run
+struct FifoTiming
+{
+    size_t decoded = 0;         ///< Samples given a time
+    double worst_us = 0.0;      ///< Largest time error (us)
+    double settled_us = 0.0;    ///< Largest time error after one second (us)
+    double sum_us = 0.0;        ///< Total time error (us)
+};
+
+
+/** @brief   Drain the FIFO through a decoder as @c task_IMU does.
+ *  @details Drains from @p stall_from up to @p stall_to are missed. If more
+ *           than @c KEPT_WORDS words are waiting at the next one, only the
+ *           newest of them are kept and the decoder is told of the overrun,
+ *           as @c LSM6DSOX::get_angle() does when the sensor's flag is set.
+ *  @param   trace The FIFO and its drains
+ *  @param   stall_from The first drain missed
+ *  @param   stall_to The first drain after the stall
+ *  @returns The errors of the samples' times
+ */
+static FifoTiming drain (const FifoTrace& trace, size_t stall_from,
+                         size_t stall_to)
+{
+    ImuFifoDecoder decoder (GYRO_LSB, ACCEL_LSB, (float)SAMPLE_RATE);
+    FifoTiming timing;
+    size_t read = 0;
+    for (size_t d = 0; d < trace.drain_at.size (); d++)
+    {
+        if (d >= stall_from && d < stall_to)
+        {
+            continue;
+        }
+        decoder.begin_batch (DRAIN_US * (d + 1), trace.drain_ticks[d]);
+        if (trace.drain_at[d] - read > KEPT_WORDS * IMU_FIFO_WORD_SIZE)
+        {
+            read = trace.drain_at[d] - KEPT_WORDS * IMU_FIFO_WORD_SIZE;
+            decoder.overrun ();
+        }
+        for (; read < trace.drain_at[d]; read += IMU_FIFO_WORD_SIZE)
+        {
+            if (decoder.decode (&trace.fifo[read]))
+            {
+                // A sample completes on its second word
+                uint32_t truth = trace.true_us[trace.word_sample[read / IMU_FIFO_WORD_SIZE]];
+                double err = fabs ((double)(int32_t)(decoder.sample ().time_us - truth));
+                timing.worst_us = fmax (timing.worst_us, err);
+                if (truth > 1000000)
+                {
+                    timing.settled_us = fmax (timing.settled_us, err);
+                }
+                timing.sum_us += err;
+                timing.decoded++;
+            }
+        }
+    }
+    return timing;
+}
+
+
+/** @brief   Print how well one run was timed, marking it FAIL if any sample
+ *           after the first second is more than @c SETTLED_LIMIT_US off.
+ *  @param   label The name of the run
+ *  @param   timing Its errors
+ *  @param   samples The number of samples the sensor wrote
+ *  @returns One if the run failed, otherwise zero
+ */
+static int print_timing (const char* label, const FifoTiming& timing,
+                         size_t samples)
+{
+    bool ok = timing.settled_us <= SETTLED_LIMIT_US;
+    printf ("%-14s timed %zu of %zu, time error avg %.1f us, max %.1f us, "
+            "max after 1 s %.1f us  %s\n", label, timing.decoded, samples,
+            timing.sum_us / timing.decoded, timing.worst_us, timing.settled_us,
+            ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+
+/** @brief   Print the I2C load of one way of reading the IMU.
+ *  @param   label The name of the method
+ *  @param   samples_per_s Gyro and accelerometer samples delivered per second
+ *  @param   runs_per_s Times per second the IMU task reads
+ *  @param   bytes_per_run Bytes on the bus per read, address bytes included
+ *  @param   transfers_per_run I2C transfers (start to stop) per read
+ */
+static void bus_load (const char* label, double samples_per_s,
+                      double runs_per_s, double bytes_per_run,
+                      double transfers_per_run)
+{
+    double bytes = runs_per_s * bytes_per_run;
+    printf ("%-28s %7.0f  %8.0f  %9.0f  %10.1f  %8.1f\n", label, samples_per_s,
+            runs_per_s * transfers_per_run, bytes,
+            100.0 * bytes * 9 / I2C_HZ, bytes_per_run / (samples_per_s / runs_per_s));
+}
+
+
+int bench_fifo (void)
+{
+    // Write the FIFO as the sensor would, remembering the true sample times
+    FifoTrace trace;
+    std::vector<uint8_t>& fifo = trace.fifo;
+    const double ticks_per_us = (1.0 + CLOCK_ERROR) / IMU_TIMESTAMP_US;
+    uint32_t next_drain = DRAIN_US;
+    for (uint32_t n = 0; ; n++)
+    {
+        double t_us = 1000.0 + n * 1e6 / SAMPLE_RATE / (1.0 + CLOCK_ERROR);
+        while (next_drain < t_us && next_drain <= RUN_US)
+        {
+            trace.drain_at.push_back (fifo.size ());
+            trace.drain_ticks.push_back ((uint32_t)(next_drain * ticks_per_us));
+            next_drain += DRAIN_US;
+        }
+        if (t_us > RUN_US)
+        {
+            break;
+        }
+        if (n % IMU_TIMESTAMP_DECIMATION == 0)
+        {
+            uint32_t ticks = (uint32_t)(t_us * ticks_per_us + 0.5);
+            uint8_t data[6] = { (uint8_t)ticks, (uint8_t)(ticks >> 8),
+                                (uint8_t)(ticks >> 16), (uint8_t)(ticks >> 24),
+                                0, 0 };
+            push_word (fifo, 0x04, data);
+        }
+        double angle = sin (t_us * 1e-6);
+        int16_t rate = (int16_t)(cos (t_us * 1e-6) / GYRO_LSB);
+        int16_t up = (int16_t)(9.80665 * cos (angle) / ACCEL_LSB);
+        int16_t side = (int16_t)(9.80665 * sin (angle) / ACCEL_LSB);
+        // The sensor may write either word of a sample first
+        if (n % 2)
+        {
+            push_axes (fifo, 0x01, rate, 0, 0);
+            push_axes (fifo, 0x02, 0, side, up);
+        }
+        else
+        {
+            push_axes (fifo, 0x02, 0, side, up);
+            push_axes (fifo, 0x01, rate, 0, 0);
+        }
+        trace.word_sample.resize (fifo.size () / IMU_FIFO_WORD_SIZE, n);
+        trace.true_us.push_back ((uint32_t)(t_us + 0.5));
+    }
+
+    // Drain it every 20 ms as task_IMU does, then again with a stall which
+    // overruns the FIFO
+    FifoTiming steady = drain (trace, trace.drain_at.size (), 0);
+    FifoTiming stalled = drain (trace, STALL_FROM, STALL_TO);
+    printf ("IMU FIFO at %.0f Hz, sensor clock %.1f%% fast, drained every "
+            "%u ms\n", SAMPLE_RATE, 100 * CLOCK_ERROR,
+            (unsigned)(DRAIN_US / 1000));
+    int failures = print_timing ("steady", steady, trace.true_us.size ());
+    printf ("task stalled %.1f s at %.1f s, FIFO keeps its newest %zu words:\n",
+            (STALL_TO - STALL_FROM) * DRAIN_US * 1e-6,
+            STALL_FROM * DRAIN_US * 1e-6, KEPT_WORDS);
+    failures += print_timing ("overrun", stalled, trace.true_us.size ());
+
+    // Time decoding and fusing the whole FIFO many times
+    const int passes = 50;
+    ImuFifoDecoder decoder (GYRO_LSB, ACCEL_LSB, (float)SAMPLE_RATE);
+    MahonyFilter filter;
+    volatile float sink = 0.0f;
+    int64_t start = bench_now_ns ();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        decoder.begin_batch (RUN_US, (uint32_t)(RUN_US * ticks_per_us));
+        for (size_t at = 0; at < fifo.size (); at += IMU_FIFO_WORD_SIZE)
+        {
+            if (decoder.decode (&fifo[at]))
+            {
+                const ImuSample& s = decoder.sample ();
+                filter.update_imu (s.gx, s.gy, s.gz, s.ax, s.ay, s.az,
+                                   1.0f / SAMPLE_RATE);
+            }
+        }
+        sink = sink + filter.get_roll ();
+    }
+    int64_t elapsed = bench_now_ns () - start;
+    printf ("decode and fuse: %.1f ns per sample\n\n",
+            (double)elapsed / (passes * trace.true_us.size ()));
+
+    // Bus load: a register read is a 2 byte write of the address and register
+    // then a read of the address byte and the data
+    double per_run = SAMPLE_RATE * DRAIN_US * 1e-6;
+    double words = per_run * (2.0 + 1.0 / IMU_TIMESTAMP_DECIMATION);
+    printf ("I2C load at 400 kHz            samples  xfers/s    bytes/s  "
+            "bus busy %%  B/sample\n");
+    bus_load ("getEvent + mag every 10 ms", 100, 100,
+              (2 + 15) + (2 + 7), 4);
+    bus_load ("FIFO, stamp every sample", SAMPLE_RATE, 1e6 / DRAIN_US,
+              (2 + 11) + (2 + 1 + per_run * 3 * IMU_FIFO_WORD_SIZE) + (2 + 7), 6);
+    bus_load ("FIFO, stamp every 8th", SAMPLE_RATE, 1e6 / DRAIN_US,
+              (2 + 11) + (2 + 1 + words * IMU_FIFO_WORD_SIZE) + (2 + 7), 6);
+    printf ("\n");
+    return failures;
+}
@@ -0,0 +1,254 @@
+/** @file    bench_flare.cpp
+ *  @brief   When the flare starts on a simulated landing, from the 20 cm
+ *           near-ground decision or from the @c VerticalFilter time to
+ *           contact.
+ *  @details Descents from 6 m are simulated at two sink rates, each with a
+ *           slow swell in the sink rate as from gusts. The IMU gives the
+ *           upward acceleration in batches of four samples at 208 Hz, with
+ *           noise and a constant bias; the ultrasonic sensor pings at the
+ *           times a @c RangeScheduler picks, with the same noise, spurious
+ *           echoes and missed echoes as in @c bench_range, and each ping
+ *           reaches the IMU task at the first batch after its echo ends. For
+ *           each method the true time to contact when the flare starts is
+ *           compared with the wanted 0.5 s, and the errors of the filter's
+ *           height and climb rate below 2 m are printed.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <random>
+#include "bench.h"
+#include "rangefilter.h"
+#include "verticalfilter.h"
+
+static const float BATCH_S = 4.0f / 208.0f;     ///< Time between IMU batches (s)
+static const int BATCH_SAMPLES = 4;             ///< IMU samples in each batch
+static const float ACCEL_NOISE = 0.3f;          ///< Standard deviation of each acceleration sample (m/s^2)
+static const float ACCEL_BIAS = 0.15f;          ///< Bias of the upward acceleration (m/s^2)
+static const float PING_NOISE_CM = 2.0f;        ///< Standard deviation of each distance (cm)
+static const double SPURIOUS = 0.03;            ///< Fraction of pings which are spurious short echoes
+static const double MISSED = 0.03;              ///< Fraction of pings which get no echo
+static const float MAX_RANGE_CM = 400.0f;       ///< Farthest ground which gives an echo (cm)
+static const float START_CM = 600.0f;           ///< Height at which each descent starts (cm)
+static const float GROUND_CM = 5.0f;            ///< Height the sensor reads on the ground (cm)
+static const float FLARE_S = 0.5f;              ///< Wanted time to contact at the flare (s)
+static const float SOUND_CM_PER_US = 0.0343f / 2;   ///< Half the speed of sound (cm/us)
+static const int DESCENTS = 500;                ///< Descents at each sink rate
+
+
+/// How one method started the flare over many descents
+struct FlareCount
+{
+    uint32_t flares = 0;            ///< Descents on which the flare started
+    uint32_t early = 0;             ///< Flares with more than twice the wanted time to go
+    double sum = 0;                 ///< Total true time to contact at the flare (s)
+    double sum_sq = 0;              ///< Total of its square (s^2)
+    double latest = 1e9;            ///< Shortest true time to contact at a flare (s)
+};
+
+
+/// Errors of the filter's estimate below 2 m
+struct EstimateError
+{
+    double height_sq = 0;           ///< Total squared height error (cm^2)
+    double climb_sq = 0;            ///< Total squared climb rate error (cm^2/s^2)
+    uint32_t count = 0;             ///< Batches counted
+};
+
+
+/** @brief   Add the true time to contact at a flare to the totals.
+ *  @param   counts The totals for one method
+ *  @param   time_to_contact The true time to contact (s)
+ */
+static void count_flare (FlareCount& counts, float time_to_contact)
+{
+    counts.flares++;
+    counts.sum += time_to_contact;
+    counts.sum_sq += time_to_contact * time_to_contact;
+    counts.latest = fmin (counts.latest, time_to_contact);
+    if (time_to_contact > 2 * FLARE_S)
+    {
+        counts.early++;
+    }
+}
+
+
+/** @brief   Make the ping the sensor would give at a true height.
+ *  @param   rng The random number generator
+ *  @param   height The true height (cm)
+ *  @param   t The time the ping is sent (s)
+ *  @returns The ping
+ */
+static Range make_ping (std::mt19937& rng, float height, float t)
+{
+    std::uniform_real_distribution<double> chance (0.0, 1.0);
+    std::normal_distribution<float> noise (0.0f, PING_NOISE_CM);
+    std::uniform_real_distribution<float> short_echo (3.0f, 15.0f);
+
+    Range ping = {};
+    ping.time_us = (uint32_t)(t * 1e6f);
+    double roll = chance (rng);
+    if (roll < MISSED || height > MAX_RANGE_CM)
+    {
+        ping.valid = false;
+    }
+    else if (roll < MISSED + SPURIOUS)
+    {
+        ping.valid = true;
+        ping.distance = short_echo (rng);
+    }
+    else
+    {
+        ping.valid = true;
+        ping.distance = fmaxf (2.0f, height + noise (rng));
+    }
+    return ping;
+}
+
+
+/** @brief   Simulate one descent and start the flare with each method.
+ *  @param   seed Seed for the noise
+ *  @param   sink Mean sink rate (cm/s)
+ *  @param   step Totals for the near-ground decision
+ *  @param   predicted Totals for the time to contact
+ *  @param   error Totals for the filter's errors
+ */
+static void descend (uint32_t seed, float sink, FlareCount& step,
+                     FlareCount& predicted, EstimateError& error)
+{
+    std::mt19937 rng (seed);
+    std::normal_distribution<float> accel_noise (0.0f, ACCEL_NOISE);
+    std::uniform_real_distribution<float> phase (0.0f, 6.2832f);
+
+    // The sink rate swells by a fifth every two seconds
+    const float swell = 0.2f * sink;
+    const float omega = 3.1416f;
+    const float start = phase (rng);
+    auto height = [&] (float t)
+    {
+        return START_CM - sink * t + swell / omega * (cosf (omega * t + start) - cosf (start));
+    };
+    auto climb = [&] (float t) { return -sink - swell * sinf (omega * t + start); };
+    auto accel = [&] (float t) { return -swell * omega * cosf (omega * t + start); };
+
+    RangeFilter filter (20.0f, 30.0f);
+    RangeScheduler scheduler;
+    VerticalFilter vertical;
+
+    const float sample_s = BATCH_S / BATCH_SAMPLES;
+    float accel_sum = 0.0f;
+    Range sent = make_ping (rng, height (0.0f), 0.0f);
+    float deliver_s = sent.valid ? sent.distance / SOUND_CM_PER_US * 1e-6f : 0.1f;
+    Range delivered = {};
+    bool fresh = false;             // A ping has been delivered and not yet fused
+    float step_s = -1.0f;           // Time each method started the flare (s)
+    float predicted_s = -1.0f;
+    float contact_s = 0.0f;
+
+    for (int n = 1; ; n++)
+    {
+        float t = n * sample_s;
+        float h = height (t);
+        if (h <= GROUND_CM)
+        {
+            // Touchdown between this sample and the previous one
+            float h_prev = height (t - sample_s);
+            contact_s = t - sample_s * (GROUND_CM - h) / (h_prev - h);
+            break;
+        }
+        accel_sum += 0.01f * accel (t) + ACCEL_BIAS + accel_noise (rng);
+
+        // The ultrasonic task gets each ping when its echo ends or, with no
+        // echo, when the next trigger times it out, then sends the next one
+        // at the period the scheduler picks
+        if (t >= deliver_s)
+        {
+            delivered = sent;
+            delivered.sequence++;
+            fresh = true;
+            if (filter.update (delivered) && step_s < 0)
+            {
+                step_s = t;
+            }
+            float period_s = scheduler.update (filter, delivered) * 1e-3f;
+            float send_s = t + period_s;
+            sent = make_ping (rng, height (send_s), send_s);
+            sent.sequence = delivered.sequence;
+            deliver_s = sent.valid ? send_s + sent.distance / SOUND_CM_PER_US * 1e-6f
+                        : send_s + period_s;
+        }
+
+        // The IMU task runs the filter once per batch
+        if (n % BATCH_SAMPLES == 0)
+        {
+            vertical.predict (accel_sum / BATCH_SAMPLES, BATCH_S);
+            accel_sum = 0.0f;
+            if (fresh)
+            {
+                vertical.correct (delivered, (uint32_t)(t * 1e6f));
+                fresh = false;
+            }
+            VerticalState state;
+            vertical.get_state (state);
+            if (state.valid && state.time_to_contact < FLARE_S && predicted_s < 0)
+            {
+                predicted_s = t;
+            }
+            if (state.valid && h < 200.0f)
+            {
+                error.height_sq += (state.height - h) * (state.height - h);
+                error.climb_sq += (state.climb_rate - climb (t)) * (state.climb_rate - climb (t));
+                error.count++;
+            }
+        }
+    }
+
+    if (step_s >= 0)
+    {
+        count_flare (step, contact_s - step_s);
+    }
+    if (predicted_s >= 0)
+    {
+        count_flare (predicted, contact_s - predicted_s);
+    }
+}
+
+
+void bench_flare (void)
+{
+    printf ("Flare start on %d descents from %.0f cm, wanted %.1f s before "
+            "touchdown; accel noise %.1f m/s^2, bias %.2f m/s^2\n",
+            DESCENTS, START_CM, FLARE_S, ACCEL_NOISE, ACCEL_BIAS);
+    printf ("sink     method            flares  early  time to contact avg  "
+            "sd  min (s)   height rms cm  climb rms cm/s\n");
+    const float sinks[] = { 100.0f, 200.0f };
+    for (float sink : sinks)
+    {
+        FlareCount step, predicted;
+        EstimateError error;
+        for (int run = 0; run < DESCENTS; run++)
+        {
+            descend (2000 + run, sink, step, predicted, error);
+        }
+        const FlareCount* counts[2] = { &step, &predicted };
+        const char* names[2] = { "20 cm step", "time to contact" };
+        for (int m = 0; m < 2; m++)
+        {
+            const FlareCount& c = *counts[m];
+            double mean = c.flares ? c.sum / c.flares : 0.0;
+            double sd = c.flares ? sqrt (fmax (0.0, c.sum_sq / c.flares - mean * mean)) : 0.0;
+            printf ("%.0f m/s  %-16s  %6u  %5u  %19.2f  %4.2f  %7.2f", sink / 100,
+                    names[m], c.flares, c.early, mean, sd, c.flares ? c.latest : 0.0);
+            if (m == 1)
+            {
+                printf ("   %13.1f  %14.1f", sqrt (error.height_sq / error.count),
+                        sqrt (error.climb_sq / error.count));
+            }
+            printf ("\n");
+        }
+    }
+    printf ("\n");
+}
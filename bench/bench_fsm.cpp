@@ -0,0 +1,101 @@
+/** @file    bench_fsm.cpp
+ *  @brief   Time from posting an event to a @c StateMachine until its state
+ *           has changed.
+ *  @details A two state machine is run by its own task, as the flight mode
+ *           machine is. The benchmark posts events which toggle it and spins
+ *           until the new state is visible, then does the same with the
+ *           machine's timer. The spinning task yields so that the machine's
+ *           task can run on a single core host. The old controller only looked at its state
+ *           every 50 ms, so a change waited 25 ms on average.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <thread>
+#include "bench.h"
+#include "statemachine.h"
+
+/// Number of events posted
+static const uint32_t TOGGLES = 6;
+
+enum { BENCH_OFF, BENCH_ON };               ///< States of the benchmark machine
+enum { BENCH_TOGGLE, BENCH_TIMEOUT };       ///< Events of the benchmark machine
+
+extern StateMachine bench_machine;
+
+/// Entry action of ON: turn off again after 20 ms
+static void bench_enter_on (void)
+{
+    bench_machine.start_timer (20);
+}
+
+static const FsmState bench_states[] =
+{
+    { "OFF", NULL, NULL },
+    { "ON", bench_enter_on, NULL },
+};
+
+static const FsmTransition bench_transitions[] =
+{
+    { BENCH_OFF, BENCH_TOGGLE, BENCH_ON, NULL },
+    { BENCH_ON, BENCH_TIMEOUT, BENCH_OFF, NULL },
+};
+
+static const char* const bench_events[] = { "TOGGLE", "TIMEOUT" };
+
+/// The machine being timed
+StateMachine bench_machine ("Bench FSM", bench_states, 2, bench_transitions, 2,
+                            bench_events, BENCH_TIMEOUT);
+
+
+/** @brief   Task which runs the benchmark machine forever.
+ *  @param   p_params Unused
+ */
+static void bench_task_fsm (void* p_params)
+{
+    (void)p_params;
+
+    bench_machine.begin (BENCH_OFF);
+    while (true)
+    {
+        bench_machine.run ();
+    }
+}
+
+
+void bench_fsm (void)
+{
+    printf ("State machine, event to state change\n");
+    fflush (stdout);
+    xTaskCreate (bench_task_fsm, "Bench FSM", 2048, NULL, 50, NULL);
+    vTaskDelay (10);
+
+    double sum_us = 0;
+    double worst_us = 0;
+    double timer_sum_ms = 0;
+    for (uint32_t count = 0; count < TOGGLES; count++)
+    {
+        int64_t start = bench_now_ns ();
+        bench_machine.post (BENCH_TOGGLE);
+        while (bench_machine.get_state () != BENCH_ON)
+        {
+            std::this_thread::yield ();
+        }
+        double latency_us = (bench_now_ns () - start) / 1000.0;
+        sum_us += latency_us;
+        worst_us = (latency_us > worst_us) ? latency_us : worst_us;
+
+        // The timer turns the machine off again
+        while (bench_machine.get_state () != BENCH_OFF)
+        {
+            vTaskDelay (1);
+        }
+        timer_sum_ms += (bench_now_ns () - start) / 1e6;
+    }
+
+    printf ("event to transition us  avg %.1f  max %.1f (50 ms poll: avg 25000)\n",
+            sum_us / TOGGLES, worst_us);
+    printf ("20 ms timer measured    avg %.1f ms\n\n", timer_sum_ms / TOGGLES);
+}
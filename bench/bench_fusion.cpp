@@ -0,0 +1,316 @@
+/** @file    bench_fusion.cpp
+ *  @brief   Accuracy and cost of the IMU attitude estimators on a synthetic
+ *           motion trace.
+ *  @details A known attitude history of a banking, pitching and turning
+ *           glider is turned into the readings an LSM6DSOX and LIS3MDL would
+ *           give: gyro rates with a constant bias and noise, specific force
+ *           with noise and with linear accelerations added, and magnetic
+ *           field with noise. The readings are sampled at about 100 Hz with
+ *           the interval jittering by up to 10%, as they are by @c task_IMU.
+ *           Several estimators are run on the same trace and the RMS and
+ *           largest errors of their angles are printed, followed by the time
+ *           taken by one update of the Mahony filter and of the Kalman filter.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "mahony.h"
+#include "ekf.h"
+
+static constexpr double TRACE_TIME = 60.0;      ///< Length of the trace (s)
+static constexpr double SAMPLE_DT = 0.01;       ///< Nominal sampling interval (s)
+static constexpr double GRAVITY = 9.81;         ///< Gravity (m/s^2)
+static constexpr double FIELD_NORTH = 20.0;     ///< Horizontal part of the Earth's field (uT)
+static constexpr double FIELD_UP = -40.0;       ///< Vertical part of the Earth's field (uT)
+static constexpr double SETTLE_TIME = 5.0;      ///< Time before errors are counted (s)
+static constexpr double DEG = 180.0 / M_PI;     ///< Degrees per radian
+
+/// One sample of the trace: the true attitude and what the sensors read
+struct FusionSample
+{
+    double t;                   ///< Time of the sample (s)
+    double roll, pitch, yaw;    ///< True attitude (rad)
+    float dt;                   ///< Time since the previous sample (s)
+    float gx, gy, gz;           ///< Gyro reading (rad/s)
+    float ax, ay, az;           ///< Accelerometer reading (m/s^2)
+    float mx, my, mz;           ///< Magnetometer reading (uT)
+};
+
+/// Running RMS and largest errors of one estimator's angles
+struct FusionError
+{
+    double sum_sq[3] = { 0, 0, 0 };     ///< Sums of squared errors (deg^2)
+    double worst[3] = { 0, 0, 0 };      ///< Largest errors (deg)
+    uint32_t count = 0;                 ///< Number of samples compared
+};
+
+
+/** @brief   Find the true attitude of the glider at a given time.
+ *  @param   t The time (s)
+ *  @param   roll The roll angle (rad)
+ *  @param   pitch The pitch angle (rad)
+ *  @param   yaw The yaw angle (rad)
+ */
+static void truth (double t, double& roll, double& pitch, double& yaw)
+{
+    roll = 0.5 * sin (2 * M_PI * 0.2 * t);
+    pitch = 0.25 * sin (2 * M_PI * 0.13 * t + 0.5);
+    yaw = 0.3 * t + 0.4 * sin (2 * M_PI * 0.05 * t);
+}
+
+
+/** @brief   Turn yaw, pitch and roll into a quaternion, sensor to Earth frame.
+ *  @param   roll The roll angle (rad)
+ *  @param   pitch The pitch angle (rad)
+ *  @param   yaw The yaw angle (rad)
+ *  @param   q The quaternion, scalar first
+ */
+static void to_quaternion (double roll, double pitch, double yaw, double q[4])
+{
+    double cr = cos (roll / 2), sr = sin (roll / 2);
+    double cp = cos (pitch / 2), sp = sin (pitch / 2);
+    double cy = cos (yaw / 2), sy = sin (yaw / 2);
+    q[0] = cr * cp * cy + sr * sp * sy;
+    q[1] = sr * cp * cy - cr * sp * sy;
+    q[2] = cr * sp * cy + sr * cp * sy;
+    q[3] = cr * cp * sy - sr * sp * cy;
+}
+
+
+/** @brief   Rotate a vector from the Earth frame into the sensor frame.
+ *  @param   q The attitude quaternion, sensor to Earth frame
+ *  @param   v The vector in the Earth frame
+ *  @param   out The vector in the sensor frame
+ */
+static void to_sensor (const double q[4], const double v[3], double out[3])
+{
+    double w = q[0], x = q[1], y = q[2], z = q[3];
+    double r[3][3] =
+    {
+        { 1 - 2 * (y * y + z * z), 2 * (x * y - w * z), 2 * (x * z + w * y) },
+        { 2 * (x * y + w * z), 1 - 2 * (x * x + z * z), 2 * (y * z - w * x) },
+        { 2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y) }
+    };
+    for (int i = 0; i < 3; i++)
+    {
+        out[i] = r[0][i] * v[0] + r[1][i] * v[1] + r[2][i] * v[2];
+    }
+}
+
+
+/** @brief   Make the synthetic trace.
+ *  @returns The samples, in order
+ */
+static std::vector<FusionSample> make_trace (void)
+{
+    std::mt19937 rng (507);
+    std::uniform_real_distribution<double> jitter (0.9, 1.1);
+    std::normal_distribution<double> gyro_noise (0.0, 0.005);
+    std::normal_distribution<double> accel_noise (0.0, 0.05);
+    std::normal_distribution<double> mag_noise (0.0, 0.5);
+    const double bias[3] = { 0.02, -0.015, 0.01 };
+    const double field[3] = { FIELD_NORTH, 0.0, FIELD_UP };
+
+    std::vector<FusionSample> trace;
+    double t = 0.0;
+    double dt = 0.0;
+    while (t < TRACE_TIME)
+    {
+        FusionSample s;
+        s.t = t;
+        s.dt = (float)dt;
+        truth (t, s.roll, s.pitch, s.yaw);
+
+        // Body rates from the derivative of the quaternion, w = 2 q* dq/dt
+        const double h = 1e-5;
+        double q[4], qa[4], qb[4], dq[4];
+        double r, p, y;
+        to_quaternion (s.roll, s.pitch, s.yaw, q);
+        truth (t - h, r, p, y);
+        to_quaternion (r, p, y, qa);
+        truth (t + h, r, p, y);
+        to_quaternion (r, p, y, qb);
+        for (int i = 0; i < 4; i++)
+        {
+            dq[i] = (qb[i] - qa[i]) / (2 * h);
+        }
+        double wx = 2 * (q[0] * dq[1] - q[1] * dq[0] - q[2] * dq[3] + q[3] * dq[2]);
+        double wy = 2 * (q[0] * dq[2] + q[1] * dq[3] - q[2] * dq[0] - q[3] * dq[1]);
+        double wz = 2 * (q[0] * dq[3] - q[1] * dq[2] + q[2] * dq[1] - q[3] * dq[0]);
+        s.gx = (float)(wx + bias[0] + gyro_noise (rng));
+        s.gy = (float)(wy + bias[1] + gyro_noise (rng));
+        s.gz = (float)(wz + bias[2] + gyro_noise (rng));
+
+        // Specific force: gravity's reaction plus gusts and turning
+        double force[3] =
+        {
+            2.0 * sin (1.1 * t),
+            2.0 * cos (0.7 * t),
+            GRAVITY + 1.0 * sin (0.5 * t)
+        };
+        double a[3], m[3];
+        to_sensor (q, force, a);
+        to_sensor (q, field, m);
+        s.ax = (float)(a[0] + accel_noise (rng));
+        s.ay = (float)(a[1] + accel_noise (rng));
+        s.az = (float)(a[2] + accel_noise (rng));
+        s.mx = (float)(m[0] + mag_noise (rng));
+        s.my = (float)(m[1] + mag_noise (rng));
+        s.mz = (float)(m[2] + mag_noise (rng));
+
+        trace.push_back (s);
+        dt = SAMPLE_DT * jitter (rng);
+        t += dt;
+    }
+    return trace;
+}
+
+
+/** @brief   Add one estimate to an estimator's error totals.
+ *  @details Samples in the first few seconds, while the filters converge from
+ *           their first reading, are not counted.
+ *  @param   error The totals to add to
+ *  @param   s The sample holding the true attitude
+ *  @param   roll The estimated roll (rad)
+ *  @param   pitch The estimated pitch (rad)
+ *  @param   yaw The estimated yaw (rad)
+ */
+static void score (FusionError& error, const FusionSample& s, double roll,
+                   double pitch, double yaw)
+{
+    if (s.t < SETTLE_TIME)
+    {
+        return;
+    }
+    double diff[3] = { roll - s.roll, pitch - s.pitch, yaw - s.yaw };
+    for (int i = 0; i < 3; i++)
+    {
+        double d = fabs (remainder (diff[i], 2 * M_PI)) * DEG;
+        error.sum_sq[i] += d * d;
+        error.worst[i] = (d > error.worst[i]) ? d : error.worst[i];
+    }
+    error.count++;
+}
+
+
+/** @brief   Print one estimator's errors.
+ *  @param   label The estimator's name
+ *  @param   error Its error totals
+ */
+static void report (const char* label, const FusionError& error)
+{
+    printf ("%-24s", label);
+    for (int i = 0; i < 3; i++)
+    {
+        printf ("  %6.2f %6.2f", sqrt (error.sum_sq[i] / error.count),
+                error.worst[i]);
+    }
+    printf ("\n");
+}
+
+
+/** @brief   Run a filter over the trace and total its errors.
+ *  @tparam  Filter @c MahonyFilter or @c AttitudeEKF
+ *  @param   trace The samples
+ *  @param   filter The filter to run
+ *  @param   use_mag Whether the magnetometer is fused
+ *  @returns The error totals
+ */
+template <class Filter>
+static FusionError run_filter (const std::vector<FusionSample>& trace,
+                               Filter filter, bool use_mag)
+{
+    FusionError error;
+    const FusionSample& first = trace[0];
+    filter.init (first.ax, first.ay, first.az, first.mx, first.my, first.mz);
+    for (size_t k = 1; k < trace.size (); k++)
+    {
+        const FusionSample& s = trace[k];
+        if (use_mag)
+        {
+            filter.update (s.gx, s.gy, s.gz, s.ax, s.ay, s.az,
+                           s.mx, s.my, s.mz, s.dt);
+        }
+        else
+        {
+            filter.update_imu (s.gx, s.gy, s.gz, s.ax, s.ay, s.az, s.dt);
+        }
+        score (error, s, filter.get_roll (), filter.get_pitch (),
+               filter.get_yaw ());
+    }
+    return error;
+}
+
+
+/** @brief   Time a filter's full update over the whole trace many times.
+ *  @tparam  Filter @c MahonyFilter or @c AttitudeEKF
+ *  @param   trace The samples
+ *  @param   filter The filter to time
+ *  @returns The time per update (ns)
+ */
+template <class Filter>
+static double time_update (const std::vector<FusionSample>& trace,
+                           Filter filter)
+{
+    const int passes = 50;
+    volatile float sink = 0.0f;
+    int64_t start = bench_now_ns ();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        for (size_t k = 1; k < trace.size (); k++)
+        {
+            const FusionSample& s = trace[k];
+            filter.update (s.gx, s.gy, s.gz, s.ax, s.ay, s.az,
+                           s.mx, s.my, s.mz, s.dt);
+        }
+        sink = sink + filter.get_yaw ();
+    }
+    int64_t elapsed = bench_now_ns () - start;
+    return (double)elapsed / (passes * (trace.size () - 1));
+}
+
+
+void bench_fusion (void)
+{
+    std::vector<FusionSample> trace = make_trace ();
+
+    printf ("Attitude estimators on a %.0f s synthetic trace at %.0f Hz, "
+            "errors in deg after %.0f s\n", TRACE_TIME, 1.0 / SAMPLE_DT,
+            SETTLE_TIME);
+    printf ("estimator                  roll rms   max  pitch rms   max    "
+            "yaw rms   max\n");
+
+    // The old estimator: tilt from the accelerometer alone, yaw from the
+    // tilt compensated magnetometer
+    FusionError old_error;
+    for (size_t k = 1; k < trace.size (); k++)
+    {
+        const FusionSample& s = trace[k];
+        double roll = atan2 (s.ay, sqrt (s.ax * s.ax + s.az * s.az));
+        double pitch = atan2 (-s.ax, sqrt (s.ay * s.ay + s.az * s.az));
+        double level_x = s.mx * cos (pitch)
+                         + (s.my * sin (roll) + s.mz * cos (roll)) * sin (pitch);
+        double level_y = s.my * cos (roll) - s.mz * sin (roll);
+        score (old_error, s, roll, pitch, atan2 (-level_y, level_x));
+    }
+    report ("accelerometer only", old_error);
+
+    report ("gyro only", run_filter (trace, MahonyFilter (0.0f, 0.0f), true));
+    report ("Mahony, gyro + accel", run_filter (trace, MahonyFilter (), false));
+    report ("Mahony, gyro+accel+mag", run_filter (trace, MahonyFilter (), true));
+
+    report ("EKF, gyro + accel", run_filter (trace, AttitudeEKF (), false));
+    report ("EKF, gyro+accel+mag", run_filter (trace, AttitudeEKF (), true));
+
+    // Time the updates the IMU task may run
+    printf ("Mahony update with magnetometer: %.1f ns per update\n",
+            time_update (trace, MahonyFilter ()));
+    printf ("EKF update with magnetometer: %.1f ns per update\n\n",
+            time_update (trace, AttitudeEKF ()));
+}
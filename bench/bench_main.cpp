@@ -0,0 +1,42 @@
+/** @file    bench_main.cpp
+ *  @brief   Entry point which runs all the host-side benchmarks.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include "bench.h"
+
+
+/** @brief   Run each benchmark in turn.
+ *  @returns Zero, or one if any accuracy check failed
+ */
+int main (void)
+{
+    int failures = 0;
+
+    bench_share ();
+    failures += bench_queue ();
+    bench_pid ();
+    bench_bank ();
+    bench_tasks ();
+    bench_sched ();
+    bench_servo ();
+    bench_fsm ();
+    bench_fusion ();
+    failures += bench_fifo ();
+    bench_wake ();
+    failures += bench_fastmath ();
+    bench_range ();
+    bench_flare ();
+    bench_adc ();
+    bench_potcal ();
+
+    if (failures != 0)
+    {
+        printf ("%d accuracy check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
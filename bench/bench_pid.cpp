@@ -0,0 +1,200 @@
+/** @file    bench_pid.cpp
+ *  @brief   Benchmark of @c PIDController::getCtrlOutput() against the
+ *           fixed-point @c PID<Q> template.
+ *  @details The controllers are run over a decaying, noisy error trace like
+ *           the one the elevator loop sees after a step in commanded pitch.
+ *           The trace is made ahead of time, in float and in each fixed-point
+ *           format, so that only the controllers are timed. Each fixed-point
+ *           controller's outputs are then compared with the float
+ *           controller's over the whole trace. A second test samples a known
+ *           error signal at jittered times and compares the integral and
+ *           derivative terms, computed with the nominal and with the measured
+ *           interval, against their exact values.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "bench.h"
+#include "PIDController.h"
+#include "fixedpid.h"
+
+/// Number of samples in the error trace
+static const uint32_t TRACE_LENGTH = 4096;
+
+/// Number of times the trace is run through the controller
+static const uint32_t PASSES = 250;
+
+static constexpr float KP = 3.0f;           ///< Proportional gain of every controller
+static constexpr float KI = 0.5f;           ///< Integral gain of every controller
+static constexpr float KD = 0.1f;           ///< Derivative gain of every controller
+static constexpr float DT = 0.05f;          ///< Interval between samples (s)
+static constexpr float GOAL = 10.0f;        ///< Setpoint of the trace
+
+
+/// Q16.16 controller with the same gains fixed at compile time
+typedef PID<16, ConstGains<to_fixed<16> (KP), to_fixed<16> (KI * DT),
+                           to_fixed<16> (KD / DT)> > ConstPID16;
+
+
+/** @brief   Time a fixed-point controller and compare it with float results.
+ *  @param   label The name printed for this controller
+ *  @param   pid The controller, freshly constructed
+ *  @param   measured The error trace in floating point
+ *  @param   reference The float controller's output for each sample
+ */
+template <uint8_t FRAC_BITS, class PIDType>
+static void run_fixed (const char* label, PIDType& pid,
+                       const std::vector<float>& measured,
+                       const std::vector<float>& reference)
+{
+    std::vector<int32_t> fixed_measured (TRACE_LENGTH);
+    for (uint32_t index = 0; index < TRACE_LENGTH; index++)
+    {
+        fixed_measured[index] = to_fixed<FRAC_BITS> (measured[index]);
+    }
+    const int32_t goal = to_fixed<FRAC_BITS> (GOAL);
+
+    // Accuracy over the first pass, while the controller starts from rest
+    double max_error = 0.0;
+    double sum_squares = 0.0;
+    for (uint32_t index = 0; index < TRACE_LENGTH; index++)
+    {
+        float output = from_fixed<FRAC_BITS> (
+            pid.update (fixed_measured[index], goal));
+        double error = fabs ((double)output - reference[index]);
+        max_error = (error > max_error) ? error : max_error;
+        sum_squares += error * error;
+    }
+
+    int64_t sink = 0;
+    int64_t start = bench_now_ns ();
+    for (uint32_t pass = 0; pass < PASSES; pass++)
+    {
+        for (uint32_t index = 0; index < TRACE_LENGTH; index++)
+        {
+            sink += pid.update (fixed_measured[index], goal);
+        }
+    }
+    int64_t elapsed = bench_now_ns () - start;
+
+    printf ("%-14s %7.2f  %10.2e  %10.2e  (checksum %lld)\n", label,
+            (double)elapsed / ((double)TRACE_LENGTH * PASSES), max_error,
+            sqrt (sum_squares / TRACE_LENGTH), (long long)sink);
+}
+
+
+/** @brief   Compare fixed-interval and timestamped PID terms under jitter.
+ *  @details The error is @c sin(t), sampled every 50 ms plus or minus up to
+ *           @c spread_us. An integral-only and a derivative-only controller
+ *           are run with and without timestamps, and their RMS errors against
+ *           @c 1-cos(t) and @c cos(t) are printed.
+ *  @param   spread_us The largest timing error (us)
+ */
+static void compare_jitter (uint32_t spread_us)
+{
+    const uint32_t period_us = (uint32_t)(DT * 1e6f);
+    PIDController i_fixed (0, 1, 0, DT), i_timed (0, 1, 0, DT);
+    PIDController d_fixed (0, 0, 1, DT), d_timed (0, 0, 1, DT);
+    double i_fixed_sq = 0, i_timed_sq = 0, d_fixed_sq = 0, d_timed_sq = 0;
+
+    int64_t time_us = 0;
+    uint32_t random = 12345;
+    for (uint32_t index = 0; index < TRACE_LENGTH; index++)
+    {
+        // Small linear congruential generator, so every run is the same
+        random = random * 1664525u + 1013904223u;
+        int32_t offset = (int32_t)(random >> 8) % (int32_t)(2 * spread_us + 1)
+                         - (int32_t)spread_us;
+        time_us += (index == 0) ? 0 : (int64_t)period_us + offset;
+
+        double t = time_us * 1e-6;
+        float error = (float)sin (t);
+
+        // The controllers see a setpoint of error and a measurement of zero
+        double i_ideal = 1.0 - cos (t);
+        double i_a = i_fixed.getCtrlOutput (0, error) - i_ideal;
+        double i_b = i_timed.getCtrlOutput (0, error, time_us) - i_ideal;
+        i_fixed_sq += i_a * i_a;
+        i_timed_sq += i_b * i_b;
+
+        // The first derivative has no previous sample to work from
+        if (index > 0)
+        {
+            double d_ideal = cos (t);
+            double d_a = d_fixed.getCtrlOutput (0, error) - d_ideal;
+            double d_b = d_timed.getCtrlOutput (0, error, time_us) - d_ideal;
+            d_fixed_sq += d_a * d_a;
+            d_timed_sq += d_b * d_b;
+        }
+        else
+        {
+            d_fixed.getCtrlOutput (0, error);
+            d_timed.getCtrlOutput (0, error, time_us);
+        }
+    }
+
+    printf ("+/-%5u us   %10.2e  %10.2e  %10.2e  %10.2e\n", (unsigned)spread_us,
+            sqrt (i_fixed_sq / TRACE_LENGTH), sqrt (i_timed_sq / TRACE_LENGTH),
+            sqrt (d_fixed_sq / TRACE_LENGTH), sqrt (d_timed_sq / TRACE_LENGTH));
+}
+
+
+void bench_pid (void)
+{
+    std::vector<float> measured (TRACE_LENGTH);
+    for (uint32_t index = 0; index < TRACE_LENGTH; index++)
+    {
+        float t = index * DT;
+        measured[index] = GOAL * (1.0f - expf (-t)) + 0.5f * sinf (7.0f * t);
+    }
+
+    // Reference outputs from the float controller, which never saturates here
+    std::vector<float> reference (TRACE_LENGTH);
+    PIDController reference_pid (KP, KI, KD, DT);
+    for (uint32_t index = 0; index < TRACE_LENGTH; index++)
+    {
+        reference[index] = reference_pid.getCtrlOutput (measured[index], GOAL);
+    }
+
+    PIDController pid (KP, KI, KD, DT);
+    float sink = 0.0f;
+
+    int64_t start = bench_now_ns ();
+    for (uint32_t pass = 0; pass < PASSES; pass++)
+    {
+        for (uint32_t index = 0; index < TRACE_LENGTH; index++)
+        {
+            sink += pid.getCtrlOutput (measured[index], GOAL);
+        }
+    }
+    int64_t elapsed = bench_now_ns () - start;
+
+    printf ("PID controllers (ns/call, error against float over %u samples)\n",
+            (unsigned)TRACE_LENGTH);
+    printf ("controller     ns/call   max error   RMS error\n");
+    printf ("%-14s %7.2f  %10s  %10s  (checksum %g)\n", "float",
+            (double)elapsed / ((double)TRACE_LENGTH * PASSES), "-", "-",
+            (double)sink);
+
+    PID<16> pid16 (KP, KI, KD, DT, -100, 100);
+    run_fixed<16> ("PID<16>", pid16, measured, reference);
+
+    PID<24> pid24 (KP, KI, KD, DT, -100, 100);
+    run_fixed<24> ("PID<24>", pid24, measured, reference);
+
+    ConstPID16 const_pid16 (-100, 100);
+    run_fixed<16> ("PID<16> const", const_pid16, measured, reference);
+    printf ("\n");
+
+    printf ("PID terms under sampling jitter (RMS error against exact values)\n");
+    printf ("jitter       integral dt  integral ts  deriv. dt   deriv. ts\n");
+    compare_jitter (0);
+    compare_jitter (1000);
+    compare_jitter (10000);
+    compare_jitter (20000);
+    printf ("\n");
+}
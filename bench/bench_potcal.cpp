@@ -0,0 +1,182 @@
+/** @file    bench_potcal.cpp
+ *  @brief   Accuracy and cost of converting potentiometer readings to
+ *           degrees with the fixed scale and with @c PotCalibration tables.
+ *  @details The ADC is modelled with the shape of the ESP32's response at
+ *           11 dB: nothing below about 0.14 V, a straight run through the
+ *           middle and a bend which flattens the top of the range. This chip
+ *           reads 3% low. The potentiometer turns 60 degrees per volt, as
+ *           @c Potentiometer assumes, and is zeroed at 1.65 V. Three ways of
+ *           getting degrees are compared over the travel: the fixed scale
+ *           of 3.3 V over 4096 counts; a table built from the chip's
+ *           calibration, as @c esp_adc_cal gives it from the eFuses, taken
+ *           to know the chip's gain to 1%; and a table fitted to seven
+ *           angles measured across the travel. A table built with the gain
+ *           exactly right shows the error of the interpolation alone. Last
+ *           comes the time each conversion takes on the host.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <random>
+#include "bench.h"
+#include "potcal.h"
+
+static const double DEG_PER_VOLT = 60.0;        ///< VOLTAGE_TO_DEGREES in Potentiometer
+static const double ZERO_VOLTS = 1.65;          ///< Where the pot is zeroed (V)
+static const double CHIP_GAIN = 0.97;           ///< This chip's reading of a volt (V/V)
+static const double EFUSE_GAIN = 0.98;          ///< The gain its eFuses give (V/V)
+static const int SWEEP_POINTS = 7;              ///< Angles measured for the sweep
+static const float TRAVEL_LOW = 0.3f;           ///< Lowest voltage of the pot's travel (V)
+static const float TRAVEL_HIGH = 3.0f;          ///< Highest voltage of the pot's travel (V)
+
+
+/** @brief   Voltage which an ADC of some gain reads as a number of counts.
+ *  @param   counts The reading, which may have a fraction (counts)
+ *  @param   gain The ADC's gain, one for a nominal chip
+ *  @returns The voltage at the pin (V)
+ */
+static double volts_at (double counts, double gain)
+{
+    double bend = (counts > 3000.0) ? counts - 3000.0 : 0.0;
+    return (0.142 + 0.00068 * counts + 1.44e-7 * bend * bend) / gain;
+}
+
+
+/** @brief   Reading which an ADC of some gain gives for a voltage.
+ *  @param   volts The voltage at the pin (V)
+ *  @param   gain The ADC's gain
+ *  @returns The reading, with a fraction as if oversampled (counts)
+ */
+static double counts_at (double volts, double gain)
+{
+    double low = 0.0;
+    double high = POTCAL_RANGE - 1;
+    for (int step = 0; step < 40; step++)
+    {
+        double middle = 0.5 * (low + high);
+        if (volts_at (middle, gain) < volts)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return 0.5 * (low + high);
+}
+
+
+/// Errors of one way of converting over the travel
+struct ConversionError
+{
+    double worst = 0;           ///< Largest error (deg)
+    double sum_sq = 0;          ///< Total squared error (deg^2)
+    int count = 0;              ///< Readings checked
+};
+
+
+/** @brief   Check one conversion over the travel, zeroed as the servo does.
+ *  @param   convert Turns a reading into degrees, before zeroing
+ *  @returns The errors
+ */
+template <class Convert>
+static ConversionError check (Convert convert)
+{
+    ConversionError result;
+    double zero = convert ((float)counts_at (ZERO_VOLTS, CHIP_GAIN));
+    for (float volts = TRAVEL_LOW; volts <= TRAVEL_HIGH; volts += 0.001f)
+    {
+        double truth = (volts - ZERO_VOLTS) * DEG_PER_VOLT;
+        double error = convert ((float)counts_at (volts, CHIP_GAIN)) - zero - truth;
+        result.worst = fmax (result.worst, fabs (error));
+        result.sum_sq += error * error;
+        result.count++;
+    }
+    return result;
+}
+
+
+/** @brief   Print one line of the table of errors.
+ *  @param   name The way of converting
+ *  @param   error Its errors
+ */
+static void print_error (const char* name, const ConversionError& error)
+{
+    printf ("%-28s  %9.3f  %9.3f\n", name, sqrt (error.sum_sq / error.count),
+            error.worst);
+}
+
+
+void bench_potcal (void)
+{
+    printf ("Potentiometer degrees over %.1f - %.1f V, chip gain %.2f\n",
+            TRAVEL_LOW, TRAVEL_HIGH, CHIP_GAIN);
+    printf ("conversion                    rms deg    worst deg\n");
+
+    const float scale = 3.3f / 4096 * (float)DEG_PER_VOLT;
+    print_error ("fixed 3.3 V / 4096 scale",
+                 check ([scale] (float counts) { return counts * scale; }));
+
+    // Table from the chip's calibration, as built by calibrate_efuse()
+    float points[POTCAL_POINTS];
+    PotCalibration efuse;
+    for (int point = 0; point < POTCAL_POINTS; point++)
+    {
+        points[point] = (float)(volts_at (point << POTCAL_SHIFT, EFUSE_GAIN) * DEG_PER_VOLT);
+    }
+    efuse.set_points (points, POTCAL_EFUSE);
+    print_error ("eFuse table, gain 1% off",
+                 check ([&efuse] (float counts) { return efuse.degrees (counts); }));
+
+    // The same with the gain exactly right, so only interpolation is left
+    PotCalibration exact;
+    for (int point = 0; point < POTCAL_POINTS; point++)
+    {
+        points[point] = (float)(volts_at (point << POTCAL_SHIFT, CHIP_GAIN) * DEG_PER_VOLT);
+    }
+    exact.set_points (points, POTCAL_EFUSE);
+    print_error ("exact table (interpolation)",
+                 check ([&exact] (float counts) { return exact.degrees (counts); }));
+
+    // Table fitted to angles measured across the travel, each reading
+    // oversampled to a tenth of a count
+    std::mt19937 rng (1);
+    std::normal_distribution<float> noise (0.0f, 0.1f);
+    float sweep_counts[SWEEP_POINTS];
+    float sweep_degrees[SWEEP_POINTS];
+    for (int index = 0; index < SWEEP_POINTS; index++)
+    {
+        double volts = TRAVEL_LOW + (TRAVEL_HIGH - TRAVEL_LOW) * index / (SWEEP_POINTS - 1);
+        sweep_counts[index] = (float)counts_at (volts, CHIP_GAIN) + noise (rng);
+        sweep_degrees[index] = (float)(volts * DEG_PER_VOLT);
+    }
+    PotCalibration sweep;
+    if (sweep.fit (sweep_counts, sweep_degrees, SWEEP_POINTS))
+    {
+        print_error ("sweep table, 7 points",
+                     check ([&sweep] (float counts) { return sweep.degrees (counts); }));
+    }
+
+    // Cost per conversion on this machine
+    const uint32_t conversions = 20000000;
+    volatile float sink = 0;
+    int64_t start = bench_now_ns ();
+    for (uint32_t index = 0; index < conversions; index++)
+    {
+        sink = sink + (float)(index & 4095) * scale;
+    }
+    int64_t fixed_ns = bench_now_ns () - start;
+    start = bench_now_ns ();
+    for (uint32_t index = 0; index < conversions; index++)
+    {
+        sink = sink + efuse.degrees ((float)(index & 4095));
+    }
+    int64_t table_ns = bench_now_ns () - start;
+    printf ("Host time per conversion: fixed %.2f ns, table %.2f ns; "
+            "table %u bytes of RAM\n\n", (double)fixed_ns / conversions,
+            (double)table_ns / conversions, (unsigned)sizeof (PotCalibration));
+}
@@ -0,0 +1,220 @@
+/** @file    bench_queue.cpp
+ *  @brief   Checks and timing of the lock-free @c Queue<T> ring buffer.
+ *  @details A queue of 16 items is filled, overfilled, drained and refilled
+ *           with @c put_n() and @c get_n() so that its indices cross the end
+ *           of the buffer, and the items, the overflow count and the
+ *           high-water mark are checked at each step. An empty queue with a
+ *           wait time must give up after that time. Then a producer thread
+ *           races the consumer through a 64 item queue, pausing now and then
+ *           so that the consumer goes to sleep in @c wait_for_data() and must
+ *           be woken; every item must arrive once and in order, and no wait
+ *           may time out. Each check is marked FAIL if it fails, and the
+ *           failures are counted so that the run can fail. Last comes the
+ *           time per item of moving items one at a time and in batches.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <thread>
+#include "bench.h"
+#include "taskqueue.h"
+
+static const uint32_t RACE_ITEMS = 2000000;     ///< Items sent in the race
+static const uint32_t RACE_PAUSE = 4096;        ///< Items between the producer's pauses
+static const TickType_t RACE_WAIT = 1000;       ///< Consumer's wait before it gives up (ms)
+static const TickType_t TIMEOUT_WAIT = 20;      ///< Wait of the timeout check (ms)
+static const uint32_t TIMING_ITEMS = 10000000;  ///< Items moved for each timing
+static const uint32_t BATCH = 16;               ///< Items per put_n() and get_n()
+
+
+/** @brief   Print one check and whether it passed.
+ *  @param   label What was checked
+ *  @param   passed True if the check passed
+ *  @returns One if the check failed, zero if not
+ */
+static int check (const char* label, bool passed)
+{
+    printf ("%-52s %s\n", label, passed ? "ok" : "FAIL");
+    return passed ? 0 : 1;
+}
+
+
+/** @brief   Check that items come out of a queue as a run of numbers.
+ *  @param   queue The queue, which must hold at least @p count items
+ *  @param   first The number the first item should be
+ *  @param   count How many items to take out
+ *  @returns True if each item was the one after the last
+ */
+static bool drains_in_order (Queue<uint32_t>& queue, uint32_t first,
+                             uint32_t count)
+{
+    uint32_t items[BATCH];
+    while (count > 0)
+    {
+        uint32_t got = queue.get_n (items, (count < BATCH) ? count : BATCH);
+        if (got == 0)
+        {
+            return false;
+        }
+        for (uint32_t index = 0; index < got; index++)
+        {
+            if (items[index] != first++)
+            {
+                return false;
+            }
+        }
+        count -= got;
+    }
+    return true;
+}
+
+
+/** @brief   Race a producer thread against this thread as the consumer.
+ *  @param   queue The queue, which must start empty
+ *  @param   out_of_order Set to the number of items not the one expected
+ *  @returns The number of items received before a wait timed out, which is
+ *           @c RACE_ITEMS if none did
+ */
+static uint32_t race (Queue<uint32_t>& queue, uint32_t& out_of_order)
+{
+    std::thread producer ([&queue]
+    {
+        uint32_t items[BATCH];
+        uint32_t sent = 0;
+        while (sent < RACE_ITEMS)
+        {
+            // Put a batch, retrying whatever did not fit
+            uint32_t count = (RACE_ITEMS - sent < BATCH) ? RACE_ITEMS - sent : BATCH;
+            for (uint32_t index = 0; index < count; index++)
+            {
+                items[index] = sent + index;
+            }
+            uint32_t done = 0;
+            while (done < count)
+            {
+                done += queue.put_n (items + done, count - done);
+            }
+
+            // Let the consumer run dry and go to sleep now and then
+            if ((sent / RACE_PAUSE) != ((sent + count) / RACE_PAUSE))
+            {
+                std::this_thread::sleep_for (std::chrono::microseconds (100));
+            }
+            sent += count;
+        }
+    });
+
+    uint32_t items[BATCH];
+    uint32_t received = 0;
+    out_of_order = 0;
+    while (received < RACE_ITEMS)
+    {
+        uint32_t got = queue.get_n (items, BATCH);
+        if (got == 0)
+        {
+            break;
+        }
+        for (uint32_t index = 0; index < got; index++)
+        {
+            out_of_order += (items[index] != received++);
+        }
+    }
+    producer.join ();
+    return received;
+}
+
+
+int bench_queue (void)
+{
+    int failures = 0;
+    printf ("Queue<T> checks\n");
+
+    // A size of 10 is rounded up to 16. The queues are static because a
+    // share stays in the registry's list for the rest of the run
+    static Queue<uint32_t> queue (10, "Check", 0);
+    uint32_t items[20];
+    for (uint32_t index = 0; index < 20; index++)
+    {
+        items[index] = index;
+    }
+    failures += check ("size rounded up to a power of two", queue.size () == 16);
+
+    // Overfill it; the four which don't fit are dropped and counted
+    uint32_t put = queue.put_n (items, 20);
+    failures += check ("put_n() of 20 into 16 puts 16",
+                       put == 16 && queue.available () == 16);
+    failures += check ("4 overflows counted, high-water mark 16",
+                       queue.overflow_count () == 4 && queue.high_water_mark () == 16);
+    failures += check ("put() into a full queue fails and is counted",
+                       !queue.put (99) && queue.overflow_count () == 5);
+    failures += check ("get_n() takes 16 in order", drains_in_order (queue, 0, 16));
+    failures += check ("get_n() of an empty queue with no wait gives 0",
+                       queue.get_n (items, 20) == 0 && queue.is_empty ());
+
+    // Half fill it, then put 12 more so that they cross the end of the buffer
+    queue.put_n (items, 10);
+    bool in_order = drains_in_order (queue, 0, 10);
+    put = queue.put_n (items, 12);
+    failures += check ("12 items across the end of the buffer",
+                       in_order && put == 12 && drains_in_order (queue, 0, 12));
+    failures += check ("no new overflows, high-water mark still 16",
+                       queue.overflow_count () == 5 && queue.high_water_mark () == 16);
+
+    // Single items come out as they went in
+    for (uint32_t index = 0; index < 40; index++)
+    {
+        queue.put (index);
+    }
+    failures += check ("put() and get() of single items wrap in order",
+                       drains_in_order (queue, 0, 16) && queue.is_empty ());
+
+    // An empty queue with a wait gives up after it, to within a tick
+    static Queue<uint32_t> waiting (16, "Timeout", TIMEOUT_WAIT);
+    uint32_t item = 12345;
+    int64_t start = bench_now_ns ();
+    bool got = waiting.get (item);
+    double waited_ms = (bench_now_ns () - start) * 1e-6;
+    char label[64];
+    snprintf (label, sizeof (label), "get() of an empty queue times out in %.1f ms",
+              waited_ms);
+    failures += check (label, !got && item == 12345 && waited_ms >= TIMEOUT_WAIT - 1
+                              && waited_ms < 10 * TIMEOUT_WAIT);
+
+    // Producer thread racing a consumer which sleeps when the queue is empty
+    static uint32_t storage[64];
+    static Queue<uint32_t> racing (storage, 64, "Race", RACE_WAIT);
+    uint32_t out_of_order = 0;
+    start = bench_now_ns ();
+    uint32_t received = race (racing, out_of_order);
+    double race_ms = (bench_now_ns () - start) * 1e-6;
+    snprintf (label, sizeof (label), "%u of %u raced items, %u out of order",
+              (unsigned)received, (unsigned)RACE_ITEMS, (unsigned)out_of_order);
+    failures += check (label, received == RACE_ITEMS && out_of_order == 0);
+    printf ("race took %.0f ms, high-water mark %u of %u\n", race_ms,
+            (unsigned)racing.high_water_mark (), (unsigned)racing.size ());
+
+    // Time per item moved by one thread, one at a time and in batches
+    static Queue<uint32_t> timed (64, "Timing", 0);
+    volatile uint32_t sink = 0;
+    start = bench_now_ns ();
+    for (uint32_t index = 0; index < TIMING_ITEMS; index++)
+    {
+        timed.put (index);
+        sink = sink + timed.get ();
+    }
+    int64_t single_ns = bench_now_ns () - start;
+    start = bench_now_ns ();
+    for (uint32_t index = 0; index < TIMING_ITEMS; index += BATCH)
+    {
+        timed.put_n (items, BATCH);
+        sink = sink + timed.get_n (items, BATCH);
+    }
+    int64_t batch_ns = bench_now_ns () - start;
+    printf ("put + get per item: single %.2f ns, batches of %u %.2f ns\n\n",
+            (double)single_ns / TIMING_ITEMS, (unsigned)BATCH,
+            (double)batch_ns / TIMING_ITEMS);
+
+    return failures;
+}
@@ -0,0 +1,309 @@
+/** @file    bench_range.cpp
+ *  @brief   How often the near-ground decision flips falsely, made from raw
+ *           ultrasonic pings or from a @c RangeFilter.
+ *  @details Noisy ping traces at 10 Hz are replayed through each method. Every
+ *           ping has Gaussian noise, and some are spurious short echoes (as
+ *           from grass or another sensor) or get no echo at all. Three flights
+ *           are replayed: a long cruise at 1.5 m, where the decision should
+ *           never be true; a skim right at the 20 cm threshold, where
+ *           it may change but should not chatter; and many landings at 1 m/s,
+ *           where it should become true once, soon after the glider passes
+ *           20 cm, and stay true. Then the distance error from a fixed speed
+ *           of sound is printed for a range of air temperatures. Last,
+ *           descents from out of range to the ground are replayed with
+ *           pings at a fixed 10 Hz and at the times a @c RangeScheduler
+ *           picks, counting the pings spent in each phase, the delay in
+ *           noticing the near-ground height and the times the ping timer
+ *           has to be restarted with a new period.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <random>
+#include <functional>
+#include "bench.h"
+#include "rangefilter.h"
+
+static const float PING_S = 0.1f;               ///< Time between pings (s)
+static const float NOISE_CM = 2.0f;             ///< Standard deviation of each distance (cm)
+static const double SPURIOUS = 0.03;            ///< Fraction of pings which are spurious short echoes
+static const double MISSED = 0.03;              ///< Fraction of pings which get no echo
+static const float NEAR_CM = 20.0f;             ///< Near-ground threshold (cm)
+static const int LANDINGS = 500;                ///< Landings replayed
+static const float MAX_RANGE_CM = 400.0f;       ///< Farthest ground which gives an echo (cm)
+static const float START_CM = 600.0f;           ///< Height at which each descent starts (cm)
+
+
+/// How one method did on one flight
+struct FlipCount
+{
+    uint32_t flips = 0;             ///< Times the decision changed
+    uint32_t near_pings = 0;        ///< Pings after which the decision was near
+    float first_near_s = -1.0f;     ///< Time the decision first became near (s)
+};
+
+
+/** @brief   Make the ping the sensor would give at a true height.
+ *  @param   rng The random number generator
+ *  @param   height The true height (cm)
+ *  @param   t The time (s)
+ *  @returns The ping
+ */
+static Range make_ping (std::mt19937& rng, float height, float t)
+{
+    std::uniform_real_distribution<double> chance (0.0, 1.0);
+    std::normal_distribution<float> noise (0.0f, NOISE_CM);
+    std::uniform_real_distribution<float> short_echo (3.0f, 15.0f);
+
+    Range ping = {};
+    ping.time_us = (uint32_t)(t * 1e6f);
+    double roll = chance (rng);
+    if (roll < MISSED)
+    {
+        ping.valid = false;
+    }
+    else if (roll < MISSED + SPURIOUS)
+    {
+        ping.valid = true;
+        ping.distance = short_echo (rng);
+    }
+    else
+    {
+        ping.valid = true;
+        ping.distance = fmaxf (2.0f, height + noise (rng));
+    }
+    return ping;
+}
+
+
+/** @brief   Replay one flight through the raw threshold and the filter.
+ *  @param   seed Seed for the noise
+ *  @param   duration Length of the flight (s)
+ *  @param   height The true height at each time (cm)
+ *  @param   raw Totals for the raw threshold
+ *  @param   filtered Totals for the @c RangeFilter
+ */
+static void replay (uint32_t seed, float duration,
+                    const std::function<float (float)>& height,
+                    FlipCount& raw, FlipCount& filtered)
+{
+    std::mt19937 rng (seed);
+    RangeFilter filter (NEAR_CM, NEAR_CM + 10.0f);
+    bool raw_near = false;
+    bool filtered_near = false;
+    for (float t = 0.0f; t < duration; t += PING_S)
+    {
+        Range ping = make_ping (rng, height (t), t);
+
+        // What task_ultrasonic did before: threshold each ping
+        bool now_raw = ping.valid && ping.distance < NEAR_CM;
+        bool now_filtered = filter.update (ping);
+
+        raw.flips += (now_raw != raw_near);
+        filtered.flips += (now_filtered != filtered_near);
+        raw.near_pings += now_raw;
+        filtered.near_pings += now_filtered;
+        if (now_raw && raw.first_near_s < 0)
+        {
+            raw.first_near_s = t;
+        }
+        if (now_filtered && filtered.first_near_s < 0)
+        {
+            filtered.first_near_s = t;
+        }
+        raw_near = now_raw;
+        filtered_near = now_filtered;
+    }
+}
+
+
+/// Totals for many descents with one way of timing the pings
+struct ScheduleCount
+{
+    uint32_t pings[RANGE_PHASES] = {};  ///< Pings in each phase
+    double phase_s[RANGE_PHASES] = {};  ///< Time in each phase (s)
+    uint32_t early = 0;                 ///< Descents on which near was decided too soon
+    uint32_t never = 0;                 ///< Descents on which near was never decided
+    double sum_delay = 0;               ///< Total delay in deciding near (s)
+    double worst_delay = 0;             ///< Longest delay in deciding near (s)
+    uint32_t restarts = 0;              ///< Times the ping timer was restarted with a new period
+};
+
+
+/** @brief   Replay one descent from out of range to the ground.
+ *  @param   seed Seed for the noise
+ *  @param   sink Rate of descent (cm/s)
+ *  @param   adaptive True to time the pings with a @c RangeScheduler, false
+ *           for a fixed 10 Hz
+ *  @param   totals Totals to which this descent is added
+ */
+static void descend (uint32_t seed, float sink, bool adaptive,
+                     ScheduleCount& totals)
+{
+    std::mt19937 rng (seed);
+    RangeFilter filter (NEAR_CM, NEAR_CM + 10.0f);
+    RangeScheduler scheduler;
+    auto height = [sink] (float t) { return fmaxf (5.0f, START_CM - sink * t); };
+    const float cross_s = (START_CM - NEAR_CM) / sink;
+    const float duration = cross_s + 1.0f;
+
+    // Start at a random point in the fixed period so the phases line up
+    // differently on each descent
+    std::uniform_real_distribution<float> offset (0.0f, PING_S);
+    float first_near_s = -1.0f;
+    uint32_t period_ms = (uint32_t)(PING_S * 1000);
+    for (float t = offset (rng); t < duration; t += period_ms * 1e-3f)
+    {
+        Range ping = make_ping (rng, height (t), t);
+        if (height (t) > MAX_RANGE_CM)
+        {
+            ping.valid = false;
+        }
+        if (filter.update (ping) && first_near_s < 0)
+        {
+            first_near_s = t;
+        }
+        uint32_t next_ms = scheduler.update (filter, ping);
+        if (adaptive && next_ms != period_ms)
+        {
+            period_ms = next_ms;
+            totals.restarts++;
+        }
+    }
+
+    for (int phase = 0; phase < RANGE_PHASES; phase++)
+    {
+        totals.pings[phase] += scheduler.get_pings ((RangePhase)phase);
+        totals.phase_s[phase] += scheduler.get_time_us ((RangePhase)phase) * 1e-6;
+    }
+    if (first_near_s < 0)
+    {
+        totals.never++;
+    }
+    else if (first_near_s < cross_s)
+    {
+        totals.early++;
+    }
+    else
+    {
+        double delay = first_near_s - cross_s;
+        totals.sum_delay += delay;
+        totals.worst_delay = fmax (totals.worst_delay, delay);
+    }
+}
+
+
+void bench_range (void)
+{
+    printf ("Near-ground decision from %.0f Hz pings, noise %.0f cm, "
+            "%.0f%% spurious, %.0f%% missed\n", 1.0f / PING_S, NOISE_CM,
+            100 * SPURIOUS, 100 * MISSED);
+    printf ("flight                   method     flips  near pings\n");
+
+    FlipCount raw, filtered;
+    replay (1, 3600.0f, [] (float) { return 150.0f; }, raw, filtered);
+    printf ("%-24s %-10s %5u  %10u\n", "1 h cruise at 150 cm", "raw",
+            raw.flips, raw.near_pings);
+    printf ("%-24s %-10s %5u  %10u\n", "", "filtered", filtered.flips,
+            filtered.near_pings);
+
+    raw = FlipCount ();
+    filtered = FlipCount ();
+    replay (2, 600.0f, [] (float) { return NEAR_CM; }, raw, filtered);
+    printf ("%-24s %-10s %5u  %10u\n", "10 min skim at 20 cm", "raw",
+            raw.flips, raw.near_pings);
+    printf ("%-24s %-10s %5u  %10u\n", "", "filtered", filtered.flips,
+            filtered.near_pings);
+
+    // Landings from 2 m at 1 m/s, then resting on the ground at 5 cm
+    const float cross_s = (200.0f - NEAR_CM) / 100.0f;
+    auto landing = [] (float t) { return fmaxf (5.0f, 200.0f - 100.0f * t); };
+    uint32_t extra_flips[2] = { 0, 0 };
+    uint32_t early[2] = { 0, 0 };
+    uint32_t never[2] = { 0, 0 };
+    double sum_delay[2] = { 0, 0 };
+    double worst_delay[2] = { 0, 0 };
+    for (int run = 0; run < LANDINGS; run++)
+    {
+        FlipCount counts[2];
+        replay (100 + run, 4.0f, landing, counts[0], counts[1]);
+        for (int m = 0; m < 2; m++)
+        {
+            // One flip, to near, is right; any more are false
+            extra_flips[m] += (counts[m].flips > 1) ? counts[m].flips - 1 : 0;
+            double delay = counts[m].first_near_s - cross_s;
+            if (counts[m].first_near_s < 0)
+            {
+                never[m]++;
+            }
+            else if (delay < 0)
+            {
+                early[m]++;
+            }
+            else
+            {
+                sum_delay[m] += delay;
+                worst_delay[m] = fmax (worst_delay[m], delay);
+            }
+        }
+    }
+    printf ("\n%d landings at 1 m/s      false flips  early  never  "
+            "delay avg ms  max ms\n", LANDINGS);
+    const char* names[2] = { "raw", "filtered" };
+    for (int m = 0; m < 2; m++)
+    {
+        uint32_t on_time = LANDINGS - early[m] - never[m];
+        printf ("%-24s %11u  %5u  %5u  %12.0f  %6.0f\n", names[m],
+                extra_flips[m], early[m], never[m],
+                on_time ? 1000 * sum_delay[m] / on_time : 0.0,
+                1000 * worst_delay[m]);
+    }
+
+    // A 1 m echo measured with the old fixed 0.034 cm/us
+    printf ("\nair temp C   1 m reads as, fixed speed   compensated\n");
+    const float temps[] = { -10.0f, 0.0f, 15.0f, 25.0f, 35.0f };
+    for (float temp : temps)
+    {
+        float echo_us = 100.0f / range_cm_per_us (temp);
+        printf ("%10.0f   %23.1f   %11.1f\n", temp, echo_us * 0.034f / 2,
+                echo_us * range_cm_per_us (temp));
+    }
+
+    // Descents from 6 m, out of range, to the ground
+    const float sinks[] = { 100.0f, 200.0f };
+    const char* schedules[2] = { "fixed 10 Hz", "adaptive" };
+    printf ("\n%d descents from %.0f cm   pings per descent: out  cruise  final"
+            "   rate Hz: out  cruise  final   early  never  delay avg ms  max ms"
+            "  restarts\n",
+            LANDINGS, START_CM);
+    for (float sink : sinks)
+    {
+        for (int m = 0; m < 2; m++)
+        {
+            ScheduleCount totals;
+            for (int run = 0; run < LANDINGS; run++)
+            {
+                descend (1000 + run, sink, m == 1, totals);
+            }
+            char name[32];
+            snprintf (name, sizeof (name), "%.0f m/s %s", sink / 100, schedules[m]);
+            uint32_t on_time = LANDINGS - totals.early - totals.never;
+            printf ("%-24s %22.1f  %6.1f  %5.1f   %12.1f  %6.1f  %5.1f   %5u  %5u  %12.0f  %6.0f  %9.1f\n",
+                    name,
+                    (double)totals.pings[RANGE_OUT] / LANDINGS,
+                    (double)totals.pings[RANGE_CRUISE] / LANDINGS,
+                    (double)totals.pings[RANGE_FINAL] / LANDINGS,
+                    totals.pings[RANGE_OUT] / totals.phase_s[RANGE_OUT],
+                    totals.pings[RANGE_CRUISE] / totals.phase_s[RANGE_CRUISE],
+                    totals.pings[RANGE_FINAL] / totals.phase_s[RANGE_FINAL],
+                    totals.early, totals.never,
+                    on_time ? 1000 * totals.sum_delay / on_time : 0.0,
+                    1000 * totals.worst_delay,
+                    (double)totals.restarts / LANDINGS);
+        }
+    }
+    printf ("\n");
+}
@@ -0,0 +1,137 @@
+/** @file    bench_sched.cpp
+ *  @brief   Scheduling report for a host copy of the program's task table.
+ *  @details Four periodic tasks with the periods and priorities of the tasks
+ *           in @c main.cpp are started from a @c PeriodicTask table. Each one
+ *           spins for a fixed time per cycle in place of its real work; the
+ *           ultrasonic task times out on every tenth echo and overruns its
+ *           period, as the blocking @c pulseIn() does when nothing is in
+ *           range. After two seconds the schedule report is printed. For
+ *           comparison, a task with the IMU's load is run with
+ *           @c vTaskDelay(period), and its cycle count shows how much the
+ *           period stretches by the time the task takes to run.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include "bench.h"
+#include "periodic.h"
+
+/// How long the tasks are left running (ms)
+static const uint32_t RUN_MS = 2000;
+
+/// Cleared to make the simulated tasks return
+static std::atomic<bool> running (true);
+
+/// Cycles completed by the task which uses @c vTaskDelay()
+static std::atomic<uint32_t> delay_cycles (0);
+
+TaskMemory<2048> sim_imu_memory;            ///< Memory for the simulated IMU task
+TaskMemory<2048> sim_controller_memory;     ///< Memory for the simulated controller
+TaskMemory<2048> sim_ultrasonic_memory;     ///< Memory for the simulated ultrasonic task
+TaskMemory<8192> sim_webserver_memory;      ///< Memory for the simulated web server
+
+
+/** @brief   Keep the CPU busy for a while, as a task's work would.
+ *  @param   us The time to spin (us)
+ */
+static void spin (uint32_t us)
+{
+    int64_t end = bench_now_ns () + (int64_t)us * 1000;
+    while (bench_now_ns () < end)
+    {
+    }
+}
+
+
+/// Simulated IMU task: 10 ms period, about 400 us of sensor reads and math
+static void sim_task_IMU (void* p_params)
+{
+    PeriodicTask& schedule = *(PeriodicTask*)p_params;
+    while (running)
+    {
+        spin (400);
+        schedule.wait ();
+    }
+}
+
+
+/// Simulated controller task: 50 ms period, about 300 us of control laws
+static void sim_task_controller (void* p_params)
+{
+    PeriodicTask& schedule = *(PeriodicTask*)p_params;
+    while (running)
+    {
+        spin (300);
+        schedule.wait ();
+    }
+}
+
+
+/// Simulated ultrasonic task: a 1 ms echo, but a 120 ms timeout every tenth
+static void sim_task_ultrasonic (void* p_params)
+{
+    PeriodicTask& schedule = *(PeriodicTask*)p_params;
+    uint32_t count = 0;
+    while (running)
+    {
+        spin ((++count % 10 == 0) ? 120000 : 1000);
+        schedule.wait ();
+    }
+}
+
+
+/// Simulated web server task: 500 ms period, about 2 ms per poll
+static void sim_task_webserver (void* p_params)
+{
+    PeriodicTask& schedule = *(PeriodicTask*)p_params;
+    while (running)
+    {
+        spin (2000);
+        schedule.wait ();
+    }
+}
+
+
+/// The IMU's load and period, timed with @c vTaskDelay() as it used to be
+static void sim_task_delay (void* p_params)
+{
+    (void)p_params;
+
+    while (running)
+    {
+        spin (400);
+        delay_cycles++;
+        vTaskDelay (10);
+    }
+}
+
+
+void bench_sched (void)
+{
+    const UBaseType_t TOP = configMAX_PRIORITIES - 1;
+    static PeriodicTask tasks[] =
+    {   //  Function              Name               Period  Priority  Core  Memory
+        { sim_task_webserver,   "Sim Web Server",      500,     10,     0,   sim_webserver_memory },
+        { sim_task_ultrasonic,  "Sim Ultrasonic",      100,  TOP - 5,   1,   sim_ultrasonic_memory },
+        { sim_task_controller,  "Sim Controller",       50,  TOP - 4,   1,   sim_controller_memory },
+        { sim_task_IMU,         "Sim IMU",              10,  TOP - 3,   1,   sim_imu_memory },
+    };
+    for (PeriodicTask& task : tasks)
+    {
+        task.start ();
+    }
+    xTaskCreate (sim_task_delay, "Sim delay", 2048, NULL, TOP - 3, NULL);
+
+    vTaskDelay (RUN_MS);
+
+    printf ("Schedule of the task table, %u ms on the host\n", (unsigned)RUN_MS);
+    PeriodicTask::print_all (Serial);
+    printf ("IMU load with vTaskDelay(10): %u cycles, %u expected\n\n",
+            (unsigned)delay_cycles, (unsigned)(RUN_MS / 10));
+
+    running = false;
+    vTaskDelay (200);
+}
@@ -0,0 +1,85 @@
+/** @file    bench_servo.cpp
+ *  @brief   Step response of a simulated control surface servo at the old
+ *           and new servo loop rates.
+ *  @details The surface is driven by a DC motor whose speed follows the duty
+ *           cycle with a first order lag, and its angle is read through a
+ *           12-bit ADC as the potentiometers are. The servo loop is the same
+ *           @c PID<16> used by @c task_servo(), sampled and held at 20 Hz (as
+ *           when it ran in the 50 ms controller task) and at 1 kHz. Each is
+ *           given a 20 degree step and the overshoot and the time to settle
+ *           within 2% of the step are printed.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "bench.h"
+#include "fixedpid.h"
+
+static constexpr float MOTOR_GAIN = 3.0f;   ///< Surface speed per percent duty ((deg/s)/%)
+static constexpr float MOTOR_TAU = 0.04f;   ///< Time constant of the motor's speed (s)
+static constexpr float ADC_STEP = 3.3f / 4096 * 60;  ///< Potentiometer resolution (deg)
+static constexpr float SIM_DT = 1e-5f;      ///< Time step of the simulation (s)
+static constexpr float STEP = 20.0f;        ///< Size of the commanded step (deg)
+static constexpr float SIM_TIME = 3.0f;     ///< Length of each run (s)
+
+
+/** @brief   Simulate one step response and print its overshoot and settling.
+ *  @param   label The name printed for this run
+ *  @param   period The servo loop's period (s)
+ *  @param   Kp Proportional gain of the servo loop (%/deg)
+ *  @param   Kd Derivative gain of the servo loop ((%/deg)s)
+ */
+static void step_response (const char* label, float period, float Kp, float Kd)
+{
+    PID<16> servo (Kp, 0, Kd, period, -100, 100);
+
+    float angle = 0.0f;             // Surface angle (deg)
+    float speed = 0.0f;             // Surface speed (deg/s)
+    float duty = 0.0f;              // Duty cycle held between updates (%)
+    float peak = 0.0f;              // Largest angle reached (deg)
+    float settled_at = 0.0f;        // Last time outside the 2% band (s)
+    uint32_t steps_per_update = (uint32_t)(period / SIM_DT + 0.5f);
+    uint32_t updates = 0;
+
+    uint32_t total_steps = (uint32_t)(SIM_TIME / SIM_DT);
+    for (uint32_t step = 0; step < total_steps; step++)
+    {
+        if (step % steps_per_update == 0)
+        {
+            float measured = floorf (angle / ADC_STEP) * ADC_STEP;
+            duty = from_fixed<16> (servo.update (to_fixed<16> (measured),
+                                                 to_fixed<16> (STEP)));
+            updates++;
+        }
+
+        speed += (MOTOR_GAIN * duty - speed) * (SIM_DT / MOTOR_TAU);
+        angle += speed * SIM_DT;
+
+        peak = (angle > peak) ? angle : peak;
+        if (fabsf (angle - STEP) > 0.02f * STEP)
+        {
+            settled_at = (step + 1) * SIM_DT;
+        }
+    }
+
+    printf ("%-20s %7.0f  %9.1f  %11.0f  %8.2f\n", label, 1.0f / period,
+            100.0f * (peak - STEP) / STEP,
+            (settled_at < SIM_TIME) ? settled_at * 1000.0f : INFINITY,
+            fabsf (angle - STEP));
+}
+
+
+void bench_servo (void)
+{
+    printf ("Servo step response, %.0f deg step (simulated motor and pot)\n",
+            (double)STEP);
+    printf ("loop                 rate Hz  overshoot%%  settle ms  final err\n");
+    step_response ("Kp 3 in controller", 0.05f, 3.0f, 0.0f);
+    step_response ("Kp 3 in servo task", 0.001f, 3.0f, 0.0f);
+    step_response ("Kp 10 in controller", 0.05f, 10.0f, 0.0f);
+    step_response ("Kp 10 in servo task", 0.001f, 10.0f, 0.0f);
+    printf ("\n");
+}
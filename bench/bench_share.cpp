@@ -0,0 +1,168 @@
+/** @file    bench_share.cpp
+ *  @brief   Benchmark of queue-backed @c Share<T> against lock-free
+ *           @c FastShare<T>.
+ *  @details One thread writes the share while the others read it, as the IMU
+ *           task writes @c pitchC while the controller reads it. With a single
+ *           thread, that thread alternately writes and reads. The result is
+ *           the mean wall-clock time per operation over all threads.
+ *           A second test measures what a put costs when 0 to 4 tasks
+ *           subscribe to the share, and how many wakeups each one gets.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "taskshare.h"
+#include "fastshare.h"
+#include "subscription.h"
+
+/// Number of puts or gets made by each thread
+static const uint32_t OPS_PER_THREAD = 1000000;
+
+
+/** @brief   Time one share type with a given number of contending threads.
+ *  @param   share The share to be exercised
+ *  @param   num_threads How many threads use the share at once
+ *  @returns The mean time per operation in nanoseconds
+ */
+template <class ShareType>
+static double time_share (ShareType& share, uint8_t num_threads)
+{
+    std::atomic<bool> go (false);
+    std::atomic<uint32_t> sink (0);
+    std::vector<std::thread> threads;
+
+    share.put (0.0f);
+
+    for (uint8_t index = 0; index < num_threads; index++)
+    {
+        threads.emplace_back ([&share, &go, &sink, index, num_threads]
+        {
+            float value = 0.0f;
+
+            while (!go.load ())
+            {
+                std::this_thread::yield ();
+            }
+
+            for (uint32_t count = 0; count < OPS_PER_THREAD; count++)
+            {
+                bool writing = (num_threads == 1) ? (count & 1) == 0
+                                                  : index == 0;
+                if (writing)
+                {
+                    share.put ((float)count);
+                }
+                else
+                {
+                    value += share.get ();
+                }
+            }
+
+            // Keep the reads from being optimized away
+            sink += (uint32_t)value;
+        });
+    }
+
+    int64_t start = bench_now_ns ();
+    go = true;
+    for (std::thread& thread : threads)
+    {
+        thread.join ();
+    }
+    int64_t elapsed = bench_now_ns () - start;
+
+    return (double)elapsed / ((double)OPS_PER_THREAD * num_threads);
+}
+
+
+/// Number of puts made in the subscription fan-out test
+static const uint32_t FANOUT_PUTS = 100000;
+
+
+/** @brief   Time puts into a share which a number of tasks subscribe to.
+ *  @param   num_subscribers How many subscriber tasks to start, up to 4
+ *  @param   p_wakeups Set to the mean number of wakeups per subscriber
+ *  @returns The mean time per put in nanoseconds
+ */
+static double time_fanout (uint8_t num_subscribers, double* p_wakeups)
+{
+    FastShare<float> topic ("Bench topic");
+    std::atomic<bool> running (true);
+    std::atomic<uint8_t> ready (0);
+    std::atomic<uint32_t> wakeups (0);
+    std::vector<std::thread> threads;
+
+    for (uint8_t index = 0; index < num_subscribers; index++)
+    {
+        threads.emplace_back ([&topic, &running, &ready, &wakeups]
+        {
+            Subscription<float> subscription (topic, 1);
+            float value;
+            ready++;
+
+            while (running)
+            {
+                if (wait_for_topics (10) & subscription.bit ())
+                {
+                    subscription.get (value);
+                    wakeups++;
+                }
+            }
+        });
+    }
+    while (ready < num_subscribers)
+    {
+        std::this_thread::yield ();
+    }
+
+    int64_t start = bench_now_ns ();
+    for (uint32_t count = 0; count < FANOUT_PUTS; count++)
+    {
+        topic.put ((float)count);
+    }
+    int64_t elapsed = bench_now_ns () - start;
+
+    running = false;
+    for (std::thread& thread : threads)
+    {
+        thread.join ();
+    }
+
+    *p_wakeups = num_subscribers ? (double)wakeups / num_subscribers : 0.0;
+    return (double)elapsed / FANOUT_PUTS;
+}
+
+
+void bench_share (void)
+{
+    Share<float> queue_share ("Bench queue");
+    FastShare<float> fast_share ("Bench fast");
+    const uint8_t thread_counts[] = { 1, 2, 4 };
+
+    printf ("Share<float> vs. FastShare<float> (ns/op, 1 writer + N-1 readers)\n");
+    printf ("threads  Share   FastShare\n");
+    for (uint8_t num_threads : thread_counts)
+    {
+        double queue_ns = time_share (queue_share, num_threads);
+        double fast_ns = time_share (fast_share, num_threads);
+        printf ("%7u  %6.1f  %9.1f\n", num_threads, queue_ns, fast_ns);
+    }
+    printf ("\n");
+
+    printf ("FastShare<float> put with subscribers (%u puts)\n",
+            (unsigned)FANOUT_PUTS);
+    printf ("subscribers  ns/put  wakeups each\n");
+    for (uint8_t num_subscribers = 0; num_subscribers <= 4; num_subscribers++)
+    {
+        double wakeups;
+        double put_ns = time_fanout (num_subscribers, &wakeups);
+        printf ("%11u  %6.1f  %12.0f\n", num_subscribers, put_ns, wakeups);
+    }
+    printf ("\n");
+}
@@ -0,0 +1,139 @@
+/** @file    bench_tasks.cpp
+ *  @brief   Run a copy of the IMU, controller and motor task graph on the host.
+ *  @details Three tasks are started with @c xTaskCreate() and exchange data
+ *           through the same kinds of shares as the tasks in @c main.cpp: an
+ *           IMU task publishes attitude snapshots every tick, a controller
+ *           task runs the two attitude loops every 50 ms, and a motor task
+ *           sleeps until the duty cycle changes and then applies it. After
+ *           one second the number of cycles each task ran, the controller's
+ *           compute time and the motor task's wake latency are printed.
+ *           Running this under @c perf shows where the task layer spends time.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <atomic>
+#include "bench.h"
+#include "fastshare.h"
+#include "notifyshare.h"
+#include "attitude.h"
+#include "PIDController.h"
+
+/// Attitude published by the simulated IMU task
+static FastShare<Attitude> sim_attitude ("Sim attitude");
+
+/// Elevator duty cycle published by the simulated controller task
+static NotifyShare<int16_t> sim_duty ("Sim duty");
+
+/// Cleared to make the simulated tasks return
+static std::atomic<bool> running (true);
+
+static std::atomic<uint32_t> imu_cycles (0);          ///< IMU task cycles
+static std::atomic<uint32_t> controller_cycles (0);   ///< Controller cycles
+static std::atomic<uint32_t> motor_cycles (0);        ///< Motor task cycles
+static std::atomic<int64_t> controller_ns (0);        ///< Controller run time
+static std::atomic<uint32_t> latency_sum_us (0);      ///< Put to apply, summed
+static std::atomic<uint32_t> latency_max_us (0);      ///< Put to apply, worst
+
+
+/** @brief   Simulated IMU task which publishes a slowly rocking attitude.
+ *  @param   p_params Unused
+ */
+static void sim_task_IMU (void* p_params)
+{
+    (void)p_params;
+
+    Attitude att = {};
+
+    while (running)
+    {
+        att.time_us = micros ();
+        att.pitch = 5.0f * sinf (att.time_us * 1e-6f);
+        att.roll = 3.0f * cosf (att.time_us * 1e-6f);
+        att.sequence++;
+        sim_attitude.put (att);
+
+        imu_cycles++;
+        vTaskDelay (1);
+    }
+}
+
+
+/** @brief   Simulated controller task running the two attitude loops.
+ *  @param   p_params Unused
+ */
+static void sim_task_controller (void* p_params)
+{
+    (void)p_params;
+
+    PIDController pitch2elev (1, 0, 0, 50);
+    PIDController elev2duty (3, 0, 0, 50);
+
+    while (running)
+    {
+        int64_t start = bench_now_ns ();
+
+        Attitude att = sim_attitude.get ();
+        float elev_angle = pitch2elev.getCtrlOutput (att.pitch, 0);
+        float duty = elev2duty.getCtrlOutput (0, elev_angle);
+        sim_duty.put ((int16_t)fmaxf (-100, fminf (100, duty)));
+
+        controller_ns += bench_now_ns () - start;
+        controller_cycles++;
+        vTaskDelay (50);
+    }
+}
+
+
+/** @brief   Simulated motor task which waits for the duty cycle to change.
+ *  @param   p_params Unused
+ */
+static void sim_task_motor (void* p_params)
+{
+    (void)p_params;
+
+    int16_t duty;
+
+    while (running)
+    {
+        if (!sim_duty.wait (duty, 100))
+        {
+            continue;
+        }
+
+        uint32_t latency = micros () - sim_duty.change_time ();
+        latency_sum_us += latency;
+        if (latency > latency_max_us)
+        {
+            latency_max_us = latency;
+        }
+        motor_cycles++;
+    }
+}
+
+
+void bench_tasks (void)
+{
+    xTaskCreate (sim_task_motor, "Motor", 2048, NULL, 20, NULL);
+    xTaskCreate (sim_task_controller, "Controller", 2048, NULL, 60, NULL);
+    xTaskCreate (sim_task_IMU, "IMU", 2048, NULL, 30, NULL);
+
+    vTaskDelay (1000);
+    running = false;
+    vTaskDelay (100);
+
+    uint32_t cycles = controller_cycles;
+    printf ("Task graph, 1 s on the host\n");
+    printf ("IMU cycles %u, controller cycles %u, motor cycles %u\n",
+            (unsigned)imu_cycles, (unsigned)cycles, (unsigned)motor_cycles);
+    printf ("controller ns/cycle  %.0f\n",
+            cycles ? (double)controller_ns / cycles : 0.0);
+
+    uint32_t updates = motor_cycles;
+    printf ("motor wake latency us  avg %.1f  max %u\n\n",
+            updates ? (double)latency_sum_us / updates : 0.0,
+            (unsigned)latency_max_us);
+}
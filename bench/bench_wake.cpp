@@ -0,0 +1,139 @@
+/** @file    bench_wake.cpp
+ *  @brief   Age of an IMU batch when the IMU task gets to it, woken by the
+ *           watermark interrupt or polling.
+ *  @details A sensor thread reaches the FIFO watermark every 19.2 ms (four
+ *           samples at 208 Hz), notes the time and notifies a waiting task
+ *           as the INT1 ISR does. A second task polls every 20 ms as
+ *           @c task_IMU did before, and takes whatever batch is newest. For
+ *           each the time from the watermark to the task seeing the batch is
+ *           printed, along with how many polls found nothing new.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <Arduino.h>
+#include "bench.h"
+
+static const uint32_t BATCHES = 100;            ///< Watermarks reached in the run
+static const int64_t BATCH_NS = 19230769;       ///< Time to reach the watermark (ns)
+
+static std::atomic<int64_t> ready_ns (0);       ///< When the watermark was last reached
+static std::atomic<uint32_t> batch (0);         ///< Number of watermarks reached
+static std::atomic<bool> running (true);        ///< Cleared to make the tasks return
+
+/// Totals of the age of each batch when a task saw it
+struct WakeStats
+{
+    double sum_us = 0;              ///< Sum of the ages (us)
+    double worst_us = 0;            ///< Largest age (us)
+    uint32_t seen = 0;              ///< Batches seen
+    uint32_t empty = 0;             ///< Wake-ups which found no new batch
+};
+
+static WakeStats by_interrupt;      ///< Ages seen by the notified task
+static WakeStats by_polling;        ///< Ages seen by the polling task
+
+
+/** @brief   Add the newest batch's age to a task's totals, if it is new.
+ *  @param   stats The task's totals
+ *  @param   last The number of the last batch the task saw
+ */
+static void see_batch (WakeStats& stats, uint32_t& last)
+{
+    uint32_t now_batch = batch.load ();
+    if (now_batch == last)
+    {
+        stats.empty++;
+        return;
+    }
+    last = now_batch;
+    double age_us = (bench_now_ns () - ready_ns.load ()) / 1000.0;
+    stats.sum_us += age_us;
+    stats.worst_us = (age_us > stats.worst_us) ? age_us : stats.worst_us;
+    stats.seen++;
+}
+
+
+/** @brief   Task which sleeps until notified, as @c task_IMU does now.
+ *  @param   p_params Unused
+ */
+static void bench_task_notified (void* p_params)
+{
+    (void)p_params;
+
+    uint32_t last = 0;
+    while (running)
+    {
+        if (ulTaskNotifyTake (pdTRUE, 40) > 0)
+        {
+            see_batch (by_interrupt, last);
+        }
+    }
+}
+
+
+/** @brief   Task which polls every 20 ms, as @c task_IMU did before.
+ *  @param   p_params Unused
+ */
+static void bench_task_polled (void* p_params)
+{
+    (void)p_params;
+
+    uint32_t last = 0;
+    TickType_t release = xTaskGetTickCount ();
+    while (running)
+    {
+        vTaskDelayUntil (&release, 20);
+        see_batch (by_polling, last);
+    }
+}
+
+
+/** @brief   Print one task's totals.
+ *  @param   label The name of the method
+ *  @param   stats Its totals
+ */
+static void report (const char* label, const WakeStats& stats)
+{
+    printf ("%-22s %8.1f  %8.1f  %6u  %11u\n", label,
+            stats.sum_us / stats.seen, stats.worst_us, stats.seen, stats.empty);
+}
+
+
+void bench_wake (void)
+{
+    printf ("IMU batch age when the task sees it, watermark every %.1f ms\n",
+            BATCH_NS / 1e6);
+    fflush (stdout);
+
+    TaskHandle_t notified = NULL;
+    xTaskCreate (bench_task_notified, "Notified", 2048, NULL, 62, &notified);
+    xTaskCreate (bench_task_polled, "Polled", 2048, NULL, 30, NULL);
+    vTaskDelay (5);
+
+    int64_t next = bench_now_ns () + BATCH_NS;
+    for (uint32_t count = 0; count < BATCHES; count++)
+    {
+        while (bench_now_ns () < next)
+        {
+            std::this_thread::yield ();
+        }
+        vPortSetIsrContext (true);
+        ready_ns = bench_now_ns ();
+        batch++;
+        vTaskNotifyGiveFromISR (notified, NULL);
+        vPortSetIsrContext (false);
+        next += BATCH_NS;
+    }
+    running = false;
+    vTaskDelay (50);
+
+    printf ("wake                     avg us    max us  batches  empty wakes\n");
+    report ("INT1 notification", by_interrupt);
+    report ("20 ms poll", by_polling);
+    printf ("\n");
+}
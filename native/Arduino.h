@@ -0,0 +1,102 @@
+/** @file    Arduino.h
+ *  @brief   Host stand-in for the parts of the Arduino core used in @c src/.
+ *  @details This header replaces the ESP32 Arduino core when building the
+ *           @c native environment. It provides the @c Print class, a
+ *           @c Serial port which writes to standard output, the timing
+ *           functions, and the FreeRTOS subset in @c freertos_shim.h.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#ifndef _ARDUINO_SHIM_H_
+#define _ARDUINO_SHIM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "freertos_shim.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef uint8_t byte;                       ///< Arduino's name for a byte
+
+#define DEC 10                              ///< Print numbers in decimal
+#define HEX 16                              ///< Print numbers in hexadecimal
+#define BIN 2                               ///< Print numbers in binary
+
+
+/** @brief   Host version of the Arduino @c Print class.
+ *  @details Descendents only have to supply @c write() for a block of bytes;
+ *           all the @c print() and @c println() overloads are built on it.
+ */
+class Print
+{
+public:
+    virtual ~Print (void) { }
+
+    /// Write a block of bytes to the device
+    virtual size_t write (const uint8_t* buffer, size_t size) = 0;
+
+    /// Write one byte to the device
+    size_t write (uint8_t byte_out) { return write (&byte_out, 1); }
+
+    size_t printf (const char* format, ...)
+        __attribute__ ((format (printf, 2, 3)));
+
+    size_t print (const char* text);
+    size_t print (char ch);
+    size_t print (bool value) { return print (value ? "1" : "0"); }
+    size_t print (int value, int base = DEC) { return print ((long)value, base); }
+    size_t print (unsigned int value, int base = DEC)
+        { return print ((unsigned long)value, base); }
+    size_t print (long value, int base = DEC);
+    size_t print (unsigned long value, int base = DEC);
+    size_t print (long long value, int base = DEC);
+    size_t print (unsigned long long value, int base = DEC);
+    size_t print (double value, int digits = 2);
+
+    size_t println (void) { return print ("\r\n"); }
+
+    /// Print anything @c print() can print, then end the line
+    template <class T> size_t println (T value)
+    {
+        size_t count = print (value);
+        return count + println ();
+    }
+
+    /// Print a number in a given base or with a given precision, then end it
+    template <class T> size_t println (T value, int format)
+    {
+        size_t count = print (value, format);
+        return count + println ();
+    }
+};
+
+
+/** @brief   Serial port which writes to the host's standard output.
+ */
+class HostSerial : public Print
+{
+public:
+    void begin (unsigned long baud_rate) { (void)baud_rate; }
+    size_t write (const uint8_t* buffer, size_t size);
+    using Print::write;
+
+    /// The host's standard output is always ready
+    operator bool (void) { return true; }
+};
+
+extern HostSerial Serial;                   ///< Standard output as a serial port
+
+// Timing
+unsigned long millis (void);
+unsigned long micros (void);
+void delay (uint32_t ms);
+void delayMicroseconds (uint32_t us);
+
+#endif // _ARDUINO_SHIM_H_
@@ -0,0 +1,44 @@
+/** @file    PrintStream.h
+ *  @brief   Host stand-in for the Arduino-PrintStream library.
+ *  @details This header provides the @c << operator and @c endl manipulator
+ *           which the project's code uses with @c Print devices, so that the
+ *           real library (an Arduino-only dependency) is not needed when
+ *           building the @c native environment.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#ifndef _PRINTSTREAM_SHIM_H_
+#define _PRINTSTREAM_SHIM_H_
+
+#include "Arduino.h"
+
+/// Manipulator which ends a line when sent to a @c Print device with @c <<
+enum PrintStreamEndl { endl };
+
+
+/** @brief   Print anything that @c Print::print() can print.
+ *  @param   printer The device on which to print
+ *  @param   value The item to be printed
+ *  @returns A reference to the device, so that @c << can be chained
+ */
+template <class T>
+inline Print& operator << (Print& printer, const T& value)
+{
+    printer.print (value);
+    return printer;
+}
+
+
+/** @brief   End a line on a @c Print device.
+ *  @param   printer The device on which to print
+ *  @returns A reference to the device, so that @c << can be chained
+ */
+inline Print& operator << (Print& printer, PrintStreamEndl)
+{
+    printer.println ();
+    return printer;
+}
+
+#endif // _PRINTSTREAM_SHIM_H_
@@ -0,0 +1,146 @@
+/** @file    arduino_shim.cpp
+ *  @brief   Host implementation of the Arduino subset in @c Arduino.h.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <stdarg.h>
+#include <chrono>
+#include <thread>
+#include "Arduino.h"
+#include "esp_timer.h"
+
+
+/// Standard output, standing in for the ESP32's serial port
+HostSerial Serial;
+
+/// The time at which the program started, from which @c millis() counts
+static const std::chrono::steady_clock::time_point start_time
+    = std::chrono::steady_clock::now ();
+
+
+size_t Print::printf (const char* format, ...)
+{
+    char buffer[256];
+    va_list args;
+
+    va_start (args, format);
+    int length = vsnprintf (buffer, sizeof (buffer), format, args);
+    va_end (args);
+
+    if (length < 0)
+    {
+        return 0;
+    }
+    if ((size_t)length >= sizeof (buffer))
+    {
+        length = sizeof (buffer) - 1;
+    }
+    return write ((const uint8_t*)buffer, length);
+}
+
+
+size_t Print::print (const char* text)
+{
+    return write ((const uint8_t*)text, strlen (text));
+}
+
+
+size_t Print::print (char ch)
+{
+    return write ((uint8_t)ch);
+}
+
+
+size_t Print::print (long value, int base)
+{
+    if (base == DEC)
+    {
+        return printf ("%ld", value);
+    }
+    return print ((unsigned long)value, base);
+}
+
+
+size_t Print::print (unsigned long value, int base)
+{
+    return print ((unsigned long long)value, base);
+}
+
+
+size_t Print::print (long long value, int base)
+{
+    if (base == DEC)
+    {
+        return printf ("%lld", value);
+    }
+    return print ((unsigned long long)value, base);
+}
+
+
+size_t Print::print (unsigned long long value, int base)
+{
+    char digits[65];
+    char* p_digit = &digits[64];
+
+    if (base < 2 || base > 16)
+    {
+        base = DEC;
+    }
+
+    *p_digit = '\0';
+    do
+    {
+        *--p_digit = "0123456789ABCDEF"[value % base];
+        value /= base;
+    }
+    while (value);
+
+    return print (p_digit);
+}
+
+
+size_t Print::print (double value, int digits)
+{
+    return printf ("%.*f", digits, value);
+}
+
+
+size_t HostSerial::write (const uint8_t* buffer, size_t size)
+{
+    return fwrite (buffer, 1, size, stdout);
+}
+
+
+unsigned long millis (void)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds> (
+        std::chrono::steady_clock::now () - start_time).count ();
+}
+
+
+unsigned long micros (void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds> (
+        std::chrono::steady_clock::now () - start_time).count ();
+}
+
+
+int64_t esp_timer_get_time (void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds> (
+        std::chrono::steady_clock::now () - start_time).count ();
+}
+
+
+void delay (uint32_t ms)
+{
+    std::this_thread::sleep_for (std::chrono::milliseconds (ms));
+}
+
+
+void delayMicroseconds (uint32_t us)
+{
+    std::this_thread::sleep_for (std::chrono::microseconds (us));
+}
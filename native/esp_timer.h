@@ -0,0 +1,19 @@
+/** @file    esp_timer.h
+ *  @brief   Host stand-in for the ESP-IDF high resolution timer.
+ *  @details Only @c esp_timer_get_time() is provided. It counts microseconds
+ *           from the same starting point as @c micros(), but in 64 bits, so
+ *           it doesn't wrap around.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#ifndef _ESP_TIMER_SHIM_H_
+#define _ESP_TIMER_SHIM_H_
+
+#include <stdint.h>
+
+/// Return the number of microseconds since the program started
+int64_t esp_timer_get_time (void);
+
+#endif // _ESP_TIMER_SHIM_H_
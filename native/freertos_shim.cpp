@@ -0,0 +1,520 @@
+/** @file    freertos_shim.cpp
+ *  @brief   Host implementation of the FreeRTOS subset in @c freertos_shim.h.
+ *  @details Queues are ring buffers guarded by a mutex, with a condition
+ *           variable which wakes any thread blocked waiting for space or data.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "freertos_shim.h"
+
+
+/** @brief   Host version of the FreeRTOS queue structure.
+ */
+struct QueueDefinition
+{
+    std::mutex mutex;                       ///< Protects everything below
+    std::condition_variable changed;        ///< Signalled on every put or get
+    std::vector<uint8_t> storage;           ///< Space for all the items
+    UBaseType_t length;                     ///< Number of items which fit
+    UBaseType_t item_size;                  ///< Size of each item in bytes
+    UBaseType_t head;                       ///< Index of the oldest item
+    UBaseType_t count;                      ///< Number of items now queued
+
+    /// Return a pointer to the item which is @c offset places from the head
+    uint8_t* slot (UBaseType_t offset)
+    {
+        return &storage[((head + offset) % length) * item_size];
+    }
+};
+
+
+/** @brief   Wait on a queue's condition variable until a predicate is true.
+ *  @param   queue The queue whose lock is held by @c lock
+ *  @param   lock The held lock on the queue's mutex
+ *  @param   ticks_to_wait How many ticks (milliseconds) to wait at most
+ *  @param   ready The predicate to wait for
+ *  @returns @c true if the predicate became true before the timeout
+ */
+template <class Predicate>
+static bool wait_for (QueueHandle_t queue, std::unique_lock<std::mutex>& lock,
+                      TickType_t ticks_to_wait, Predicate ready)
+{
+    if (ticks_to_wait == portMAX_DELAY)
+    {
+        queue->changed.wait (lock, ready);
+        return true;
+    }
+    return queue->changed.wait_for (
+        lock, std::chrono::milliseconds (ticks_to_wait), ready);
+}
+
+
+/** @brief   Put an item at the back or front of a queue, waiting for space.
+ *  @param   queue The queue into which the item is put
+ *  @param   p_item A pointer to the item to be copied into the queue
+ *  @param   ticks_to_wait How long to wait for space in the queue
+ *  @param   to_front @c true to put the item in front of all the others
+ *  @returns @c pdTRUE if the item was queued, @c pdFALSE if it timed out
+ */
+static BaseType_t send (QueueHandle_t queue, const void* p_item,
+                        TickType_t ticks_to_wait, bool to_front)
+{
+    std::unique_lock<std::mutex> lock (queue->mutex);
+    if (!wait_for (queue, lock, ticks_to_wait,
+                   [queue] { return queue->count < queue->length; }))
+    {
+        return pdFALSE;
+    }
+
+    if (to_front)
+    {
+        queue->head = (queue->head + queue->length - 1) % queue->length;
+        memcpy (queue->slot (0), p_item, queue->item_size);
+    }
+    else
+    {
+        memcpy (queue->slot (queue->count), p_item, queue->item_size);
+    }
+    queue->count++;
+
+    queue->changed.notify_all ();
+    return pdTRUE;
+}
+
+
+/** @brief   Copy the item at the head of a queue, optionally removing it.
+ *  @param   queue The queue from which the item is read
+ *  @param   p_buffer A pointer to memory which receives the item
+ *  @param   ticks_to_wait How long to wait for an item to arrive
+ *  @param   remove @c true to take the item out of the queue
+ *  @returns @c pdTRUE if an item was read, @c pdFALSE if it timed out
+ */
+static BaseType_t receive (QueueHandle_t queue, void* p_buffer,
+                           TickType_t ticks_to_wait, bool remove)
+{
+    std::unique_lock<std::mutex> lock (queue->mutex);
+    if (!wait_for (queue, lock, ticks_to_wait,
+                   [queue] { return queue->count > 0; }))
+    {
+        return pdFALSE;
+    }
+
+    memcpy (p_buffer, queue->slot (0), queue->item_size);
+    if (remove)
+    {
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        queue->changed.notify_all ();
+    }
+    return pdTRUE;
+}
+
+
+QueueHandle_t xQueueCreate (UBaseType_t queue_length, UBaseType_t item_size)
+{
+    QueueHandle_t queue = new QueueDefinition;
+    queue->storage.resize (queue_length * item_size);
+    queue->length = queue_length;
+    queue->item_size = item_size;
+    queue->head = 0;
+    queue->count = 0;
+    return queue;
+}
+
+
+QueueHandle_t xQueueCreateStatic (UBaseType_t queue_length,
+                                  UBaseType_t item_size, uint8_t* p_storage,
+                                  StaticQueue_t* p_queue_buffer)
+{
+    (void)p_storage;
+    (void)p_queue_buffer;
+    return xQueueCreate (queue_length, item_size);
+}
+
+
+BaseType_t xQueueSendToBack (QueueHandle_t queue, const void* p_item,
+                             TickType_t ticks_to_wait)
+{
+    return send (queue, p_item, ticks_to_wait, false);
+}
+
+
+BaseType_t xQueueSendToFront (QueueHandle_t queue, const void* p_item,
+                              TickType_t ticks_to_wait)
+{
+    return send (queue, p_item, ticks_to_wait, true);
+}
+
+
+BaseType_t xQueueSendToBackFromISR (QueueHandle_t queue, const void* p_item,
+                                    BaseType_t* p_woken)
+{
+    if (p_woken != NULL)
+    {
+        *p_woken = pdFALSE;
+    }
+    return send (queue, p_item, 0, false);
+}
+
+
+BaseType_t xQueueSendToFrontFromISR (QueueHandle_t queue, const void* p_item,
+                                     BaseType_t* p_woken)
+{
+    if (p_woken != NULL)
+    {
+        *p_woken = pdFALSE;
+    }
+    return send (queue, p_item, 0, true);
+}
+
+
+BaseType_t xQueueOverwrite (QueueHandle_t queue, const void* p_item)
+{
+    std::lock_guard<std::mutex> lock (queue->mutex);
+
+    // Overwriting is only meant for queues of length one, as in FreeRTOS
+    memcpy (queue->slot (0), p_item, queue->item_size);
+    queue->count = 1;
+
+    queue->changed.notify_all ();
+    return pdPASS;
+}
+
+
+BaseType_t xQueueOverwriteFromISR (QueueHandle_t queue, const void* p_item,
+                                   BaseType_t* p_woken)
+{
+    if (p_woken != NULL)
+    {
+        *p_woken = pdFALSE;
+    }
+    return xQueueOverwrite (queue, p_item);
+}
+
+
+BaseType_t xQueueReceive (QueueHandle_t queue, void* p_buffer,
+                          TickType_t ticks_to_wait)
+{
+    return receive (queue, p_buffer, ticks_to_wait, true);
+}
+
+
+BaseType_t xQueueReceiveFromISR (QueueHandle_t queue, void* p_buffer,
+                                 BaseType_t* p_woken)
+{
+    if (p_woken != NULL)
+    {
+        *p_woken = pdFALSE;
+    }
+    return receive (queue, p_buffer, 0, true);
+}
+
+
+BaseType_t xQueuePeek (QueueHandle_t queue, void* p_buffer,
+                       TickType_t ticks_to_wait)
+{
+    return receive (queue, p_buffer, ticks_to_wait, false);
+}
+
+
+BaseType_t xQueuePeekFromISR (QueueHandle_t queue, void* p_buffer)
+{
+    return receive (queue, p_buffer, 0, false);
+}
+
+
+UBaseType_t uxQueueMessagesWaiting (QueueHandle_t queue)
+{
+    std::lock_guard<std::mutex> lock (queue->mutex);
+    return queue->count;
+}
+
+
+UBaseType_t uxQueueMessagesWaitingFromISR (QueueHandle_t queue)
+{
+    return uxQueueMessagesWaiting (queue);
+}
+
+
+/** @brief   Host version of the FreeRTOS task control block.
+ *  @details Each thread gets one of these the first time it asks for its own
+ *           handle. Only the notification value is kept here.
+ */
+struct tskTaskControlBlock
+{
+    std::mutex mutex;                       ///< Protects the notification
+    std::condition_variable notified;       ///< Signalled when given
+    uint32_t notify_value;                  ///< The notification value
+    bool pending;                           ///< A notification is unread
+};
+
+
+/// The calling thread's task control block, created when first needed
+static thread_local TaskHandle_t current_task = NULL;
+
+
+TaskHandle_t xTaskGetCurrentTaskHandle (void)
+{
+    if (current_task == NULL)
+    {
+        current_task = new tskTaskControlBlock;
+        current_task->notify_value = 0;
+        current_task->pending = false;
+    }
+    return current_task;
+}
+
+
+/// The time at which the program started, from which ticks are counted
+static const std::chrono::steady_clock::time_point start_time
+    = std::chrono::steady_clock::now ();
+
+
+BaseType_t xTaskCreate (TaskFunction_t task_function, const char* p_name,
+                        uint32_t stack_depth, void* p_params,
+                        UBaseType_t priority, TaskHandle_t* p_handle)
+{
+    return xTaskCreatePinnedToCore (task_function, p_name, stack_depth,
+                                    p_params, priority, p_handle,
+                                    tskNO_AFFINITY);
+}
+
+
+BaseType_t xTaskCreatePinnedToCore (TaskFunction_t task_function,
+                                    const char* p_name, uint32_t stack_depth,
+                                    void* p_params, UBaseType_t priority,
+                                    TaskHandle_t* p_handle, BaseType_t core)
+{
+    (void)p_name;
+    (void)stack_depth;
+    (void)priority;
+    (void)core;
+
+    // Make the task's control block here so that the handle can be returned
+    // before the thread starts running
+    TaskHandle_t task = new tskTaskControlBlock;
+    task->notify_value = 0;
+    task->pending = false;
+    if (p_handle != NULL)
+    {
+        *p_handle = task;
+    }
+
+    std::thread ([task_function, p_params, task]
+    {
+        current_task = task;
+        task_function (p_params);
+    }).detach ();
+
+    return pdPASS;
+}
+
+
+TaskHandle_t xTaskCreateStatic (TaskFunction_t task_function,
+                                const char* p_name, uint32_t stack_depth,
+                                void* p_params, UBaseType_t priority,
+                                StackType_t* p_stack, StaticTask_t* p_task)
+{
+    (void)p_stack;
+    (void)p_task;
+
+    TaskHandle_t handle = NULL;
+    xTaskCreate (task_function, p_name, stack_depth, p_params, priority,
+                 &handle);
+    return handle;
+}
+
+
+TaskHandle_t xTaskCreateStaticPinnedToCore (TaskFunction_t task_function,
+                                            const char* p_name,
+                                            uint32_t stack_depth,
+                                            void* p_params,
+                                            UBaseType_t priority,
+                                            StackType_t* p_stack,
+                                            StaticTask_t* p_task,
+                                            BaseType_t core)
+{
+    (void)p_stack;
+    (void)p_task;
+
+    TaskHandle_t handle = NULL;
+    xTaskCreatePinnedToCore (task_function, p_name, stack_depth, p_params,
+                             priority, &handle, core);
+    return handle;
+}
+
+
+void vTaskDelay (TickType_t ticks)
+{
+    std::this_thread::sleep_for (std::chrono::milliseconds (ticks));
+}
+
+
+void vTaskDelayUntil (TickType_t* p_previous_wake, TickType_t period)
+{
+    *p_previous_wake += period;
+    std::this_thread::sleep_until (
+        start_time + std::chrono::milliseconds (*p_previous_wake));
+}
+
+
+TickType_t xTaskGetTickCount (void)
+{
+    return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds> (
+        std::chrono::steady_clock::now () - start_time).count ();
+}
+
+
+BaseType_t xTaskNotifyGive (TaskHandle_t task)
+{
+    return xTaskNotify (task, 0, eIncrement);
+}
+
+
+void vTaskNotifyGiveFromISR (TaskHandle_t task, BaseType_t* p_woken)
+{
+    if (p_woken != NULL)
+    {
+        *p_woken = pdFALSE;
+    }
+    xTaskNotifyGive (task);
+}
+
+
+uint32_t ulTaskNotifyTake (BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle ();
+    std::unique_lock<std::mutex> lock (task->mutex);
+    auto given = [task] { return task->notify_value != 0; };
+
+    if (ticks_to_wait == portMAX_DELAY)
+    {
+        task->notified.wait (lock, given);
+    }
+    else
+    {
+        task->notified.wait_for (
+            lock, std::chrono::milliseconds (ticks_to_wait), given);
+    }
+
+    uint32_t value = task->notify_value;
+    if (value != 0)
+    {
+        task->notify_value = clear_on_exit ? 0 : value - 1;
+    }
+    task->pending = false;
+    return value;
+}
+
+
+BaseType_t xTaskNotify (TaskHandle_t task, uint32_t value,
+                        eNotifyAction action)
+{
+    std::lock_guard<std::mutex> lock (task->mutex);
+
+    switch (action)
+    {
+        case eSetBits:
+            task->notify_value |= value;
+            break;
+        case eIncrement:
+            task->notify_value++;
+            break;
+        case eSetValueWithOverwrite:
+            task->notify_value = value;
+            break;
+        case eSetValueWithoutOverwrite:
+            if (task->pending)
+            {
+                return pdFAIL;
+            }
+            task->notify_value = value;
+            break;
+        case eNoAction:
+            break;
+    }
+
+    task->pending = true;
+    task->notified.notify_one ();
+    return pdPASS;
+}
+
+
+BaseType_t xTaskNotifyFromISR (TaskHandle_t task, uint32_t value,
+                               eNotifyAction action, BaseType_t* p_woken)
+{
+    if (p_woken != NULL)
+    {
+        *p_woken = pdFALSE;
+    }
+    return xTaskNotify (task, value, action);
+}
+
+
+BaseType_t xTaskNotifyWait (uint32_t clear_on_entry, uint32_t clear_on_exit,
+                            uint32_t* p_value, TickType_t ticks_to_wait)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle ();
+    std::unique_lock<std::mutex> lock (task->mutex);
+    auto given = [task] { return task->pending; };
+
+    if (!task->pending)
+    {
+        task->notify_value &= ~clear_on_entry;
+    }
+
+    bool received;
+    if (ticks_to_wait == portMAX_DELAY)
+    {
+        task->notified.wait (lock, given);
+        received = true;
+    }
+    else
+    {
+        received = task->notified.wait_for (
+            lock, std::chrono::milliseconds (ticks_to_wait), given);
+    }
+
+    if (p_value != NULL)
+    {
+        *p_value = task->notify_value;
+    }
+    if (received)
+    {
+        task->notify_value &= ~clear_on_exit;
+        task->pending = false;
+    }
+    return received ? pdTRUE : pdFALSE;
+}
+
+
+/// Set in a thread which is standing in for an interrupt service routine
+static thread_local bool in_isr_context = false;
+
+
+BaseType_t xPortInIsrContext (void)
+{
+    return in_isr_context ? pdTRUE : pdFALSE;
+}
+
+
+/** @brief   Mark the calling thread as running (or not) in an ISR.
+ *  @param   in_isr @c true while the thread is simulating an ISR
+ */
+void vPortSetIsrContext (bool in_isr)
+{
+    in_isr_context = in_isr;
+}
+
+
+size_t xPortGetFreeHeapSize (void)
+{
+    return 0;
+}
@@ -0,0 +1,187 @@
+/** @file    freertos_shim.h
+ *  @brief   Host stand-ins for the FreeRTOS calls used by the project.
+ *  @details This file declares a small subset of the FreeRTOS API, built on
+ *           C++ threads, mutexes and condition variables, so that the
+ *           inter-task data classes in @c src/ can be compiled and measured on
+ *           a workstation. Only the functions which the project actually uses
+ *           are provided. One RTOS tick is one millisecond, as on the ESP32.
+ *           Tasks are ordinary threads scheduled by the host OS, so profilers
+ *           such as @c perf see them as separate threads of one process.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#ifndef _FREERTOS_SHIM_H_
+#define _FREERTOS_SHIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+#include <atomic>
+#include <thread>
+
+typedef int BaseType_t;                     ///< Signed base type of the port
+typedef unsigned int UBaseType_t;           ///< Unsigned base type of the port
+typedef uint32_t TickType_t;                ///< Type which holds RTOS ticks
+
+#define pdFALSE             ((BaseType_t)0)
+#define pdTRUE              ((BaseType_t)1)
+#define pdPASS              (pdTRUE)
+#define pdFAIL              (pdFALSE)
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFFUL)
+#define configTICK_RATE_HZ  1000
+#define portTICK_PERIOD_MS  ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portBASE_TYPE       BaseType_t
+#define configMAX_PRIORITIES 25
+#define configASSERT(x)     assert (x)
+
+/// Opaque handle to a queue; the structure lives in @c freertos_shim.cpp
+typedef struct QueueDefinition* QueueHandle_t;
+
+/// Stack element; the ESP32 port measures stacks in bytes
+typedef uint8_t StackType_t;
+
+/// Space for a queue's control block when the queue is created statically
+typedef struct { void* p_dummy[8]; } StaticQueue_t;
+
+/// Space for a task's control block when the task is created statically
+typedef struct { void* p_dummy[48]; } StaticTask_t;
+
+// Queues
+QueueHandle_t xQueueCreate (UBaseType_t queue_length, UBaseType_t item_size);
+BaseType_t xQueueSendToBack (QueueHandle_t queue, const void* p_item,
+                             TickType_t ticks_to_wait);
+BaseType_t xQueueSendToFront (QueueHandle_t queue, const void* p_item,
+                              TickType_t ticks_to_wait);
+BaseType_t xQueueSendToBackFromISR (QueueHandle_t queue, const void* p_item,
+                                    BaseType_t* p_woken);
+BaseType_t xQueueSendToFrontFromISR (QueueHandle_t queue, const void* p_item,
+                                     BaseType_t* p_woken);
+BaseType_t xQueueOverwrite (QueueHandle_t queue, const void* p_item);
+BaseType_t xQueueOverwriteFromISR (QueueHandle_t queue, const void* p_item,
+                                   BaseType_t* p_woken);
+BaseType_t xQueueReceive (QueueHandle_t queue, void* p_buffer,
+                          TickType_t ticks_to_wait);
+BaseType_t xQueueReceiveFromISR (QueueHandle_t queue, void* p_buffer,
+                                 BaseType_t* p_woken);
+BaseType_t xQueuePeek (QueueHandle_t queue, void* p_buffer,
+                       TickType_t ticks_to_wait);
+BaseType_t xQueuePeekFromISR (QueueHandle_t queue, void* p_buffer);
+UBaseType_t uxQueueMessagesWaiting (QueueHandle_t queue);
+UBaseType_t uxQueueMessagesWaitingFromISR (QueueHandle_t queue);
+
+// The host has no fixed heap, so static creation takes the given memory in
+// name only and still allocates the queue's real structure
+QueueHandle_t xQueueCreateStatic (UBaseType_t queue_length,
+                                  UBaseType_t item_size, uint8_t* p_storage,
+                                  StaticQueue_t* p_queue_buffer);
+
+/// Opaque handle to a task; the structure lives in @c freertos_shim.cpp
+typedef struct tskTaskControlBlock* TaskHandle_t;
+
+/// Type of a function which runs as a task
+typedef void (*TaskFunction_t) (void*);
+
+/// Lets a task run on either core; only meaningful on the ESP32
+#define tskNO_AFFINITY      ((BaseType_t)0x7FFFFFFF)
+
+// Tasks. Each task is a detached thread which starts at once; priorities,
+// stack sizes and cores are accepted but not used
+BaseType_t xTaskCreate (TaskFunction_t task_function, const char* p_name,
+                        uint32_t stack_depth, void* p_params,
+                        UBaseType_t priority, TaskHandle_t* p_handle);
+BaseType_t xTaskCreatePinnedToCore (TaskFunction_t task_function,
+                                    const char* p_name, uint32_t stack_depth,
+                                    void* p_params, UBaseType_t priority,
+                                    TaskHandle_t* p_handle, BaseType_t core);
+TaskHandle_t xTaskCreateStatic (TaskFunction_t task_function,
+                                const char* p_name, uint32_t stack_depth,
+                                void* p_params, UBaseType_t priority,
+                                StackType_t* p_stack, StaticTask_t* p_task);
+TaskHandle_t xTaskCreateStaticPinnedToCore (TaskFunction_t task_function,
+                                            const char* p_name,
+                                            uint32_t stack_depth,
+                                            void* p_params,
+                                            UBaseType_t priority,
+                                            StackType_t* p_stack,
+                                            StaticTask_t* p_task,
+                                            BaseType_t core);
+void vTaskDelay (TickType_t ticks);
+void vTaskDelayUntil (TickType_t* p_previous_wake, TickType_t period);
+TaskHandle_t xTaskGetCurrentTaskHandle (void);
+TickType_t xTaskGetTickCount (void);
+
+// Direct-to-task notifications
+BaseType_t xTaskNotifyGive (TaskHandle_t task);
+void vTaskNotifyGiveFromISR (TaskHandle_t task, BaseType_t* p_woken);
+uint32_t ulTaskNotifyTake (BaseType_t clear_on_exit, TickType_t ticks_to_wait);
+
+/// What a notification does to the receiving task's notification value
+typedef enum
+{
+    eNoAction = 0,                          ///< Leave the value alone
+    eSetBits,                               ///< OR the given bits into it
+    eIncrement,                             ///< Add one to it
+    eSetValueWithOverwrite,                 ///< Replace it
+    eSetValueWithoutOverwrite               ///< Replace it if none is pending
+} eNotifyAction;
+
+BaseType_t xTaskNotify (TaskHandle_t task, uint32_t value,
+                        eNotifyAction action);
+BaseType_t xTaskNotifyFromISR (TaskHandle_t task, uint32_t value,
+                               eNotifyAction action, BaseType_t* p_woken);
+BaseType_t xTaskNotifyWait (uint32_t clear_on_entry, uint32_t clear_on_exit,
+                            uint32_t* p_value, TickType_t ticks_to_wait);
+
+/// There is no scheduler to invoke at the end of a simulated ISR
+#define portYIELD_FROM_ISR(woken)   ((void)(woken))
+
+// Interrupt context. There are no real interrupts on the host, but a thread
+// may declare that it is standing in for an ISR so that code which checks
+// xPortInIsrContext() takes its ISR path
+BaseType_t xPortInIsrContext (void);
+void vPortSetIsrContext (bool in_isr);
+
+/// Free heap in bytes; always zero on the host, which has no fixed heap
+size_t xPortGetFreeHeapSize (void);
+
+
+/** @brief   Host version of the ESP32's cross-core spinlock.
+ *  @details On the ESP32 a @c portMUX_TYPE critical section disables
+ *           interrupts on the calling core and spins on a lock shared with
+ *           the other core. Here it is just a spinlock which yields the CPU
+ *           while waiting, since a host thread holding it may be preempted.
+ */
+struct portMUX_TYPE
+{
+    std::atomic<bool> locked;               ///< @c true while the lock is held
+};
+
+/// Initialize a spinlock to its unlocked state
+#define portMUX_INITIALIZE(mux)     ((mux)->locked.store (false))
+
+/// Initializer for a spinlock which is a static or global variable
+#define portMUX_INITIALIZER_UNLOCKED    { false }
+
+/// Take a spinlock, waiting until it is free
+inline void vPortEnterCritical (portMUX_TYPE* mux)
+{
+    while (mux->locked.exchange (true, std::memory_order_acquire))
+    {
+        std::this_thread::yield ();
+    }
+}
+
+/// Release a spinlock taken with @c vPortEnterCritical()
+inline void vPortExitCritical (portMUX_TYPE* mux)
+{
+    mux->locked.store (false, std::memory_order_release);
+}
+
+#define portENTER_CRITICAL(mux)     vPortEnterCritical (mux)
+#define portEXIT_CRITICAL(mux)      vPortExitCritical (mux)
+#define portENTER_CRITICAL_ISR(mux) vPortEnterCritical (mux)
+#define portEXIT_CRITICAL_ISR(mux)  vPortExitCritical (mux)
+
+#endif // _FREERTOS_SHIM_H_
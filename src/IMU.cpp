@@ -8,6 +8,7 @@
  */
 #include <Arduino.h>
 #include "IMU.h"
+#include "fastmath.h"
 #include "PrintStream.h"
 
 /// @brief Constructor for LIS3MDL object, which operates with the magnetometer
@@ -220,8 +221,19 @@ uint8_t LIS3MDL::readRegister(byte Register)
 
 
 /// @brief Constructor for LSM6DSOX object, which handles the accelerometer and gyroscope sensors
-LSM6DSOX::LSM6DSOX(void)
+/// @details The gyro and accelerometer run at IMU_SAMPLE_RATE and are batched
+///          into the sensor's FIFO along with a timestamp every
+///          IMU_TIMESTAMP_DECIMATION samples, so that get_angle() can read
+///          many samples in one burst. If INT1 is wired to a GPIO, the FIFO
+///          watermark is routed to it and its interrupt wakes the task which
+///          created this object from wait_for_data().
+/// @param int1 GPIO pin wired to the sensor's INT1 pin, or -1 to poll
+LSM6DSOX::LSM6DSOX(int8_t int1)
+    // 17.50 mdps per count at 500 dps, 0.122 mg per count at 4 g
+    : fifo(0.0175f * FM_DEG_TO_RAD, 0.122e-3f * 9.80665f, IMU_SAMPLE_RATE)
 {
+    int1_pin = int1;
+
     // For initial setup for i2C communication, set up i2c using the Adafruit libraray method
     if (!imu.begin_I2C()) {
 
@@ -230,15 +242,90 @@ LSM6DSOX::LSM6DSOX(void)
         }
     }
 
-    // Set mode to start with continuous mode, which continuously collects data
-    Magno.setOperationMode(LIS3MDL_CONTINUOUSMODE);
-    // Collect data as fast as possible
-    Magno.setDataRate(LIS3MDL_DATARATE_1000_HZ);
+    // Fix the ranges, which set the FIFO decoder's scales, and the data rates
+    imu.setAccelRange(LSM6DS_ACCEL_RANGE_4_G);
+    imu.setGyroRange(LSM6DS_GYRO_RANGE_500_DPS);
+    imu.setAccelDataRate(LSM6DS_RATE_208_HZ);
+    imu.setGyroDataRate(LSM6DS_RATE_208_HZ);
+
+    // Empty the FIFO by bypassing it, then batch gyro and accelerometer at
+    // 208 Hz (0b0101 each) in continuous mode (0b110), with a timestamp at
+    // every eighth batch (DEC_TS_BATCH 0b10) for the decoder to interpolate
+    writeRegister(_FIFO_CTRL4, 0x00);
+    writeRegister(_CTRL10_C, 0x20);
+    writeRegister(_FIFO_CTRL1, (2 * IMU_FIFO_WATERMARK) & 0xFF);
+    writeRegister(_FIFO_CTRL2, ((2 * IMU_FIFO_WATERMARK) >> 8) & 0x01);
+    writeRegister(_FIFO_CTRL3, 0x55);
+    writeRegister(_FIFO_CTRL4, 0x86);
+
+    // Raise INT1 while the FIFO is at or above its watermark (INT1_FIFO_TH)
+    if (int1_pin >= 0)
+    {
+        p_task = xTaskGetCurrentTaskHandle();
+        pinMode(int1_pin, INPUT);
+        attachInterruptArg(int1_pin, data_ready_ISR, this, RISING);
+        writeRegister(_INT1_CTRL, 0x08);
+    }
+
+    // The magnetometer is optional; without it yaw is the integrated gyro rate
+    have_mag = Magno.begin_I2C();
+    if (have_mag)
+    {
+        // Set mode to start with continuous mode, which continuously collects data
+        Magno.setOperationMode(LIS3MDL_CONTINUOUSMODE);
+        // Collect data as fast as possible
+        Magno.setDataRate(LIS3MDL_DATARATE_1000_HZ);
+    }
 
     Serial.println("LSM6DSOX Initialized");
 }
 
 
+/// @brief Interrupt service routine for the FIFO watermark on INT1
+/// @details The time is taken here, as close as possible to the moment the
+///          watermark was reached, and the waiting task is woken; if it has
+///          a higher priority than the interrupted task, it runs as soon as
+///          the ISR returns.
+/// @param p_imu Pointer to the LSM6DSOX object which attached the interrupt
+void IRAM_ATTR LSM6DSOX::data_ready_ISR(void* p_imu)
+{
+    LSM6DSOX* p_this = (LSM6DSOX*)p_imu;
+    BaseType_t woken = pdFALSE;
+
+    p_this->ready_us = micros();
+    vTaskNotifyGiveFromISR(p_this->p_task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+
+/// @brief Sleeps until the FIFO reaches its watermark
+/// @details INT1 stays high while the FIFO is at or above its watermark, and
+///          the interrupt is on the rising edge. If the line is already high,
+///          because samples arrived while the last batch was being read, this
+///          returns at once rather than waiting for an edge which won't come.
+///          The timeout only recovers from a missed interrupt. Without INT1
+///          wired, this just waits the timeout, so the task polls.
+/// @returns True if the watermark was reached, false on a timeout
+bool LSM6DSOX::wait_for_data(void)
+{
+    if (int1_pin < 0)
+    {
+        vTaskDelay(IMU_WAIT_TIMEOUT_MS / portTICK_PERIOD_MS);
+        return false;
+    }
+    if (digitalRead(int1_pin) == HIGH)
+    {
+        // Use the ISR's time if its edge is still pending, else the time now
+        if (ulTaskNotifyTake(pdTRUE, 0) == 0)
+        {
+            ready_us = micros();
+        }
+        return true;
+    }
+    return ulTaskNotifyTake(pdTRUE, IMU_WAIT_TIMEOUT_MS / portTICK_PERIOD_MS) > 0;
+}
+
+
 /// @brief Reads the data for gyroscope and accelerometer
 /// @param GYRO_X Reference parameter for Gyro X reading in rad/s
 /// @param GYRO_Y Reference parameter for Gyro Y reading in rad/s
@@ -264,71 +351,204 @@ void LSM6DSOX::read_data(float& GYRO_X, float& GYRO_Y,float& GYRO_Z,float& ACCEL
     GYRO_Y = gyro.gyro.y;
     GYRO_Z = gyro.gyro.z;
 
+    // units: C
+    Temperature = temp.temperature;
+}
+
+
+/// @brief Reads the die temperature
+/// @details Only the two temperature registers are read, rather than every
+///          sensor as read_data() does. The die runs a little warmer than the
+///          air around it, but close enough to correct the speed of sound.
+/// @returns The temperature (C), or the last one read if the sensor didn't
+///          answer, which is NAN if it never has
+float LSM6DSOX::read_temperature(void)
+{
+    uint8_t raw[2];
+    if (readRegisters(_OUT_TEMP_L, raw, sizeof(raw)))
+    {
+        // 256 counts per degree, zero at 25 C
+        Temperature = 25.0f + (int16_t)(raw[0] | (raw[1] << 8)) * (1.0f / 256);
+    }
+    return Temperature;
 }
 
 
-/// @brief Calculates the pitch, yaw, and roll from sensor data
-/// @param new_time Time at which the function is called using time.h
+/// @brief Writes to an LSM6DSOX register
+/// @param Register Register address to write to
+/// @param RegData Data to write to address
+void LSM6DSOX::writeRegister(byte Register, byte RegData)
+{
+    Wire.beginTransmission(_LSM6DSOXAddress);
+    Wire.write(Register);
+    Wire.write(RegData);
+    Wire.endTransmission();
+}
+
+
+/// @brief Reads consecutive LSM6DSOX registers in one I2C transfer
+/// @details The address counts up through the registers, except that reading
+///          past the last byte of a FIFO word rolls back to its tag, so any
+///          number of FIFO words can be read in one transfer.
+/// @param Register First register to read
+/// @param p_buffer Where to put the bytes read
+/// @param count Number of bytes to read, at most the 128 byte Wire buffer
+/// @returns True if all the bytes were read
+bool LSM6DSOX::readRegisters(byte Register, uint8_t* p_buffer, uint8_t count)
+{
+    Wire.beginTransmission(_LSM6DSOXAddress);
+    Wire.write(Register);
+    if (Wire.endTransmission(false) != 0)
+    {
+        return false;
+    }
+    if (Wire.requestFrom(_LSM6DSOXAddress, count) != count)
+    {
+        return false;
+    }
+    for (uint8_t idx = 0; idx < count; idx++)
+    {
+        p_buffer[idx] = Wire.read();
+    }
+    return true;
+}
+
+
+/// @brief Runs the filter on one sample from the FIFO
+/// @details The first sample only starts the filter at the attitude given by
+///          gravity and the magnetic field. After that, the time step is the
+///          difference of the samples' timestamps.
+/// @param sample The sample, with the time the sensor took it
+void LSM6DSOX::fuse(const ImuSample& sample)
+{
+    GyroX = sample.gx;
+    GyroY = sample.gy;
+    GyroZ = sample.gz;
+    AccelX = sample.ax;
+    AccelY = sample.ay;
+    AccelZ = sample.az;
+
+    if (!started)
+    {
+        fusion.init(AccelX, AccelY, AccelZ, MagX, MagY, MagZ);
+        started = true;
+    }
+    else
+    {
+        // Unsigned subtraction is correct across the 71 minute wrap of micros()
+        float dt = (uint32_t)(sample.time_us - last_us) * 1e-6f;
+        fusion.update(GyroX, GyroY, GyroZ, AccelX, AccelY, AccelZ,
+                      MagX, MagY, MagZ, dt);
+    }
+    last_us = sample.time_us;
+
+    // The accelerometer reads gravity's reaction as well as the glider's motion
+    vertical_sum += fusion.get_vertical(AccelX, AccelY, AccelZ) - IMU_GRAVITY;
+}
+
+
+/// @brief Fuses the samples waiting in the FIFO and calculates the pitch, yaw, and roll
+/// @details The FIFO level, its overrun flag and the sensor's timestamp
+///          counter are read in one transfer, then the FIFO is drained in
+///          bursts of up to IMU_FIFO_BURST_WORDS words. Every sample is run
+///          through the attitude filter in order, at the time the sensor took
+///          it, with the magnetometer read once for the batch, and the
+///          upward acceleration of the samples is averaged. Pitch is
+///          positive with the accelerometer's X axis up and roll with its Y
+///          axis up. After an overrun the samples up to the next timestamp
+///          word are dropped, since how many were lost before them is not
+///          known.
+/// @param time_us Reference parameter for the time of the newest sample, on the micros() clock (us)
 /// @param pitch_in Reference parameter to pitch
 /// @param yaw_in Reference parameter to yaw
 /// @param roll_in Reference parameter for roll_in
-void LSM6DSOX::get_angle(float new_time, float& pitch_in, float& yaw_in, float& roll_in)
+/// @returns The number of samples fused; if zero, the outputs are unchanged
+uint8_t LSM6DSOX::get_angle(uint32_t& time_us, float& pitch_in, float& yaw_in, float& roll_in)
 {
-    // Read magnetometer data
-    sensors_event_t event; 
-    Magno.getEvent(&event);
-    MAGX = event.magnetic.x;
-    MAGY = event.magnetic.y;
-    MAGZ = event.magnetic.z;
-
-
-    // https://www.analog.com/en/app-notes/an-1057.html
-    float theta, psi, phi;
-    //
-    if(last_time == 0)
+    // FIFO_STATUS1 and 2, four reserved bytes, then TIMESTAMP0 to 3; the
+    // timestamp is read last, so the time just after the transfer matches it
+    uint8_t status[10];
+    if (!readRegisters(_FIFO_STATUS1, status, sizeof(status)))
     {
-        last_time = new_time;
+        return 0;
     }
-    else
+    uint32_t now_us = micros();
+    uint16_t words = (status[1] & 0x03) << 8 | status[0];
+    fifo.begin_batch(now_us, (uint32_t)status[9] << 24 | (uint32_t)status[8] << 16
+                             | (uint32_t)status[7] << 8 | status[6]);
+    if (status[1] & 0x40)
+    {
+        overruns++;
+        fifo.overrun();
+    }
+
+    // Read magnetometer data, or leave it zero so the filter ignores it
+    if (have_mag)
     {
-        // used to find change in time to use in integrating gyroscope
-        float dt = difftime(new_time, last_time);
-        
-        // read data values for gyro and accelerometer
-        read_data(GyroX, GyroY, GyroZ, AccelX, AccelY, AccelZ);
-
-        // calculate phi and psi for pitch and roll
-        // phi is used to determine pitch
-        // psi is used to determine roll
-        phi = atan2(AccelX,(sqrt(AccelY*AccelY + AccelZ*AccelZ)));
-        psi = atan2(AccelY,(sqrt(AccelX*AccelX + AccelZ*AccelZ)));
-        
-
-        // Calculate pitch and roll
-        // Equations for both integration of gyroscope with accelerometer
-        // and equations that do not use gyroscope
-
-        // equations with gyro integration
-        // pitch_in = 0.98*(pitch + GyroX*dt) + 0.02*phi - pitch_offset; 
-        // roll_in = 0.98*(roll + GyroY*dt) + 0.02*psi - roll_offset;   
-
-        // equations without gyro integration   
-        pitch_in = round((0.00*(pitch + GyroX*dt) + 1.00*phi - pitch_offset) * 180/M_PI) * M_PI/180;
-        roll_in = round((0.00*(roll + GyroY*dt) + 1.00*psi - roll_offset) * 180/M_PI) * M_PI/180;
-
-        // Calculates new Magnetometer angles with tilt compensations
-        nMAGX = MAGX*cos(pitch) + MAGZ*sin(pitch);
-        nMAGY = MAGX*sin(roll) * sin(pitch) + MAGZ*sin(roll)*cos(pitch);
-        
-        // calculates yaw using new magnetometer readings
-        yaw_in = atan2(-nMAGY,nMAGX) - yaw_offset;
-
-        // sets pitch, roll, and yaw to be stored for future use
-        pitch = pitch_in;
-        roll = roll_in;
-        yaw = yaw_in;
+        sensors_event_t event;
+        Magno.getEvent(&event);
+        MagX = event.magnetic.x;
+        MagY = event.magnetic.y;
+        MagZ = event.magnetic.z;
     }
-    last_time = new_time;
+
+    uint8_t samples = 0;
+    vertical_sum = 0;
+    uint8_t burst[IMU_FIFO_BURST_WORDS * IMU_FIFO_WORD_SIZE];
+    while (words > 0)
+    {
+        uint8_t count = (words < IMU_FIFO_BURST_WORDS) ? words : IMU_FIFO_BURST_WORDS;
+        if (!readRegisters(_FIFO_DATA_OUT_TAG, burst, count * IMU_FIFO_WORD_SIZE))
+        {
+            break;
+        }
+        for (uint8_t word = 0; word < count; word++)
+        {
+            if (fifo.decode(burst + word * IMU_FIFO_WORD_SIZE))
+            {
+                fuse(fifo.sample());
+                samples++;
+            }
+        }
+        words -= count;
+    }
+    if (samples == 0)
+    {
+        return 0;
+    }
+    vertical_accel = vertical_sum / samples;
+
+    // The filter's pitch is positive nose down about the sensor's Y axis
+    pitch = -fusion.get_pitch();
+    roll = fusion.get_roll();
+    yaw = fusion.get_yaw();
+
+    time_us = last_us;
+    pitch_in = pitch - pitch_offset;
+    roll_in = roll - roll_offset;
+    yaw_in = yaw - yaw_offset;
+    if (yaw_in > FM_PI)
+    {
+        yaw_in -= FM_2_PI;
+    }
+    else if (yaw_in < -FM_PI)
+    {
+        yaw_in += FM_2_PI;
+    }
+    return samples;
+}
+
+
+/// @brief Returns the gyro rates of the newest sample fused by get_angle
+/// @param pitch_rate Reference parameter for pitch rate in rad/s
+/// @param yaw_rate Reference parameter for yaw rate in rad/s
+/// @param roll_rate Reference parameter for roll rate in rad/s
+void LSM6DSOX::get_rates(float& pitch_rate, float& yaw_rate, float& roll_rate)
+{
+    // Signs and axes match the angles from get_angle when near level
+    pitch_rate = -GyroY;
+    roll_rate = GyroX;
+    yaw_rate = GyroZ;
 }
 
 
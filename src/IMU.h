@@ -15,7 +15,24 @@
 #include "PrintStream.h"
 #include <Adafruit_LSM6DSOX.h>
 #include <Adafruit_LIS3MDL.h>
-#include <time.h>
+#include "mahony.h"
+#include "ekf.h"
+#include "imufifo.h"
+
+/// Output data rate of the gyro and accelerometer, and the FIFO's batch rate (Hz)
+#define IMU_SAMPLE_RATE 208
+
+/// Samples in the FIFO at which the watermark is reached; about 19 ms at 208 Hz
+#define IMU_FIFO_WATERMARK 4
+
+/// FIFO words read in one I2C transfer, which must fit the 128 byte Wire buffer
+#define IMU_FIFO_BURST_WORDS 18
+
+/// Longest wait for the watermark interrupt, about twice the time to reach it (ms)
+#define IMU_WAIT_TIMEOUT_MS 40
+
+/// Standard gravity, which the accelerometer reads at rest (m/s^2)
+#define IMU_GRAVITY 9.80665f
 
 /// @brief Class to interface with the LIS3MDL magnetometer
 class LIS3MDL
@@ -72,35 +89,88 @@ public:
 class LSM6DSOX
 {
 private:
+    uint8_t _LSM6DSOXAddress = 0x6A;                        ///< I2C address, as used by the Adafruit library
+
+    // Register addresses
+    const byte _FIFO_CTRL1 = 0x07;                          ///< "FIFO_CTRL1" address, watermark bits 7:0
+    const byte _FIFO_CTRL2 = 0x08;                          ///< "FIFO_CTRL2" address, watermark bit 8
+    const byte _FIFO_CTRL3 = 0x09;                          ///< "FIFO_CTRL3" address, gyro and accelerometer batch rates
+    const byte _FIFO_CTRL4 = 0x0A;                          ///< "FIFO_CTRL4" address, timestamp batching and FIFO mode
+    const byte _INT1_CTRL = 0x0D;                           ///< "INT1_CTRL" address, signals routed to INT1
+    const byte _CTRL10_C = 0x19;                            ///< "CTRL10_C" address, timestamp enable
+    const byte _OUT_TEMP_L = 0x20;                          ///< "OUT_TEMP_L" address, first of the die temperature
+    const byte _FIFO_STATUS1 = 0x3A;                        ///< "FIFO_STATUS1" address, first of FIFO status and timestamp
+    const byte _FIFO_DATA_OUT_TAG = 0x78;                   ///< "FIFO_DATA_OUT_TAG" address, first byte of each FIFO word
+
     Adafruit_LSM6DSOX imu;                                  ///< Create object to use Adafruit libraries
     Adafruit_LIS3MDL Magno;                                 ///< Create object to use Adafruit libraries
-    float GyroX, GyroY, GyroZ, AccelX, AccelY, AccelZ;      ///< Initializing variables to get gyro and accel data
+    float GyroX = 0, GyroY = 0, GyroZ = 0;                  ///< Gyro data from the last read (rad/s)
+    float AccelX, AccelY, AccelZ;                           ///< Accelerometer data from the last read (m/s^2)
+    float MagX = 0, MagY = 0, MagZ = 0;                     ///< Magnetometer data from the last read (uT)
+    float Temperature = NAN;                                ///< Die temperature from the last read (C), NAN until one succeeds
+    float vertical_sum = 0;                                 ///< Sum of the upward accelerations of the batch so far (m/s^2)
+    float vertical_accel = 0;                               ///< Mean upward acceleration of the last batch, less gravity (m/s^2)
     float pitch = 0;                                        ///< Initial value for pitch
     float yaw = 0;                                          ///< Initial value for yaw
     float roll = 0;                                         ///< Initial value for roll
-    float last_time = 0;
-    int16_t MAGX, MAGY, MAGZ;                               ///< Initialize for raw MAG X, Y, and Z data
-    int16_t nMAGX, nMAGY, nMAGZ;                            ///< Initialize for tilt compensated MAG X, Y, and Z data
+    bool have_mag = false;                                  ///< True if the magnetometer answered at startup
+    bool started = false;                                   ///< True once the filter has its first reading
+    uint32_t last_us = 0;                                   ///< Time of the previous reading (us)
+#ifdef IMU_EKF
+    AttitudeEKF fusion;                                     ///< Kalman filter fusing gyro, accelerometer and magnetometer
+#else
+    MahonyFilter fusion;                                    ///< Filter fusing gyro, accelerometer and magnetometer
+#endif
+    ImuFifoDecoder fifo;                                    ///< Decoder turning FIFO words into timestamped samples
+    uint32_t overruns = 0;                                  ///< Times the FIFO filled up and lost samples
+    int8_t int1_pin;                                        ///< GPIO wired to INT1, or -1 if none
+    TaskHandle_t p_task = NULL;                             ///< Task which waits for the interrupt
+    volatile uint32_t ready_us = 0;                         ///< micros() when the watermark was last reached
 
     float yaw_offset = 0;                                   ///< Initial value for yaw offset
     float roll_offset = 0;                                  ///< Initial value for roll offset
     float pitch_offset= 0;                                  ///< Initial value for pitch offset
-    
+
+    void writeRegister(byte Register, byte RegData);                        ///< Header function to write to a register
+    bool readRegisters(byte Register, uint8_t* p_buffer, uint8_t count);    ///< Header function to burst read registers
+    void fuse(const ImuSample& sample);                                     ///< Header function to run the filter on one sample
+    static void data_ready_ISR(void* p_imu);                                ///< Header function for the INT1 interrupt
 
 
 public:
     /// @brief Header function for LSM6DSOX to initialize object  
-    LSM6DSOX(void);
+    LSM6DSOX(int8_t int1 = -1);
+
+    /// @brief Header function to sleep until the FIFO reaches its watermark
+    bool wait_for_data(void);
+
+    /// @brief Returns the micros() time at which the watermark was last reached
+    uint32_t get_ready_us(void) { return ready_us; }
 
     /// @brief Header function to read gyro and accelerometer data
     void read_data(float& GYRO_X, float& GYRO_Y,float& GYRO_Z,float& ACCEL_X, 
                     float& ACCEL_Y,float& ACCEL_Z);
 
-    /// @brief Header function to get pitch, yaw, and roll data
-    void get_angle(float time, float& pitch, float& yaw, float& roll);
+    /// @brief Header function to read the die temperature
+    float read_temperature(void);
+
+    /// @brief Returns the die temperature from the last read
+    float get_temperature(void) { return Temperature; }
+
+    /// @brief Header function to fuse the samples waiting in the FIFO and get pitch, yaw, and roll data
+    uint8_t get_angle(uint32_t& time_us, float& pitch, float& yaw, float& roll);
+
+    /// @brief Header function to get the gyro rates used by the last call to get_angle
+    void get_rates(float& pitch_rate, float& yaw_rate, float& roll_rate);
+
+    /// @brief Returns the mean upward acceleration, less gravity, of the samples fused by the last call to get_angle
+    float get_vertical_accel(void) { return vertical_accel; }
 
     /// @brief Header function to zero yaw 
     void zero(void);
+
+    /// @brief Returns the number of times the FIFO filled up and lost samples
+    uint32_t get_overruns(void) { return overruns; }
 };
 
 #endif //_IMU_H_
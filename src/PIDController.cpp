@@ -14,9 +14,10 @@
  *  @param Kp_in Proprotional gain
  *  @param Ki_in Integral gain
  *  @param Kd_in Derivative gain
- *  @param dt_in Interval at which the controller is run
+ *  @param dt_in Interval at which the controller is run (s)
  */
 PIDController::PIDController(float Kp_in, float Ki_in, float Kd_in, float dt_in) 
+    : jitter(dt_in * 1e6f)
 {
     Kp = Kp_in;
     Ki = Ki_in;
@@ -25,6 +26,7 @@ PIDController::PIDController(float Kp_in, float Ki_in, float Kd_in, float dt_in)
 
     errIntegral = 0;      // Reset integral of error
     errPrev = 0;          // Reset error at previous time
+    timePrev = -1;        // No timestamped sample yet
 }
 
 
@@ -42,6 +44,8 @@ void PIDController::setGains(float Kp_in, float Ki_in, float Kd_in)
 
 
 /** @brief Calculate PID control output at current time
+ *  @details This version assumes that exactly @c dt has passed since the
+ *           previous call.
  *  @param posCurrent The current value or position that is being measured
  *  @param posDesired The desired value or position that the actuator should be at
  *  @returns The controller output
@@ -50,10 +54,57 @@ float PIDController::getCtrlOutput(float posCurrent, float posDesired)
 {
     // Calculate error
     float err = posDesired - posCurrent;
+
+    return runStep(err, dt);
+}
+
+
+/** @brief Calculate PID control output using the measured sample interval
+ *  @details The integral and derivative use the time since the previous
+ *           timestamped call instead of @c dt, so they stay correct when the
+ *           task runs late or the loop rate is changed. Each interval is also
+ *           recorded in the jitter histogram. The first call uses @c dt.
+ *  @param posCurrent The current value or position that is being measured
+ *  @param posDesired The desired value or position that the actuator should be at
+ *  @param time_us When @c posCurrent was measured, from @c esp_timer_get_time()
+ *  @returns The controller output
+ */
+float PIDController::getCtrlOutput(float posCurrent, float posDesired, int64_t time_us) 
+{
+    float interval = dt;
+
+    if (timePrev >= 0)
+    {
+        int64_t elapsed = time_us - timePrev;
+
+        // A repeated or backwards timestamp would divide by zero and land in
+        // the histogram's top bin; use dt and leave it out
+        if (elapsed > 0)
+        {
+            jitter.record((uint32_t)elapsed);
+            interval = elapsed * 1e-6f;
+        }
+    }
+    timePrev = time_us;
+
+    // Calculate error
+    float err = posDesired - posCurrent;
+
+    return runStep(err, interval);
+}
+
+
+/** @brief Update the integral and derivative over one interval
+ *  @param err The current error
+ *  @param interval The time since the previous sample (s)
+ *  @returns The controller output
+ */
+float PIDController::runStep(float err, float interval)
+{
     // Update the integral error
-    errIntegral += err*dt;
+    errIntegral += err*interval;
     // Calculate the derivative error
-    float derr = (err - errPrev) / dt;
+    float derr = (err - errPrev) / interval;
     // Update previous error
     errPrev = err;
 
@@ -62,6 +113,3 @@ float PIDController::getCtrlOutput(float posCurrent, float posDesired)
            + Ki*errIntegral 
            + Kd*derr );
 }
-
-
-
@@ -10,6 +10,7 @@
 
 #include <Arduino.h>
 #include "taskshare.h"
+#include "jitter.h"
 
 /** @brief  Class for a proportional, intergral, and derivative (PID) controller
  */
@@ -21,16 +22,23 @@ protected:
     float Ki;               ///< Integral gain
     float Kd;               ///< Derivative gain
 
-    float dt;               ///< Sampling interval
+    float dt;               ///< Nominal sampling interval (s)
 
     float errIntegral;      ///< Integral of error
     float errPrev;          ///< Error at previous time
 
+    int64_t timePrev;       ///< Timestamp of the previous sample (us), or -1 if none
+    JitterHistogram jitter; ///< Measured intervals compared to dt
+
+    float runStep(float err, float interval);                       ///< Update the terms over one interval
+
 public:
     PIDController(float Kp, float Ki, float Kd, float dt);          ///< Constructor for PID Controller class
 
     void setGains(float Kp, float Ki, float Kd);                    ///< Method to set/update the controller gains
     float getCtrlOutput(float posCurrent, float posDesired);        ///< Method to run the controller, returns controller output
+    float getCtrlOutput(float posCurrent, float posDesired, int64_t time_us);   ///< Run the controller over the measured interval
+    JitterHistogram& getJitter(void) { return jitter; }             ///< Histogram of measured sample intervals
 };
 
 #endif // _CONTROLLER_H_
\ No newline at end of file
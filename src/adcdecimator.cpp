@@ -0,0 +1,63 @@
+/** @file adcdecimator.cpp
+ *  @brief This is the source file containing the constructor and methods for
+ *         a decimator of ADC conversions.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include "adcdecimator.h"
+
+/** @brief   Constructor which creates a decimator with no readings yet
+ */
+AdcDecimator::AdcDecimator(void)
+{
+    for (uint8_t channel = 0; channel < ADC_CHANNELS; channel++)
+    {
+        sum[channel] = 0;
+        lowest[channel] = 0;
+        highest[channel] = 0;
+        count[channel] = 0;
+        first_us[channel] = 0;
+        latest[channel] = {};
+    }
+}
+
+/** @brief   Adds one conversion to its channel's reading
+ *  @param   channel The ADC channel which was converted
+ *  @param   raw The result of the conversion (counts)
+ *  @param   time_us The time of the conversion, from micros() (us)
+ *  @returns True if the conversion completes a reading of the channel, which
+ *           is then given by @c reading()
+ */
+bool AdcDecimator::add(uint8_t channel, uint16_t raw, uint32_t time_us)
+{
+    if (channel >= ADC_CHANNELS)
+    {
+        return false;
+    }
+
+    if (count[channel] == 0)
+    {
+        sum[channel] = 0;
+        lowest[channel] = raw;
+        highest[channel] = raw;
+        first_us[channel] = time_us;
+    }
+    sum[channel] += raw;
+    lowest[channel] = (raw < lowest[channel]) ? raw : lowest[channel];
+    highest[channel] = (raw > highest[channel]) ? raw : highest[channel];
+    if (++count[channel] < ADC_OVERSAMPLE)
+    {
+        return false;
+    }
+
+    AdcReading& result = latest[channel];
+    result.counts = (float)(sum[channel] - lowest[channel] - highest[channel])
+                    * (1.0f / (ADC_OVERSAMPLE - 2));
+    result.time_us = first_us[channel] + (time_us - first_us[channel]) / 2;
+    result.sequence++;
+    count[channel] = 0;
+    return true;
+}
@@ -0,0 +1,64 @@
+/** @file adcdecimator.h
+ *  @brief The header file for a decimator which turns a fast stream of ADC
+ *         conversions into slower, oversampled readings of each channel.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// Compile this header file only once
+#ifndef _ADCDECIMATOR_H_
+#define _ADCDECIMATOR_H_
+
+#include <Arduino.h>
+
+/// Conversions of each channel which go into one reading
+#define ADC_OVERSAMPLE 16
+
+/// Channels of ADC1, numbered as in the conversion results
+#define ADC_CHANNELS 8
+
+/// One oversampled reading of one ADC channel
+struct AdcReading
+{
+    float counts;           ///< Mean of the conversions, with a fraction below one count
+    uint32_t time_us;       ///< Middle of the time the conversions span, from micros() (us)
+    uint32_t sequence;      ///< Number of readings of this channel, including this one
+};
+
+/** @brief  Class which averages ADC conversions into readings.
+ *  @details Conversions of several channels may come interleaved, in any
+ *           order. For each channel, every @c ADC_OVERSAMPLE conversions are
+ *           made into one reading. The highest and lowest of them are left
+ *           out and the rest averaged, so one wild conversion, as the ESP32's
+ *           ADC gives now and then, cannot move the reading much, and the
+ *           averaging of the rest cuts the noise by about the square root of
+ *           their number. The reading is stamped with the middle of the time
+ *           its conversions span, which is the time it best describes.
+ */
+class AdcDecimator
+{
+protected:
+    uint32_t sum[ADC_CHANNELS];         ///< Sum of the conversions so far in each channel's reading
+    uint16_t lowest[ADC_CHANNELS];      ///< Lowest of them
+    uint16_t highest[ADC_CHANNELS];     ///< Highest of them
+    uint8_t count[ADC_CHANNELS];        ///< Number of them
+    uint32_t first_us[ADC_CHANNELS];    ///< Time of the first of them (us)
+    AdcReading latest[ADC_CHANNELS];    ///< Latest complete reading of each channel
+
+public:
+    // Create a decimator with no readings yet
+    AdcDecimator(void);
+
+    // Add one conversion, returning true when it completes a reading
+    bool add(uint8_t channel, uint16_t raw, uint32_t time_us);
+
+    /** @brief   Returns the latest complete reading of a channel.
+     *  @param   channel The ADC channel
+     *  @returns A reference to the reading, whose sequence is zero if there
+     *           has not been one yet
+     */
+    const AdcReading& reading(uint8_t channel) { return latest[channel]; }
+};
+
+#endif // _ADCDECIMATOR_H_
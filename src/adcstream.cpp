@@ -0,0 +1,158 @@
+/** @file adcstream.cpp
+ *  @brief This is the source file containing the constructor and methods for
+ *         a continuously sampling ADC driver.
+ *  @details The driver is the ESP-IDF 4.4 "digital controller" (DMA) mode of
+ *           @c driver/adc.h, as used by the Arduino core for the ESP32.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include "adcstream.h"
+
+/** @brief   Constructor which creates a stream for some analog pins
+ *  @details Nothing is set up until @c begin() is called, so a stream may be
+ *           made before the scheduler starts.
+ *  @param   pin_list The GPIO pins to sample, which must be on ADC1
+ *  @param   count The number of pins, at most @c ADC_MAX_PINS
+ */
+AdcStream::AdcStream(const uint8_t* pin_list, uint8_t count)
+{
+    num_pins = (count < ADC_MAX_PINS) ? count : ADC_MAX_PINS;
+    for (uint8_t index = 0; index < num_pins; index++)
+    {
+        pins[index] = pin_list[index];
+        channels[index] = digitalPinToAnalogChannel(pin_list[index]);
+    }
+    running = false;
+    for (uint8_t channel = 0; channel < ADC_CHANNELS; channel++)
+    {
+        published[channel] = {};
+    }
+    portMUX_INITIALIZE(&mux);
+    frames = 0;
+    overruns = 0;
+}
+
+/** @brief   Sets up the ADC and DMA and starts converting
+ *  @details Each frame holds @c ADC_OVERSAMPLE conversions of every pin,
+ *           so it completes one reading of each. The DMA buffer holds four
+ *           frames, so the owning task may be held off for a few frames
+ *           without losing any. The attenuation is 11 dB, for the full
+ *           3.3 V swing of a potentiometer, as @c analogRead() uses.
+ *  @returns True if the driver started, false if it failed
+ */
+bool AdcStream::begin(void)
+{
+    const uint32_t frame_bytes = ADC_OVERSAMPLE * num_pins * ADC_RESULT_BYTES;
+
+    adc_digi_init_config_t init_config = {};
+    init_config.max_store_buf_size = 4 * frame_bytes;
+    init_config.conv_num_each_intr = frame_bytes;
+    for (uint8_t index = 0; index < num_pins; index++)
+    {
+        init_config.adc1_chan_mask |= 1 << channels[index];
+    }
+    if (adc_digi_initialize(&init_config) != ESP_OK)
+    {
+        return false;
+    }
+
+    adc_digi_pattern_config_t pattern[ADC_MAX_PINS] = {};
+    for (uint8_t index = 0; index < num_pins; index++)
+    {
+        pattern[index].atten = ADC_ATTEN_DB_11;
+        pattern[index].channel = channels[index];
+        pattern[index].unit = 0;                    // ADC1
+        pattern[index].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = true;
+    config.conv_limit_num = 250;
+    config.pattern_num = num_pins;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = ADC_SAMPLE_RATE;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    if (adc_digi_controller_configure(&config) != ESP_OK
+        || adc_digi_start() != ESP_OK)
+    {
+        adc_digi_deinitialize();
+        return false;
+    }
+    running = true;
+    return true;
+}
+
+/** @brief   Reads frames from the DMA and makes readings, forever
+ *  @details The time of each conversion is worked back from the time the
+ *           frame was read, one conversion period for each result after it.
+ *           The frame may have waited a little in the buffer, so the times
+ *           are a little late, but never early. If the buffer filled up
+ *           while the task was held off, the driver reports it and the
+ *           conversions which fit are still used.
+ */
+void AdcStream::run(void)
+{
+    const uint32_t frame_bytes = ADC_OVERSAMPLE * num_pins * ADC_RESULT_BYTES;
+    const float conversion_us = 1e6f / ADC_SAMPLE_RATE;
+    uint8_t buffer[ADC_OVERSAMPLE * ADC_MAX_PINS * ADC_RESULT_BYTES];
+
+    while (true)
+    {
+        uint32_t length = 0;
+        esp_err_t result = adc_digi_read_bytes(buffer, frame_bytes, &length,
+                                               ADC_MAX_DELAY);
+        uint32_t now_us = micros();
+        if (result == ESP_ERR_INVALID_STATE)
+        {
+            overruns++;
+        }
+        else if (result != ESP_OK)
+        {
+            continue;
+        }
+        frames++;
+
+        uint32_t results = length / ADC_RESULT_BYTES;
+        for (uint32_t index = 0; index < results; index++)
+        {
+            adc_digi_output_data_t* p_result =
+                (adc_digi_output_data_t*)(buffer + index * ADC_RESULT_BYTES);
+            uint8_t channel = p_result->type1.channel;
+            uint32_t time_us = now_us - (uint32_t)((results - 1 - index) * conversion_us);
+            if (decimator.add(channel, p_result->type1.data, time_us))
+            {
+                portENTER_CRITICAL(&mux);
+                published[channel] = decimator.reading(channel);
+                portEXIT_CRITICAL(&mux);
+            }
+        }
+    }
+}
+
+/** @brief   Copies the latest reading of a pin
+ *  @details This never waits for a conversion; the reading is at most one
+ *           frame old, plus however long the owning task was held off.
+ *  @param   pin The GPIO pin, which must be one of those given to the
+ *           constructor
+ *  @param   reading Set to the latest reading of the pin
+ *  @returns True if there was a reading, false if the pin is not sampled or
+ *           no frame has arrived yet
+ */
+bool AdcStream::get(uint8_t pin, AdcReading& reading)
+{
+    for (uint8_t index = 0; index < num_pins; index++)
+    {
+        if (pins[index] == pin)
+        {
+            portENTER_CRITICAL(&mux);
+            reading = published[channels[index]];
+            portEXIT_CRITICAL(&mux);
+            return reading.sequence != 0;
+        }
+    }
+    return false;
+}
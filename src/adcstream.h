@@ -0,0 +1,73 @@
+/** @file adcstream.h
+ *  @brief The header file for a driver which samples analog pins
+ *         continuously with the ESP32's ADC and DMA.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// Compile this header file only once
+#ifndef _ADCSTREAM_H_
+#define _ADCSTREAM_H_
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include "adcdecimator.h"
+
+/// Conversions per second, taken in turn from each pin (Hz)
+#define ADC_SAMPLE_RATE 20000
+
+/// Most pins which one stream may sample
+#define ADC_MAX_PINS 4
+
+/// Bytes in one conversion result as the DMA delivers it
+#define ADC_RESULT_BYTES 2
+
+/** @brief  Class which samples up to @c ADC_MAX_PINS analog pins in the
+ *          background and keeps an oversampled reading of each.
+ *  @details The ADC's digital controller converts the pins in turn at
+ *           @c ADC_SAMPLE_RATE, and the DMA fills a buffer with the results
+ *           without any help from the CPU. The task which owns the stream
+ *           sleeps in @c run() until a frame of @c ADC_OVERSAMPLE conversions
+ *           of every pin has arrived, then averages them into one reading
+ *           per pin. Any other task can take the latest reading of a pin
+ *           with @c get(), which only copies it and never waits.
+ *
+ *           Only pins on ADC1 can be used, as ADC2 is taken by the WiFi
+ *           radio. On the ESP32 the digital controller works through I2S0,
+ *           which must then be left alone.
+ */
+class AdcStream
+{
+protected:
+    uint8_t pins[ADC_MAX_PINS];         ///< The GPIO pins sampled
+    uint8_t channels[ADC_MAX_PINS];     ///< Their ADC1 channels
+    uint8_t num_pins;                   ///< Number of pins sampled
+    bool running;                       ///< True once the conversions have started
+    AdcDecimator decimator;             ///< Averages the conversions into readings
+    AdcReading published[ADC_CHANNELS]; ///< Latest reading of each channel, for get()
+    portMUX_TYPE mux;                   ///< Lock for the published readings
+    uint32_t frames;                    ///< Frames read from the DMA
+    uint32_t overruns;                  ///< Times the DMA buffer filled and lost conversions
+
+public:
+    // Create a stream which will sample the given pins
+    AdcStream(const uint8_t* pin_list, uint8_t count);
+
+    // Set up the ADC and DMA and start converting
+    bool begin(void);
+
+    // Read frames from the DMA and make readings, forever
+    void run(void);
+
+    // Copy the latest reading of a pin, returning false if there is none yet
+    bool get(uint8_t pin, AdcReading& reading);
+
+    // Return true once the conversions have started
+    bool is_running(void) { return running; }
+
+    // Return the number of times conversions were lost
+    uint32_t get_overruns(void) { return overruns; }
+};
+
+#endif // _ADCSTREAM_H_
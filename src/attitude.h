@@ -0,0 +1,33 @@
+/** @file attitude.h
+ *  @brief Snapshot of the glider's attitude which is published by the IMU
+ *         task and read by the controller in one operation.
+ *
+ *  @author ME 507 Airheads
+ *  @date 2026-Oct-16 Original file
+ */
+
+#ifndef _ATTITUDE_H_
+#define _ATTITUDE_H_
+
+#include <Arduino.h>
+
+/** @brief  One attitude sample from the IMU.
+ *  @details All the fields are written together into a @c FastShare<Attitude>
+ *           so that a reader never mixes angles from different IMU updates.
+ *           The sequence number goes up by one for each new sample, so a
+ *           reader which sees the same sequence number twice knows that it
+ *           has not received a new sample since its last read.
+ */
+struct Attitude
+{
+    float pitch;            ///< Pitch angle (deg)
+    float roll;             ///< Roll angle (deg)
+    float yaw;              ///< Yaw angle (deg)
+    float pitch_rate;       ///< Pitch rate (deg/s)
+    float roll_rate;        ///< Roll rate (deg/s)
+    float yaw_rate;         ///< Yaw rate (deg/s)
+    uint32_t time_us;       ///< Time at which the sample was taken, from micros() (us)
+    uint32_t sequence;      ///< Number of samples published, including this one
+};
+
+#endif // _ATTITUDE_H_
@@ -11,6 +11,7 @@
  *
  *  @date 2014-Oct-18 JRR Created file
  *  @date 2020-Oct-19 JRR Modified for use with Arduino/FreeRTOS platform
+ *  @date 2026-Oct-16 Added subscriptions and lookup of items by name
  *
  *  License:
  *    This file is copyright 2014 - 2020 by JR Ridgely and released under the
@@ -35,6 +36,9 @@
 // Set pointer to most recently created shared data item to initially be NULL
 BaseShare* BaseShare::p_newest = NULL;
 
+// Spinlock which keeps tasks subscribing at the same time from colliding
+static portMUX_TYPE subscribe_lock = portMUX_INITIALIZER_UNLOCKED;
+
 
 /** @brief   Construct a base shared data item.
  *  @details This default constructor saves the name of the shared data item. 
@@ -44,6 +48,7 @@ BaseShare* BaseShare::p_newest = NULL;
  *  @param   p_name The name for the shared data item, in a character string
  */
 BaseShare::BaseShare (const char* p_name)
+    : num_subscribers (0)
 {
     // Allocate some memory and save the share's name; trim it to 12 characters
     if (p_name != NULL)
@@ -51,6 +56,7 @@ BaseShare::BaseShare (const char* p_name)
         uint8_t namelength = strlen (p_name);
         namelength = (namelength <= 15) ? namelength : 15;
         strncpy (name, p_name, namelength);
+        name[namelength] = '\0';
     }
     else
     {
@@ -63,6 +69,92 @@ BaseShare::BaseShare (const char* p_name)
 }
 
 
+/** @brief   Ask for a task to be notified whenever this item is written.
+ *  @details Each time the item is written, @c bits are ORed into the task's
+ *           notification value with @c xTaskNotify(). A task which follows
+ *           several items should give each a different bit so it can tell,
+ *           after @c xTaskNotifyWait() returns, which ones were written.
+ *  @param   bits The bits to set in the task's notification value
+ *  @param   task The task to be notified (default @c NULL, the calling task)
+ *  @returns @c true if the task was subscribed, or @c false if the item
+ *           already has @c SHARE_MAX_SUBSCRIBERS subscribers
+ */
+bool BaseShare::subscribe (uint32_t bits, TaskHandle_t task)
+{
+    if (task == NULL)
+    {
+        task = xTaskGetCurrentTaskHandle ();
+    }
+
+    bool added = false;
+    portENTER_CRITICAL (&subscribe_lock);
+    uint8_t count = num_subscribers.load (std::memory_order_relaxed);
+    if (count < SHARE_MAX_SUBSCRIBERS)
+    {
+        // Fill in the entry before publishers can see it
+        subscribers[count].task = task;
+        subscribers[count].bits = bits;
+        num_subscribers.store (count + 1, std::memory_order_release);
+        added = true;
+    }
+    portEXIT_CRITICAL (&subscribe_lock);
+
+    return added;
+}
+
+
+/** @brief   Notify every subscriber that this item has been written.
+ *  @details This method is called by @c publish() only when there is at
+ *           least one subscriber.
+ *  @param   count The number of subscribers, already loaded by the caller
+ */
+void BaseShare::notify_subscribers (uint8_t count)
+{
+    for (uint8_t index = 0; index < count; index++)
+    {
+        xTaskNotify (subscribers[index].task, subscribers[index].bits,
+                     eSetBits);
+    }
+}
+
+
+/** @brief   Notify every subscriber, from within an ISR, that this item has
+ *           been written.
+ *  @param   count The number of subscribers, already loaded by the caller
+ */
+void BaseShare::ISR_notify_subscribers (uint8_t count)
+{
+    BaseType_t higher_priority_woken = pdFALSE;
+
+    for (uint8_t index = 0; index < count; index++)
+    {
+        xTaskNotifyFromISR (subscribers[index].task, subscribers[index].bits,
+                            eSetBits, &higher_priority_woken);
+    }
+    portYIELD_FROM_ISR (higher_priority_woken);
+}
+
+
+/** @brief   Find a shared data item by its name.
+ *  @details The linked list of all shared data items is searched for one whose
+ *           name, as trimmed to 15 characters by the constructor, matches.
+ *  @param   p_name The name of the item to be found
+ *  @returns A pointer to the item, or @c NULL if there is no such item
+ */
+BaseShare* BaseShare::find (const char* p_name)
+{
+    for (BaseShare* p_share = p_newest; p_share != NULL;
+         p_share = p_share->p_next)
+    {
+        if (strncmp (p_share->name, p_name, sizeof (p_share->name) - 1) == 0)
+        {
+            return p_share;
+        }
+    }
+    return NULL;
+}
+
+
 /** @brief   Start the printout showing the status of all shared data items.
  *  @details This method begins printing out the status of all items in the 
  *           system's linked list of shared data items (queues, task shares, 
@@ -73,8 +165,68 @@ BaseShare::BaseShare (const char* p_name)
  */
 void print_all_shares (Print& printer)
 {
+#ifdef SHARE_STATS
+    printer.println ("Share/Queue     Type    Max. Full    Puts/Gets, Age, Max. Age, Wait");
+    printer.println ("-----------     ----    ---------    ----------------------------");
+#else
     printer.println ("Share/Queue     Type    Max. Full");
     printer.println ("-----------     ----    ---------");
+#endif
 
     BaseShare::p_newest->print_in_list (printer);
-}
\ No newline at end of file
+}
+
+
+#ifdef SHARE_STATS
+/** @brief   Print this item's usage statistics.
+ *  @details This method is called by the descendent classes' 
+ *           @c print_in_list() methods to put the statistics at the end of
+ *           each line of the list, before the line is ended.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void BaseShare::print_stats (Print& printer)
+{
+    uint32_t puts = stats.puts.load ();
+    uint32_t since_put = micros () - stats.last_put_us.load ();
+
+    printer.printf ("\t%u/%u, ", (unsigned)puts, (unsigned)stats.gets.load ());
+    if (puts == 0)
+    {
+        printer.print ("never");
+    }
+    else
+    {
+        printer.printf ("%uus", (unsigned)since_put);
+    }
+    printer.printf (", %uus, %uus", (unsigned)stats.max_age_us.load (),
+                    (unsigned)stats.wait_us.load ());
+}
+
+
+/** @brief   Print the statistics of all shared data items in a form which is
+ *           easy for a program to read.
+ *  @details One line of comma-separated values is printed for each share or
+ *           queue, after a header line which names the columns. Times are in
+ *           microseconds; @c since_put_us is -1 for an item which has never
+ *           been written.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void dump_all_shares (Print& printer)
+{
+    printer.println ("name,puts,gets,since_put_us,max_age_us,wait_us");
+
+    for (BaseShare* p_share = BaseShare::p_newest; p_share != NULL;
+         p_share = p_share->p_next)
+    {
+        const ShareStats& stats = p_share->stats;
+        uint32_t puts = stats.puts.load ();
+        long since_put = (puts == 0) 
+                         ? -1L : (long)(micros () - stats.last_put_us.load ());
+
+        printer.printf ("%s,%u,%u,%ld,%u,%u\r\n", p_share->name,
+                        (unsigned)puts, (unsigned)stats.gets.load (), since_put,
+                        (unsigned)stats.max_age_us.load (), 
+                        (unsigned)stats.wait_us.load ());
+    }
+}
+#endif // SHARE_STATS
\ No newline at end of file
@@ -11,6 +11,8 @@
  *
  *  @date 2014-Oct-18 JRR Created file
  *  @date 2020-Oct-19 JRR Modified for use with Arduino/FreeRTOS platform
+ *  @date 2026-Oct-16 Added subscriptions, so tasks can be woken when an item
+ *                    is written, and lookup of items by name
  *
  *  License:
  *    This file is copyright 2014 - 2020 by JR Ridgely and released under the
@@ -34,6 +36,7 @@
 #define _BASESHARE_H_
 
 #include <Arduino.h>
+#include <atomic>
 
 // Different functions are used in STM32's and ESP32's to determine if the CPU
 // is currently running within an interrupt service routine
@@ -41,15 +44,105 @@
     #define CHECK_IF_IN_ISR() xPortInIsrContext()
 #elif (defined STM32F4xx || defined STM32L4xx)
     #define CHECK_IF_IN_ISR() xPortIsInsideInterrupt()
+#elif (defined NATIVE)
+    #define CHECK_IF_IN_ISR() xPortInIsrContext()
 #endif
 
 
+#ifdef SHARE_STATS
+/** @brief   Usage statistics kept by each shared data item.
+ *  @details When the program is compiled with @c SHARE_STATS defined (add
+ *           @c -DSHARE_STATS to the build flags), every share and queue counts
+ *           how often it is written and read, when it was last written, the
+ *           oldest data any reader has received, and how long readers have
+ *           spent blocked or retrying. The statistics are printed by
+ *           @c print_all_shares() and @c dump_all_shares(). Without the flag,
+ *           the @c SHARE_STATS_...() macros below expand to nothing, so the
+ *           shares contain no extra data or code at all.
+ */
+class ShareStats
+{
+public:
+    std::atomic<uint32_t> puts;             ///< Number of writes
+    std::atomic<uint32_t> gets;             ///< Number of reads
+    std::atomic<uint32_t> last_put_us;      ///< Time of the latest write (us)
+    std::atomic<uint32_t> max_age_us;       ///< Oldest data ever read (us)
+    std::atomic<uint32_t> wait_us;          ///< Total time readers waited (us)
+
+    /// Create a set of statistics with everything zeroed
+    ShareStats (void)
+        : puts (0), gets (0), last_put_us (0), max_age_us (0), wait_us (0)
+    {
+    }
+
+    /// Count writes and remember when the latest one happened
+    void count_put (uint32_t count = 1)
+    {
+        last_put_us.store (micros (), std::memory_order_relaxed);
+        puts.fetch_add (count, std::memory_order_relaxed);
+    }
+
+    /// Count reads and keep track of how old the data read was
+    void count_get (uint32_t count = 1)
+    {
+        gets.fetch_add (count, std::memory_order_relaxed);
+        if (puts.load (std::memory_order_relaxed) != 0)
+        {
+            // A write which lands during the read can make this negative
+            int32_t age = micros () - last_put_us.load (std::memory_order_relaxed);
+            if (age > (int32_t)max_age_us.load (std::memory_order_relaxed))
+            {
+                max_age_us.store (age, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Add time which a reader spent blocked or retrying
+    void add_wait (uint32_t us)
+    {
+        wait_us.fetch_add (us, std::memory_order_relaxed);
+    }
+};
+
+    #define SHARE_STATS_PUT()           stats.count_put ()
+    #define SHARE_STATS_GET()           stats.count_get ()
+    #define SHARE_STATS_PUT_N(count)    stats.count_put (count)
+    #define SHARE_STATS_GET_N(count)    stats.count_get (count)
+    #define SHARE_STATS_WAIT_START()    uint32_t stats_wait_start = micros ()
+    #define SHARE_STATS_WAIT_END()      stats.add_wait (micros () - stats_wait_start)
+    #define SHARE_STATS_PRINT(printer)  print_stats (printer)
+#else
+    #define SHARE_STATS_PUT()
+    #define SHARE_STATS_GET()
+    #define SHARE_STATS_PUT_N(count)
+    #define SHARE_STATS_GET_N(count)
+    #define SHARE_STATS_WAIT_START()
+    #define SHARE_STATS_WAIT_END()
+    #define SHARE_STATS_PRINT(printer)
+#endif // SHARE_STATS
+
+
+/// The most tasks which can subscribe to one shared data item
+#define SHARE_MAX_SUBSCRIBERS 4
+
+
 /** @brief   Base class for classes that share data in a thread-safe manner 
  *           between tasks.
  *  @details This is a base class for classes which share data between tasks
  *           without the risk of data corruption associated with global 
  *           variables. Queues and task shares are two examples of such shared
  *           data classes. 
+ *
+ *           Each share is also a topic to which tasks may subscribe. When a
+ *           share is written, it calls @c publish(), which
+ *           sets each subscriber's bits in that task's FreeRTOS notification
+ *           value. A subscriber can then sleep in @c xTaskNotifyWait() until
+ *           any of the shares it follows is written, rather than polling all
+ *           of them, and reads the data from the share itself, so the data is
+ *           stored only once however many tasks subscribe. A subscribing task
+ *           should not use its notification for anything else. Queues have
+ *           their own consumer wakeup and don't publish. See
+ *           @c subscription.h for a typed way to subscribe.
  */
 class BaseShare
 {
@@ -77,6 +170,59 @@ class BaseShare
          */
         static BaseShare* p_newest;
 
+        /// A task which is notified when the item is written
+        struct Subscriber
+        {
+            TaskHandle_t task;              ///< The task to be notified
+            uint32_t bits;                  ///< Bits set in its notification
+        };
+
+        /// The tasks subscribed to this item
+        Subscriber subscribers[SHARE_MAX_SUBSCRIBERS];
+
+        /// The number of valid entries in @c subscribers
+        std::atomic<uint8_t> num_subscribers;
+
+        // Notify every subscriber that the item has been written
+        void notify_subscribers (uint8_t count);
+
+        // Notify every subscriber from within an ISR
+        void ISR_notify_subscribers (uint8_t count);
+
+        /** @brief   Tell the subscribers, if any, that the item was written.
+         *  @details This method is called by descendent classes after each
+         *           write. It must not be called from within an ISR. An item
+         *           without subscribers pays only for one atomic load.
+         */
+        void publish (void)
+        {
+            uint8_t count = num_subscribers.load (std::memory_order_acquire);
+            if (count != 0)
+            {
+                notify_subscribers (count);
+            }
+        }
+
+        /** @brief   Tell the subscribers that the item was written in an ISR.
+         *  @details This method must only be called from within an ISR.
+         */
+        void ISR_publish (void)
+        {
+            uint8_t count = num_subscribers.load (std::memory_order_acquire);
+            if (count != 0)
+            {
+                ISR_notify_subscribers (count);
+            }
+        }
+
+#ifdef SHARE_STATS
+        /// Usage statistics, updated by the descendent classes' methods
+        ShareStats stats;
+
+        // Print this item's usage statistics on the end of its list line
+        void print_stats (Print& printer);
+#endif
+
     public:
         // Construct a base shared data item
         BaseShare (const char* p_name = NULL);
@@ -91,12 +237,34 @@ class BaseShare
          */
         virtual void print_in_list (Print& printer) = 0;
 
+        // Ask to be notified whenever this item is written
+        bool subscribe (uint32_t bits, TaskHandle_t task = NULL);
+
+        /** @brief   Return the name of this shared data item.
+         *  @returns A pointer to the item's name
+         */
+        const char* get_name (void)
+        {
+            return name;
+        }
+
+        // Find a shared data item by its name
+        static BaseShare* find (const char* p_name);
+
         // }
         friend void print_all_shares (Print& printer);
+#ifdef SHARE_STATS
+        friend void dump_all_shares (Print& printer);
+#endif
 };
 
 
 // Function that prints a list of shares and queues
 void print_all_shares (Print& printer);
 
+#ifdef SHARE_STATS
+// Function that prints every share's statistics as comma-separated values
+void dump_all_shares (Print& printer);
+#endif
+
 #endif // _BASESHARE_H_
\ No newline at end of file
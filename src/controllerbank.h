@@ -0,0 +1,222 @@
+/** @file    controllerbank.h
+ *  @brief   A bank of PID loops which are all updated together.
+ *  @details This file contains a template class which holds @c N independent
+ *           PID loops in structure-of-arrays form: all the proportional gains
+ *           are in one array, all the integrals in another, and so on. One
+ *           call to @c update() runs every loop, including output clamping
+ *           and anti-windup, in a single loop over the arrays with no
+ *           branches, which the compiler can turn into vector instructions.
+ *           Adding control surfaces (ailerons, flaps) makes the arrays longer
+ *           without adding calls or branches. Given a timestamp, the bank
+ *           integrates and differentiates over the measured interval and
+ *           keeps a histogram of its timing jitter.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#ifndef _CONTROLLERBANK_H_
+#define _CONTROLLERBANK_H_
+
+#include <Arduino.h>
+#include <math.h>
+#include "jitter.h"
+
+
+/** @brief   Bank of @c N floating point PID loops updated in one pass.
+ *  @details Each loop's integral is kept in output units and clamped to the
+ *           loop's output range, and it is held while the output is
+ *           saturated in the direction the error pushes (as in @c PID<Q> in
+ *           @c fixedpid.h). Decisions are made with selects rather than
+ *           branches, so every loop takes the same path.
+ *
+ *           Loops which feed each other, such as an attitude loop whose output
+ *           is a servo loop's setpoint, have to be in separate banks, since
+ *           all the loops in one bank run at the same time.
+ *
+ *           @section usage_controllerbank Usage
+ *           @code
+ *           ControllerBank<2> loops;
+ *           loops.set_loop (0, 1, 0, 0, 0.05, -50, 50);     // Roll to rudder
+ *           loops.set_loop (1, 1, 0, 0, 0.05, -50, 50);     // Pitch to elevator
+ *           ...
+ *           float measured[2] = { roll, pitch };
+ *           float wanted[2] = { 0, 10 };
+ *           float angles[2];
+ *           loops.update (measured, wanted, angles);
+ *           @endcode
+ */
+template <uint8_t N> class ControllerBank
+{
+protected:
+    float kp[N];                    ///< Proportional gains
+    float ki[N];                    ///< Integral gains times the interval
+    float kd[N];                    ///< Derivative gains over the interval
+    float out_min[N];               ///< Lowest outputs
+    float out_max[N];               ///< Highest outputs
+    float integral[N];              ///< Integral terms, in output units
+    float err_prev[N];              ///< Errors at the previous update
+
+    float nominal_dt;               ///< Interval the gains were scaled for (s)
+    int64_t time_prev;              ///< Timestamp of the previous update (us)
+    JitterHistogram jitter;         ///< Measured intervals compared to nominal_dt
+
+    /** @brief   Limit a number to a range.
+     *  @details This is written with selects rather than @c fminf() and
+     *           @c fmaxf(), which must handle NaN's and so often become
+     *           function calls instead of single min and max instructions.
+     *  @param   value The number to be limited
+     *  @param   low The lowest value allowed
+     *  @param   high The highest value allowed
+     *  @returns The number, limited to the range from @c low to @c high
+     */
+    static float clamp (float value, float low, float high)
+    {
+        value = (value < low) ? low : value;
+        return (value > high) ? high : value;
+    }
+
+    /** @brief   Run every loop once over an interval of any length.
+     *  @param   current Array of @c N measured values
+     *  @param   desired Array of @c N values they should have
+     *  @param   output Array which receives the @c N clamped outputs
+     *  @param   ratio The interval divided by the nominal interval
+     */
+    void run (const float* __restrict__ current,
+              const float* __restrict__ desired, float* __restrict__ output,
+              float ratio)
+    {
+        float inverse_ratio = 1.0f / ratio;
+
+        for (uint8_t index = 0; index < N; index++)
+        {
+            float err = desired[index] - current[index];
+            float p_term = kp[index] * err;
+            float d_term = kd[index] * inverse_ratio * (err - err_prev[index]);
+            float new_integral = clamp (integral[index] + ki[index] * ratio * err,
+                                        out_min[index], out_max[index]);
+            float raw = p_term + new_integral + d_term;
+
+            // Hold the integral if it would push further into saturation;
+            // the bitwise operators keep this free of branches
+            bool windup = ((raw > out_max[index]) & (err > 0))
+                          | ((raw < out_min[index]) & (err < 0));
+            integral[index] = windup ? integral[index] : new_integral;
+
+            raw = p_term + integral[index] + d_term;
+            output[index] = clamp (raw, out_min[index], out_max[index]);
+            err_prev[index] = err;
+        }
+    }
+
+public:
+    /** @brief   Create a bank of loops with zero gains and outputs.
+     */
+    ControllerBank (void)
+        : nominal_dt (1), time_prev (-1), jitter (1000000)
+    {
+        for (uint8_t index = 0; index < N; index++)
+        {
+            set_loop (index, 0, 0, 0, 1, 0, 0);
+        }
+    }
+
+    /** @brief   Set the gains and output range of one loop.
+     *  @param   index Which loop, from 0 to N - 1
+     *  @param   Kp Proportional gain
+     *  @param   Ki Integral gain
+     *  @param   Kd Derivative gain
+     *  @param   dt Interval at which the bank is run; it must be the same
+     *           for every loop in the bank
+     *  @param   min_out Lowest output
+     *  @param   max_out Highest output
+     */
+    void set_loop (uint8_t index, float Kp, float Ki, float Kd, float dt,
+                   float min_out, float max_out)
+    {
+        if (dt != nominal_dt)
+        {
+            nominal_dt = dt;
+            jitter.set_period ((uint32_t)(dt * 1e6f));
+        }
+
+        kp[index] = Kp;
+        ki[index] = Ki * dt;
+        kd[index] = Kd / dt;
+        out_min[index] = min_out;
+        out_max[index] = max_out;
+        integral[index] = 0;
+        err_prev[index] = 0;
+    }
+
+    /** @brief   Run every loop once, assuming the nominal interval passed.
+     *  @param   current Array of @c N measured values
+     *  @param   desired Array of @c N values they should have
+     *  @param   output Array which receives the @c N clamped outputs. The
+     *           arrays must not overlap each other or the bank, which lets the
+     *           compiler keep the loop's values in vector registers
+     */
+    void update (const float* __restrict__ current,
+                 const float* __restrict__ desired, float* __restrict__ output)
+    {
+        run (current, desired, output, 1.0f);
+    }
+
+    /** @brief   Run every loop once over the measured interval.
+     *  @details The interval since the previous timestamped update is
+     *           recorded in the jitter histogram, and the integral and
+     *           derivative gains are scaled by its ratio to the nominal
+     *           interval. The first update, and one whose timestamp is not
+     *           later than the last, use the nominal interval.
+     *  @param   current Array of @c N measured values
+     *  @param   desired Array of @c N values they should have
+     *  @param   output Array which receives the @c N clamped outputs
+     *  @param   time_us When @c current was measured, from
+     *           @c esp_timer_get_time()
+     */
+    void update (const float* __restrict__ current,
+                 const float* __restrict__ desired, float* __restrict__ output,
+                 int64_t time_us)
+    {
+        float ratio = 1.0f;
+
+        if (time_prev >= 0)
+        {
+            // A repeated or backwards timestamp is neither recorded nor used
+            int64_t elapsed = time_us - time_prev;
+            if (elapsed > 0)
+            {
+                jitter.record ((uint32_t)elapsed);
+                ratio = elapsed * 1e-6f / nominal_dt;
+            }
+        }
+        time_prev = time_us;
+
+        run (current, desired, output, ratio);
+    }
+
+    /** @brief   Return the histogram of measured update intervals.
+     *  @returns A reference to the bank's jitter histogram
+     */
+    JitterHistogram& get_jitter (void)
+    {
+        return jitter;
+    }
+
+    /** @brief   Clear every loop's integral and previous error.
+     *  @details The next timestamped update uses the nominal interval, so a
+     *           pause while the bank was not being run is not integrated.
+     */
+    void reset (void)
+    {
+        time_prev = -1;
+
+        for (uint8_t index = 0; index < N; index++)
+        {
+            integral[index] = 0;
+            err_prev[index] = 0;
+        }
+    }
+};
+
+#endif // _CONTROLLERBANK_H_
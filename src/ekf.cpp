@@ -0,0 +1,348 @@
+/** @file ekf.cpp
+ *  @brief This is the source file containing the constructor and methods for
+ *         an extended Kalman filter on the attitude quaternion.
+ *  @details The filter is the multiplicative form described by F. L. Markley
+ *           in "Attitude Error Representations for Kalman Filtering" (2003):
+ *           the error states are a small rotation in the sensor frame, which
+ *           is folded into the quaternion after every correction, so the
+ *           quaternion never needs its own covariance or a constraint to keep
+ *           it of unit length.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include "ekf.h"
+#include "fastmath.h"
+
+/// Standard deviation of the attitude after init() (rad)
+#define EKF_INIT_ANGLE 0.1f
+
+/// Standard deviation of the gyro bias after init() (rad/s)
+#define EKF_INIT_BIAS 0.05f
+
+/// Smallest horizontal part of the field, as a fraction of it, for a heading
+#define EKF_MIN_HORIZONTAL 0.1f
+
+/** @brief   Constructor which creates a filter at a level attitude
+ *  @param   gyro_noise Noise density of the gyro, which sets how quickly the
+ *           attitude becomes uncertain between corrections (rad/s/sqrt(Hz))
+ *  @param   bias_walk Rate at which the gyro bias wanders (rad/s/sqrt(s))
+ *  @param   accel_noise Uncertainty in the direction of the accelerometer
+ *           reading, which includes the glider's own accelerations (rad)
+ *  @param   heading_noise Uncertainty in the heading of the magnetometer
+ *           reading (rad)
+ */
+AttitudeEKF::AttitudeEKF(float gyro_noise, float bias_walk, float accel_noise,
+                         float heading_noise)
+{
+    gyro_var = gyro_noise * gyro_noise;
+    bias_var = bias_walk * bias_walk;
+    accel_var = accel_noise * accel_noise;
+    heading_var = heading_noise * heading_noise;
+    init(0, 0, 1, 0, 0, 0);
+}
+
+/** @brief   Sets the attitude from one accelerometer and magnetometer reading
+ *  @details Roll and pitch come from the direction of gravity and yaw from
+ *           the tilt compensated magnetic field, or zero if the magnetometer
+ *           reading is all zeros. The bias is set to zero and the covariance
+ *           to its starting value.
+ *  @param   ax Accelerometer reading, x axis
+ *  @param   ay Accelerometer reading, y axis
+ *  @param   az Accelerometer reading, z axis
+ *  @param   mx Magnetometer reading, x axis
+ *  @param   my Magnetometer reading, y axis
+ *  @param   mz Magnetometer reading, z axis
+ */
+void AttitudeEKF::init(float ax, float ay, float az, float mx, float my, float mz)
+{
+    float roll = fast_atan2(ay, az);
+    float pitch = fast_atan2(-ax, fast_sqrt(ay * ay + az * az));
+    float yaw = 0;
+
+    if (mx != 0 || my != 0 || mz != 0)
+    {
+        // Rotate the field back to level, then measure its heading
+        float sr, cr, sp, cp;
+        fast_sincos(roll, sr, cr);
+        fast_sincos(pitch, sp, cp);
+        float level_x = mx * cp + (my * sr + mz * cr) * sp;
+        float level_y = my * cr - mz * sr;
+        yaw = fast_atan2(-level_y, level_x);
+    }
+
+    float cr, sr, cp, sp, cy, sy;
+    fast_sincos(roll / 2, sr, cr);
+    fast_sincos(pitch / 2, sp, cp);
+    fast_sincos(yaw / 2, sy, cy);
+    q0 = cr * cp * cy + sr * sp * sy;
+    q1 = sr * cp * cy - cr * sp * sy;
+    q2 = cr * sp * cy + sr * cp * sy;
+    q3 = cr * cp * sy - sr * sp * cy;
+
+    bias_x = 0;
+    bias_y = 0;
+    bias_z = 0;
+
+    P = Matrix<6, 6>::zeros();
+    for (uint8_t index = 0; index < 3; index++)
+    {
+        P(index, index) = EKF_INIT_ANGLE * EKF_INIT_ANGLE;
+        P(index + 3, index + 3) = EKF_INIT_BIAS * EKF_INIT_BIAS;
+    }
+}
+
+/** @brief   Fuses gyro, accelerometer and magnetometer readings
+ *  @details A reading which is all zeros (no new reading) from the
+ *           accelerometer or magnetometer is skipped, and the other sensors
+ *           are still used.
+ *  @param   gx Gyro rate about the x axis (rad/s)
+ *  @param   gy Gyro rate about the y axis (rad/s)
+ *  @param   gz Gyro rate about the z axis (rad/s)
+ *  @param   ax Accelerometer reading, x axis
+ *  @param   ay Accelerometer reading, y axis
+ *  @param   az Accelerometer reading, z axis
+ *  @param   mx Magnetometer reading, x axis
+ *  @param   my Magnetometer reading, y axis
+ *  @param   mz Magnetometer reading, z axis
+ *  @param   dt Time since the previous update (s)
+ */
+void AttitudeEKF::update(float gx, float gy, float gz, float ax, float ay,
+                         float az, float mx, float my, float mz, float dt)
+{
+    update_imu(gx, gy, gz, ax, ay, az, dt);
+    if (mx != 0 || my != 0 || mz != 0)
+    {
+        correct_heading(mx, my, mz);
+    }
+}
+
+/** @brief   Fuses gyro and accelerometer readings only
+ *  @details Roll and pitch are corrected by the accelerometer; yaw is the
+ *           integrated gyro rate and will drift.
+ *  @param   gx Gyro rate about the x axis (rad/s)
+ *  @param   gy Gyro rate about the y axis (rad/s)
+ *  @param   gz Gyro rate about the z axis (rad/s)
+ *  @param   ax Accelerometer reading, x axis
+ *  @param   ay Accelerometer reading, y axis
+ *  @param   az Accelerometer reading, z axis
+ *  @param   dt Time since the previous update (s)
+ */
+void AttitudeEKF::update_imu(float gx, float gy, float gz, float ax, float ay,
+                             float az, float dt)
+{
+    predict(gx, gy, gz, dt);
+    if (ax != 0 || ay != 0 || az != 0)
+    {
+        correct_gravity(ax, ay, az);
+    }
+}
+
+/** @brief   Rotates the quaternion by a small rotation about the sensor's axes
+ *  @details The rotation vector's length is the angle; it should be small, as
+ *           the sine is taken to be the angle.
+ *  @param   x Rotation about the x axis (rad)
+ *  @param   y Rotation about the y axis (rad)
+ *  @param   z Rotation about the z axis (rad)
+ */
+void AttitudeEKF::rotate(float x, float y, float z)
+{
+    x *= 0.5f;
+    y *= 0.5f;
+    z *= 0.5f;
+
+    float qa = q0, qb = q1, qc = q2;
+    q0 += -qb * x - qc * y - q3 * z;
+    q1 += qa * x + qc * z - q3 * y;
+    q2 += qa * y - qb * z + q3 * x;
+    q3 += qa * z + qb * y - qc * x;
+
+    float norm = fast_inv_sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q0 *= norm;
+    q1 *= norm;
+    q2 *= norm;
+    q3 *= norm;
+}
+
+/** @brief   Integrates the gyro and grows the covariance over one step
+ *  @details The attitude error turns with the body at the corrected rate and
+ *           grows by any error in the bias, so the transition matrix is
+ *           [I - [w x] dt, -I dt; 0, I].
+ *  @param   gx Gyro rate about the x axis (rad/s)
+ *  @param   gy Gyro rate about the y axis (rad/s)
+ *  @param   gz Gyro rate about the z axis (rad/s)
+ *  @param   dt Length of the step (s)
+ */
+void AttitudeEKF::predict(float gx, float gy, float gz, float dt)
+{
+    if (dt <= 0)
+    {
+        return;
+    }
+    float wx = gx - bias_x;
+    float wy = gy - bias_y;
+    float wz = gz - bias_z;
+    rotate(wx * dt, wy * dt, wz * dt);
+
+    Matrix<6, 6> F =
+    {{
+        { 1,        wz * dt,  -wy * dt, -dt,  0,   0  },
+        { -wz * dt, 1,        wx * dt,  0,    -dt, 0  },
+        { wy * dt,  -wx * dt, 1,        0,    0,   -dt },
+        { 0,        0,        0,        1,    0,   0  },
+        { 0,        0,        0,        0,    1,   0  },
+        { 0,        0,        0,        0,    0,   1  }
+    }};
+    P = F * P * F.transpose();
+    for (uint8_t index = 0; index < 3; index++)
+    {
+        P(index, index) += gyro_var * dt;
+        P(index + 3, index + 3) += bias_var * dt;
+    }
+    P.symmetrize();
+}
+
+/** @brief   Corrects the attitude with the direction of gravity
+ *  @details If the attitude is off by a small rotation e, the accelerometer
+ *           should read the predicted direction v plus v x e, so the
+ *           measurement matrix is [[v x], 0].
+ *  @param   ax Accelerometer reading, x axis
+ *  @param   ay Accelerometer reading, y axis
+ *  @param   az Accelerometer reading, z axis
+ */
+void AttitudeEKF::correct_gravity(float ax, float ay, float az)
+{
+    float norm = fast_inv_sqrt(ax * ax + ay * ay + az * az);
+    ax *= norm;
+    ay *= norm;
+    az *= norm;
+
+    // Direction of gravity's reaction which the attitude predicts
+    float vx = 2 * (q1 * q3 - q0 * q2);
+    float vy = 2 * (q0 * q1 + q2 * q3);
+    float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+    Matrix<3, 6> H =
+    {{
+        { 0,   -vz, vy,  0, 0, 0 },
+        { vz,  0,   -vx, 0, 0, 0 },
+        { -vy, vx,  0,   0, 0, 0 }
+    }};
+    Matrix<3, 1> y = {{ { ax - vx }, { ay - vy }, { az - vz } }};
+
+    Matrix<6, 3> PHt = P * H.transpose();
+    Matrix<3, 3> S = H * PHt + Matrix<3, 3>::diagonal(accel_var);
+    Matrix<3, 3> S_inv;
+    if (!invert(S, S_inv))
+    {
+        return;
+    }
+    Matrix<6, 3> K = PHt * S_inv;
+    P = P - K * PHt.transpose();
+    P.symmetrize();
+    apply(K * y);
+}
+
+/** @brief   Corrects the heading with the direction of the Earth's field
+ *  @details The reading is rotated into the Earth frame by the attitude, and
+ *           the angle of its horizontal part from north is the heading error.
+ *           That angle also moves with a roll error about north, by the ratio
+ *           of the field's vertical and horizontal parts, which the
+ *           measurement matrix includes. Near a magnetic pole, where the
+ *           field is nearly vertical, no correction is made.
+ *  @param   mx Magnetometer reading, x axis
+ *  @param   my Magnetometer reading, y axis
+ *  @param   mz Magnetometer reading, z axis
+ */
+void AttitudeEKF::correct_heading(float mx, float my, float mz)
+{
+    float r00 = 1 - 2 * (q2 * q2 + q3 * q3);
+    float r01 = 2 * (q1 * q2 - q0 * q3);
+    float r02 = 2 * (q1 * q3 + q0 * q2);
+    float r10 = 2 * (q1 * q2 + q0 * q3);
+    float r11 = 1 - 2 * (q1 * q1 + q3 * q3);
+    float r12 = 2 * (q2 * q3 - q0 * q1);
+    float r20 = 2 * (q1 * q3 - q0 * q2);
+    float r21 = 2 * (q2 * q3 + q0 * q1);
+    float r22 = 1 - 2 * (q1 * q1 + q2 * q2);
+
+    float hx = r00 * mx + r01 * my + r02 * mz;
+    float hy = r10 * mx + r11 * my + r12 * mz;
+    float hz = r20 * mx + r21 * my + r22 * mz;
+    float horizontal = fast_sqrt(hx * hx + hy * hy);
+    if (horizontal < EKF_MIN_HORIZONTAL * fast_sqrt(horizontal * horizontal + hz * hz))
+    {
+        return;
+    }
+
+    float dip = hz / horizontal;
+    Matrix<1, 6> H = {{ { r20 - dip * r00, r21 - dip * r01, r22 - dip * r02,
+                          0, 0, 0 } }};
+    float y = fast_atan2(-hy, hx);
+
+    Matrix<6, 1> PHt = P * H.transpose();
+    float S = (H * PHt)(0, 0) + heading_var;
+    Matrix<6, 1> K = PHt * (1.0f / S);
+    P = P - K * PHt.transpose();
+    P.symmetrize();
+    apply(K * y);
+}
+
+/** @brief   Applies a correction to the attitude and bias
+ *  @param   dx The correction: a rotation about the sensor's axes (rad) and
+ *           the change in the bias (rad/s)
+ */
+void AttitudeEKF::apply(const Matrix<6, 1>& dx)
+{
+    rotate(dx(0, 0), dx(1, 0), dx(2, 0));
+    bias_x += dx(3, 0);
+    bias_y += dx(4, 0);
+    bias_z += dx(5, 0);
+}
+
+/** @brief   Returns the roll angle, about the sensor's x axis
+ *  @returns The roll angle (rad)
+ */
+float AttitudeEKF::get_roll(void)
+{
+    return fast_atan2(q0 * q1 + q2 * q3, 0.5f - q1 * q1 - q2 * q2);
+}
+
+/** @brief   Returns the pitch angle, about the sensor's y axis
+ *  @returns The pitch angle (rad)
+ */
+float AttitudeEKF::get_pitch(void)
+{
+    float sin_pitch = -2 * (q1 * q3 - q0 * q2);
+    sin_pitch = (sin_pitch > 1) ? 1 : ((sin_pitch < -1) ? -1 : sin_pitch);
+    // fast_asin() is slower than asinf() on the host; keep libm until
+    // FASTMATH_CYCLES shows it faster on the ESP32
+    return asinf(sin_pitch);
+}
+
+/** @brief   Returns the yaw angle, about the Earth's vertical
+ *  @returns The yaw angle (rad), zero when the x axis points along the
+ *           horizontal part of the Earth's field
+ */
+float AttitudeEKF::get_yaw(void)
+{
+    return fast_atan2(q1 * q2 + q0 * q3, 0.5f - q2 * q2 - q3 * q3);
+}
+
+/** @brief   Returns the upward part of a vector measured in the sensor frame
+ *  @details This is the bottom row of the rotation from the sensor frame to
+ *           the Earth frame, in which +z is up. For an accelerometer reading
+ *           it is the upward acceleration plus gravity.
+ *  @param   x The vector's x component
+ *  @param   y The vector's y component
+ *  @param   z The vector's z component
+ *  @returns The vector's component along the Earth's vertical
+ */
+float AttitudeEKF::get_vertical(float x, float y, float z)
+{
+    return 2 * (q1 * q3 - q0 * q2) * x + 2 * (q2 * q3 + q0 * q1) * y
+           + (1 - 2 * (q1 * q1 + q2 * q2)) * z;
+}
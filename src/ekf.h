@@ -0,0 +1,90 @@
+/** @file ekf.h
+ *  @brief The header file for an extended Kalman filter which estimates the
+ *         attitude quaternion and the gyro's bias.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// Compile this header file only once
+#ifndef _EKF_H_
+#define _EKF_H_
+
+#include <Arduino.h>
+#include "matrix.h"
+
+/** @brief  Class for a multiplicative extended Kalman filter on the attitude
+ *          quaternion, with the gyro's bias as three more states.
+ *  @details The quaternion itself is kept outside the covariance, which is
+ *           only 6 by 6: three small rotations about the sensor's axes which
+ *           would correct the attitude, and the three bias rates. Each update
+ *           integrates the gyro rates less the bias and grows the covariance
+ *           by the gyro noise and the bias' random walk. The direction of the
+ *           accelerometer reading is then compared with the direction of
+ *           gravity which the attitude predicts, and the heading of the
+ *           magnetometer reading with north, and the corrections are
+ *           weighted by the covariance.
+ *
+ *           Its interface is that of @c MahonyFilter, which it may replace:
+ *           readings may be in any units, the sensor frame is right handed
+ *           with its accelerometer reading +z when level, and angles follow
+ *           the yaw-pitch-roll (Z-Y-X) convention. Every matrix has a fixed
+ *           size and lives inside the object or on the stack, so an update
+ *           allocates nothing and always takes the same time.
+ */
+class AttitudeEKF
+{
+protected:
+    float q0, q1, q2, q3;           ///< Attitude quaternion, sensor to Earth frame
+    float bias_x, bias_y, bias_z;   ///< Estimated gyro bias (rad/s)
+    Matrix<6, 6> P;                 ///< Covariance of the attitude error (rad) and bias (rad/s)
+    float gyro_var;                 ///< Gyro noise density squared (rad^2/s)
+    float bias_var;                 ///< Bias random walk density squared (rad^2/s^3)
+    float accel_var;                ///< Variance of the accelerometer's direction (rad^2)
+    float heading_var;              ///< Variance of the magnetometer's heading (rad^2)
+
+    // Rotate the quaternion by a small rotation about the sensor's axes
+    void rotate(float x, float y, float z);
+
+    // Integrate the gyro and grow the covariance over one step
+    void predict(float gx, float gy, float gz, float dt);
+
+    // Correct the attitude with the direction of gravity
+    void correct_gravity(float ax, float ay, float az);
+
+    // Correct the heading with the direction of the Earth's field
+    void correct_heading(float mx, float my, float mz);
+
+    // Apply a correction to the attitude and bias
+    void apply(const Matrix<6, 1>& dx);
+
+public:
+    // Set up a filter at a level attitude
+    AttitudeEKF(float gyro_noise = 0.001f, float bias_walk = 0.0003f,
+                float accel_noise = 0.5f, float heading_noise = 0.05f);
+
+    // Start at the attitude given by one set of readings
+    void init(float ax, float ay, float az, float mx, float my, float mz);
+
+    // Fuse gyro, accelerometer and magnetometer readings
+    void update(float gx, float gy, float gz, float ax, float ay, float az,
+                float mx, float my, float mz, float dt);
+
+    // Fuse gyro and accelerometer readings only
+    void update_imu(float gx, float gy, float gz, float ax, float ay, float az,
+                    float dt);
+
+    // Roll angle (rad)
+    float get_roll(void);
+
+    // Pitch angle (rad)
+    float get_pitch(void);
+
+    // Yaw angle (rad)
+    float get_yaw(void);
+
+    // Part of a vector in the sensor frame which points up in the Earth frame
+    float get_vertical(float x, float y, float z);
+};
+
+#endif // _EKF_H_
@@ -0,0 +1,74 @@
+/** @file fastmath.cpp
+ *  @brief This file measures the cost on the ESP32 of the approximations in
+ *         fastmath.h and of the libm functions they replace.
+ *  @details The host benchmark checks their accuracy and times them on the
+ *           host, but the ratio of their costs there says little about the
+ *           ESP32, which has no divide or square root instruction and does
+ *           double precision in software. When the program is built with
+ *           @c FASTMATH_CYCLES defined, setup() calls
+ *           fastmath_print_cycles() to count the CPU cycles each one takes.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include "fastmath.h"
+
+/// Number of arguments each function is timed over
+#define CYCLE_ARGS 256
+
+/** @brief   Counts the average cycles of one call of a function.
+ *  @param   function The function, taking and returning a float
+ *  @param   p_args Array of CYCLE_ARGS arguments
+ *  @returns The mean number of CPU cycles per call, including the loop
+ */
+template <typename Function>
+static uint32_t cycles_per_call(Function function, const float* p_args)
+{
+    volatile float sink = 0.0f;
+    float sum = 0.0f;
+    uint32_t start = ESP.getCycleCount();
+    for (uint16_t index = 0; index < CYCLE_ARGS; index++)
+    {
+        sum += function(p_args[index]);
+    }
+    uint32_t cycles = ESP.getCycleCount() - start;
+    sink = sum;
+    (void)sink;
+    return cycles / CYCLE_ARGS;
+}
+
+/** @brief   Prints the cycles per call of each fast function and its libm
+ *           counterpart.
+ *  @details The counts include the loop and the sum, a few cycles each, and
+ *           any interrupt which happens to land in the loop.
+ *  @param   printer The stream to print on, such as Serial
+ */
+void fastmath_print_cycles(Print& printer)
+{
+    static float angles[CYCLE_ARGS];
+    static float ratios[CYCLE_ARGS];
+    static float positives[CYCLE_ARGS];
+    for (uint16_t index = 0; index < CYCLE_ARGS; index++)
+    {
+        angles[index] = -3.0f + 6.0f * index / CYCLE_ARGS;
+        ratios[index] = -0.99f + 1.98f * index / CYCLE_ARGS;
+        positives[index] = 0.01f + 100.0f * index / CYCLE_ARGS;
+    }
+
+    printer.printf("fastmath cycles per call   fast   libm\r\n");
+    printer.printf("%-24s %6lu %6lu\r\n", "atan2",
+        (unsigned long)cycles_per_call([](float a) { return fast_atan2(a, 0.7f); }, angles),
+        (unsigned long)cycles_per_call([](float a) { return atan2f(a, 0.7f); }, angles));
+    printer.printf("%-24s %6lu %6lu\r\n", "asin",
+        (unsigned long)cycles_per_call([](float a) { return fast_asin(a); }, ratios),
+        (unsigned long)cycles_per_call([](float a) { return asinf(a); }, ratios));
+    printer.printf("%-24s %6lu %6lu\r\n", "sin + cos",
+        (unsigned long)cycles_per_call([](float a) { float s, c; fast_sincos(a, s, c);
+                                                     return s + c; }, angles),
+        (unsigned long)cycles_per_call([](float a) { return sinf(a) + cosf(a); }, angles));
+    printer.printf("%-24s %6lu %6lu\r\n", "1 / sqrt",
+        (unsigned long)cycles_per_call([](float a) { return fast_inv_sqrt(a); }, positives),
+        (unsigned long)cycles_per_call([](float a) { return 1.0f / sqrtf(a); }, positives));
+}
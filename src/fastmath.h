@@ -0,0 +1,170 @@
+/** @file fastmath.h
+ *  @brief Fast single precision approximations of the square root and
+ *         trigonometric functions used by the attitude estimator.
+ *  @details The ESP32's FPU does single precision adds and multiplies in a
+ *           few cycles but has no divide or square root instruction, and
+ *           @c libm's @c atan2f(), @c sinf() and friends are written for
+ *           full precision over the whole range. The attitude pipeline needs
+ *           neither: its inputs are noisy sensor readings and its outputs are
+ *           angles good to a small fraction of a degree. These functions are
+ *           short polynomials with the error bounds given on each, which are
+ *           checked against @c libm over a dense sweep by @c bench_fastmath.
+ *
+ *           Every constant is a @c float, so nothing is promoted to double,
+ *           which the ESP32 does in software.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// Compile this header file only once
+#ifndef _FASTMATH_H_
+#define _FASTMATH_H_
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define FM_PI       3.14159265f     ///< Pi as a float
+#define FM_PI_2     1.57079633f     ///< Pi / 2 as a float
+#define FM_2_PI     6.28318531f     ///< 2 pi as a float
+#define FM_RAD_TO_DEG 57.2957795f   ///< Degrees per radian as a float
+#define FM_DEG_TO_RAD 0.0174532925f ///< Radians per degree as a float
+
+
+/** @brief   Approximates 1 / sqrt(x).
+ *  @details A bit-level first guess is refined by two Newton steps. The
+ *           relative error is below 5e-6 for all normal positive @c x.
+ *  @param   x A positive number
+ *  @returns Approximately 1 / sqrt(x)
+ */
+inline float fast_inv_sqrt(float x)
+{
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5F375A86 - (bits >> 1);
+    float y;
+    memcpy(&y, &bits, sizeof(y));
+
+    float half_x = 0.5f * x;
+    y = y * (1.5f - half_x * y * y);
+    y = y * (1.5f - half_x * y * y);
+    return y;
+}
+
+
+/** @brief   Approximates sqrt(x).
+ *  @details The relative error is below 5e-6 for all normal positive @c x.
+ *  @param   x A number which is zero or positive
+ *  @returns Approximately sqrt(x), or zero if @c x is not positive
+ */
+inline float fast_sqrt(float x)
+{
+    return (x > 0.0f) ? x * fast_inv_sqrt(x) : 0.0f;
+}
+
+
+/** @brief   Approximates atan(z) for |z| <= 1.
+ *  @details This is the ninth order polynomial of Abramowitz and Stegun
+ *           4.4.49, with an absolute error below 1e-5 rad.
+ *  @param   z A number from -1 to 1
+ *  @returns Approximately atan(z) (rad)
+ */
+inline float fast_atan_unit(float z)
+{
+    float z2 = z * z;
+    return z * (0.9998660f + z2 * (-0.3302995f + z2 * (0.1801410f
+                + z2 * (-0.0851330f + z2 * 0.0208351f))));
+}
+
+
+/** @brief   Approximates atan2(y, x).
+ *  @details The smaller of |x| and |y| is divided by the larger, so the
+ *           polynomial is only needed from 0 to 1, and the octant is put back
+ *           afterwards. The absolute error is below 1.5e-5 rad everywhere;
+ *           the polynomial's own 1e-5 plus single precision rounding.
+ *  @param   y The y coordinate
+ *  @param   x The x coordinate
+ *  @returns Approximately atan2(y, x), from -pi to pi (rad), or zero at the
+ *           origin
+ */
+inline float fast_atan2(float y, float x)
+{
+    float abs_x = fabsf(x);
+    float abs_y = fabsf(y);
+    if (abs_x == 0.0f && abs_y == 0.0f)
+    {
+        return 0.0f;
+    }
+
+    float angle = (abs_y <= abs_x) ? fast_atan_unit(abs_y / abs_x)
+                                   : FM_PI_2 - fast_atan_unit(abs_x / abs_y);
+    if (x < 0.0f)
+    {
+        angle = FM_PI - angle;
+    }
+    return (y < 0.0f) ? -angle : angle;
+}
+
+
+/** @brief   Approximates asin(x).
+ *  @details This is atan2(x, sqrt(1 - x^2)), so its absolute error is below
+ *           2e-5 rad. Arguments beyond +/-1 are clipped.
+ *  @param   x A number from -1 to 1
+ *  @returns Approximately asin(x), from -pi/2 to pi/2 (rad)
+ */
+inline float fast_asin(float x)
+{
+    x = (x > 1.0f) ? 1.0f : ((x < -1.0f) ? -1.0f : x);
+    return fast_atan2(x, fast_sqrt(1.0f - x * x));
+}
+
+
+/** @brief   Approximates sin(x) and cos(x) together.
+ *  @details The angle is reduced to within pi/4 of a multiple of pi/2, where
+ *           seventh and eighth order Taylor polynomials have errors below
+ *           4e-7. With the rounding of the reduction, the absolute error is
+ *           below 1e-6 for |x| up to about 100 rad.
+ *  @param   x The angle (rad)
+ *  @param   sin_x Set to approximately sin(x)
+ *  @param   cos_x Set to approximately cos(x)
+ */
+inline void fast_sincos(float x, float& sin_x, float& cos_x)
+{
+    // Round to the nearest quadrant, then reduce in two parts so that the
+    // remainder keeps its precision
+    int32_t quadrant = (int32_t)(x * 0.636619772f + ((x < 0.0f) ? -0.5f : 0.5f));
+    float r = (x - quadrant * 1.5703125f) - quadrant * 4.83826794e-4f;
+    float r2 = r * r;
+
+    float s = r * (1.0f + r2 * (-1.66666667e-1f + r2 * (8.33333333e-3f
+                   + r2 * -1.98412698e-4f)));
+    float c = 1.0f + r2 * (-0.5f + r2 * (4.16666667e-2f + r2 * (-1.38888889e-3f
+                   + r2 * 2.48015873e-5f)));
+
+    switch (quadrant & 3)
+    {
+        case 0:
+            sin_x = s;
+            cos_x = c;
+            break;
+        case 1:
+            sin_x = c;
+            cos_x = -s;
+            break;
+        case 2:
+            sin_x = -s;
+            cos_x = -c;
+            break;
+        default:
+            sin_x = -c;
+            cos_x = s;
+            break;
+    }
+}
+
+// Print the cycles per call of these functions and of libm's on the ESP32
+void fastmath_print_cycles(Print& printer);
+
+#endif // _FASTMATH_H_
@@ -0,0 +1,260 @@
+/** @file    fastshare.h
+ *  @brief   Lock-free data which can be shared between tasks.
+ *  @details This file contains a template class for data which is shared
+ *           between tasks through a sequence lock (seqlock) rather than a
+ *           FreeRTOS queue. Readers never make a kernel call; they copy the
+ *           data and retry if a writer changed it during the copy. Writers
+ *           are serialized by a spinlock critical section which is also safe
+ *           to use from within interrupt service routines. The class has the
+ *           same interface as @c Share<DataType> in @c taskshare.h, so it can
+ *           be used as a drop-in replacement on the high-rate control path.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// This define prevents this .h file from being included more than once
+#ifndef _FASTSHARE_H_
+#define _FASTSHARE_H_
+
+#include <atomic>
+#include <type_traits>
+#include "baseshare.h"                      // Base class for shared data items
+#include <PrintStream.h>                    // Needed for endl
+
+
+/** @brief   Class for data shared between tasks without kernel calls on read.
+ *  @details This class works like @c Share<DataType>, keeping only the most
+ *           recently written value of the data, but it protects the data with
+ *           a sequence counter instead of a one-item queue. The counter is
+ *           odd while a write is in progress and even otherwise. A reader
+ *           copies the data, then checks that the counter was even and did
+ *           not change during the copy; if it did, the copy is repeated.
+ *           Since writers run inside a critical section which disables
+ *           interrupts on their core, a reader can never preempt a writer on
+ *           the same core, so a reader only ever retries when a writer on the
+ *           other core is active, and then only for the duration of a copy.
+ *
+ *           Because the data is copied byte by byte while it may be changing,
+ *           only trivially copyable types (numbers, @c bool, and plain
+ *           @c struct's of them) may be used. Unlike @c Share<DataType>, a
+ *           @c FastShare<DataType> never blocks: reading it before anything
+ *           has been written returns a zero-initialized value.
+ *
+ *           @section usage_fastshare Usage
+ *           A @c FastShare is declared and used exactly as a @c Share is:
+ *           @code
+ *           #include "fastshare.h"
+ *           ...
+ *           /// Current pitch angle of the aircraft in degrees
+ *           FastShare<float> pitch_share ("Pitch");
+ *           ...
+ *           pitch_share.put (pitch);             // In the sending task
+ *           ...
+ *           float pitch_now = pitch_share.get ();   // In the receiving task
+ *           @endcode
+ */
+template <class DataType> class FastShare : public BaseShare
+{
+    static_assert (std::is_trivially_copyable<DataType>::value,
+                   "FastShare can only hold trivially copyable data");
+
+protected:
+    /// Sequence counter which is odd while the data is being written
+    std::atomic<uint32_t> sequence;
+
+    /// Spinlock which keeps writers in different tasks or ISR's from colliding
+    portMUX_TYPE write_lock;
+
+    /// The most recently written copy of the shared data
+    DataType data;
+
+    /** @brief   Copy new data into the share, bumping the sequence counter.
+     *  @details This method must only be called while @c write_lock is held.
+     *  @param   new_data A reference to the data which is to be written
+     */
+    void write (const DataType& new_data)
+    {
+        uint32_t seq = sequence.load (std::memory_order_relaxed);
+        sequence.store (seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+
+        memcpy (&data, &new_data, sizeof (DataType));
+
+        sequence.store (seq + 2, std::memory_order_release);
+        SHARE_STATS_PUT ();
+    }
+
+    /** @brief   Copy a consistent snapshot of the data out of the share.
+     *  @details The copy is retried until no write overlapped it.
+     *  @param   recv_data A reference to the variable which receives the data
+     *  @returns The (even) sequence number of the snapshot which was copied
+     */
+    uint32_t read (DataType& recv_data)
+    {
+        uint32_t seq_before;
+        uint32_t seq_after;
+
+        // Time spent here beyond a single copy is spent waiting for writers
+        SHARE_STATS_WAIT_START ();
+        do
+        {
+            seq_before = sequence.load (std::memory_order_acquire);
+            memcpy (&recv_data, &data, sizeof (DataType));
+            std::atomic_thread_fence (std::memory_order_acquire);
+            seq_after = sequence.load (std::memory_order_relaxed);
+        }
+        while ((seq_before & 1) || (seq_before != seq_after));
+        SHARE_STATS_WAIT_END ();
+        SHARE_STATS_GET ();
+
+        return seq_before;
+    }
+
+    // Subscriptions read the sequence counter to tell new data from old
+    template <class SubType> friend class Subscription;
+
+public:
+    /** @brief   Construct a lock-free shared data item.
+     *  @details The data is zero-initialized, so a task which reads the share
+     *           before any other task has written it will get a zero value.
+     *  @param   p_name A name to be shown in the list of task shares
+     *           (default @c NULL)
+     */
+    FastShare<DataType> (const char* p_name = NULL)
+        : BaseShare (p_name), sequence (0), data ()
+    {
+        portMUX_INITIALIZE (&write_lock);
+    }
+
+    /** @brief   Put data into the shared data item.
+     *  @details This method is used to write data into the shared data item.
+     *           It must @b not be called from within an ISR.
+     *  @param   new_data The data which is to be written
+     */
+    void put (DataType new_data)
+    {
+        portENTER_CRITICAL (&write_lock);
+        write (new_data);
+        portEXIT_CRITICAL (&write_lock);
+        publish ();
+    }
+
+    /** @brief   Put data into the shared data item from within an ISR.
+     *  @details This method writes data from an ISR into the shared data item.
+     *           It must only be called from within an interrupt service
+     *           routine, not a normal task.
+     *  @param   new_data The data to be written into the shared data item
+     */
+    void ISR_put (DataType new_data)
+    {
+        portENTER_CRITICAL_ISR (&write_lock);
+        write (new_data);
+        portEXIT_CRITICAL_ISR (&write_lock);
+        ISR_publish ();
+    }
+
+    /** @brief   Operator which inserts data into the share.
+     *  @details This operator checks if the processor is currently in an
+     *           interrupt service routine and calls @c ISR_put() or @c put()
+     *           as appropriate, so it may be used within an ISR or outside one.
+     *  @param   new_data The data which is to be put into the share
+     */
+    void operator << (DataType new_data)
+    {
+        if (CHECK_IF_IN_ISR ())
+        {
+            ISR_put (new_data);
+        }
+        else
+        {
+            put (new_data);
+        }
+    }
+
+    /** @brief   Read data from the shared data item.
+     *  @details Reading takes no lock and makes no kernel call, so the same
+     *           code works inside and outside interrupt service routines.
+     *  @param   put_here A reference to the variable in which to put received
+     *           data
+     */
+    void operator >> (DataType& put_here)
+    {
+        read (put_here);
+    }
+
+    /** @brief   Read data from the shared data item into a variable.
+     *  @param   recv_data A reference to the variable in which to put received
+     *           data
+     */
+    void get (DataType& recv_data)
+    {
+        read (recv_data);
+    }
+
+    /** @brief   Read and return data from the shared data item.
+     *  @returns A copy of the most recently written data
+     */
+    DataType get (void)
+    {
+        DataType return_this;
+        read (return_this);
+        return return_this;
+    }
+
+    /** @brief   Read data from the shared data item, from within an ISR.
+     *  @details Reading is the same inside and outside an ISR; this method is
+     *           provided so that @c FastShare can replace @c Share unchanged.
+     *  @param   recv_data A reference to the variable in which to put received
+     *           data
+     */
+    void ISR_get (DataType& recv_data)
+    {
+        read (recv_data);
+    }
+
+    /** @brief   Read and return data from the shared data item, from within an
+     *           ISR.
+     *  @returns A copy of the most recently written data
+     */
+    DataType ISR_get (void)
+    {
+        DataType return_this;
+        read (return_this);
+        return return_this;
+    }
+
+    // Print the share's status within a list of all shares' statuses
+    void print_in_list (Print& printer);
+
+}; // class FastShare<DataType>
+
+
+/** @brief   Print the name and type of this data item.
+ *  @details This method prints the share's name, the word @c fast to show
+ *           that it is a lock-free share, and how many times it has been
+ *           written. It then asks the next item in the linked list of shares
+ *           to print its information too.
+ *  @param   printer Reference to a serial device on which to print the status
+ */
+template <class DataType>
+void FastShare<DataType>::print_in_list (Print& printer)
+{
+    // Print this share's name and pad it to 16 characters
+    printer.printf ("%-16sfast\t", name);
+
+    // Each write advances the sequence counter by two
+    printer << (sequence.load (std::memory_order_relaxed) / 2);
+
+    // Add the usage statistics if they're being kept
+    SHARE_STATS_PRINT (printer);
+    printer << endl;
+
+    // Call the next item
+    if (p_next != NULL)
+    {
+        p_next->print_in_list (printer);
+    }
+}
+
+#endif  // _FASTSHARE_H_
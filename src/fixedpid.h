@@ -0,0 +1,221 @@
+/** @file    fixedpid.h
+ *  @brief   Fixed-point PID controller template.
+ *  @details This file contains a PID controller which does all of its work in
+ *           32-bit fixed-point numbers with a 64-bit intermediate, so it needs
+ *           no floating point unit. That makes it cheap to run from a timer
+ *           ISR, where the ESP32 would otherwise have to save the FPU's
+ *           registers, and makes its results the same on every run. The
+ *           number of fraction bits is a template parameter: @c PID<16> works
+ *           in Q16.16 (range +/-32768, resolution 1.5e-5) and @c PID<24> in
+ *           Q8.24 (range +/-128, resolution 6e-8). The output is clamped to a
+ *           given range and the integrator stops growing while the output is
+ *           saturated, so the clamping which callers used to do by hand is
+ *           built in and the integral can't wind up.
+ *
+ *           The gains may be set when the program runs, as with
+ *           @c PIDController, or fixed when it is compiled by giving a
+ *           @c ConstGains type as the second template parameter, which lets
+ *           the compiler fold them into the code.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#ifndef _FIXEDPID_H_
+#define _FIXEDPID_H_
+
+#include <Arduino.h>
+
+
+/** @brief   Convert a number to fixed point, rounding to the nearest step.
+ *  @details The value must be within the range of the fixed-point format.
+ *           This function can be evaluated at compile time.
+ *  @param   value The number to be converted
+ *  @returns The number in fixed point with @c FRAC_BITS fraction bits
+ */
+template <uint8_t FRAC_BITS>
+constexpr int32_t to_fixed (float value)
+{
+    return (int32_t)(value * (float)(1L << FRAC_BITS)
+                     + ((value >= 0.0f) ? 0.5f : -0.5f));
+}
+
+
+/** @brief   Convert a fixed-point number to a float.
+ *  @param   value The fixed-point number with @c FRAC_BITS fraction bits
+ *  @returns The number as a float
+ */
+template <uint8_t FRAC_BITS>
+inline float from_fixed (int32_t value)
+{
+    return (float)value * (1.0f / (float)(1L << FRAC_BITS));
+}
+
+
+/** @brief   PID gains which are set while the program runs.
+ *  @details The integral and derivative gains are stored already multiplied
+ *           and divided by the sample interval, so that an update needs no
+ *           division.
+ */
+template <uint8_t FRAC_BITS> class PIDGains
+{
+protected:
+    int32_t kp;                     ///< Proportional gain
+    int32_t ki;                     ///< Integral gain times the interval
+    int32_t kd;                     ///< Derivative gain over the interval
+
+public:
+    /** @brief   Set the gains.
+     *  @param   Kp Proportional gain
+     *  @param   Ki Integral gain
+     *  @param   Kd Derivative gain
+     *  @param   dt Interval at which the controller is run
+     */
+    void set_gains (float Kp, float Ki, float Kd, float dt)
+    {
+        kp = to_fixed<FRAC_BITS> (Kp);
+        ki = to_fixed<FRAC_BITS> (Ki * dt);
+        kd = to_fixed<FRAC_BITS> (Kd / dt);
+    }
+};
+
+
+/** @brief   PID gains which are fixed when the program is compiled.
+ *  @details Each gain is given in the controller's fixed-point format, with
+ *           the integral gain multiplied by the sample interval and the
+ *           derivative gain divided by it, for example
+ *           @code
+ *           // Kp = 3, Ki = 0.5, Kd = 0.1 at 20 Hz, in Q16.16
+ *           PID<16, ConstGains<to_fixed<16> (3.0f), to_fixed<16> (0.5f * 0.05f),
+ *                              to_fixed<16> (0.1f / 0.05f)> > pid (-100, 100);
+ *           @endcode
+ */
+template <int32_t KP, int32_t KI_DT, int32_t KD_DT> class ConstGains
+{
+protected:
+    static constexpr int32_t kp = KP;       ///< Proportional gain
+    static constexpr int32_t ki = KI_DT;    ///< Integral gain times interval
+    static constexpr int32_t kd = KD_DT;    ///< Derivative gain over interval
+
+public:
+    /// The gains can't be changed; this is here so both kinds look the same
+    void set_gains (float, float, float, float)
+    {
+    }
+};
+
+
+/** @brief   Fixed-point PID controller with output clamping and anti-windup.
+ *  @details Inputs and output are in fixed point with @c FRAC_BITS fraction
+ *           bits; use @c to_fixed() and @c from_fixed() or @c to_int() to
+ *           convert. Products and sums are formed in 64 bits, so intermediate
+ *           terms may exceed the format's range as long as the clamped output
+ *           fits in it.
+ *
+ *           The integral term is kept in output units and clamped to the
+ *           output range. When the output is saturated, the integral is only
+ *           updated if the error would pull the output back into range
+ *           (conditional integration).
+ *
+ *           @section usage_fixedpid Usage
+ *           @code
+ *           PID<16> elev2duty (3, 0, 0, 0.05, -100, 100);
+ *           ...
+ *           int16_t duty = PID<16>::to_int (
+ *               elev2duty.update (to_fixed<16> (angle), to_fixed<16> (angle_goal)));
+ *           @endcode
+ */
+template <uint8_t FRAC_BITS, class Gains = PIDGains<FRAC_BITS> >
+class PID : public Gains
+{
+    static_assert (FRAC_BITS > 0 && FRAC_BITS < 31,
+                   "PID needs between 1 and 30 fraction bits");
+
+protected:
+    int32_t out_min;                ///< Lowest output
+    int32_t out_max;                ///< Highest output
+    int32_t integral;               ///< Integral term, in output units
+    int32_t err_prev;               ///< Error at the previous update
+
+    /// Limit a 64-bit number to the output range
+    int32_t clamp (int64_t value)
+    {
+        return (value > out_max) ? out_max
+               : (value < out_min) ? out_min : (int32_t)value;
+    }
+
+public:
+    /** @brief   Create a controller whose gains are set when it runs.
+     *  @param   Kp Proportional gain
+     *  @param   Ki Integral gain
+     *  @param   Kd Derivative gain
+     *  @param   dt Interval at which the controller is run
+     *  @param   min_out Lowest output
+     *  @param   max_out Highest output
+     */
+    PID (float Kp, float Ki, float Kd, float dt, float min_out, float max_out)
+        : out_min (to_fixed<FRAC_BITS> (min_out)),
+          out_max (to_fixed<FRAC_BITS> (max_out)), integral (0), err_prev (0)
+    {
+        this->set_gains (Kp, Ki, Kd, dt);
+    }
+
+    /** @brief   Create a controller whose gains were fixed at compile time.
+     *  @param   min_out Lowest output
+     *  @param   max_out Highest output
+     */
+    PID (float min_out, float max_out)
+        : out_min (to_fixed<FRAC_BITS> (min_out)),
+          out_max (to_fixed<FRAC_BITS> (max_out)), integral (0), err_prev (0)
+    {
+    }
+
+    /** @brief   Run the controller once.
+     *  @param   current The measured value
+     *  @param   desired The value it should have
+     *  @returns The controller output, clamped to the output range
+     */
+    int32_t update (int32_t current, int32_t desired)
+    {
+        int64_t err = (int64_t)desired - current;
+
+        int64_t p_term = (Gains::kp * err) >> FRAC_BITS;
+        int64_t d_term = (Gains::kd * (err - err_prev)) >> FRAC_BITS;
+        int32_t new_integral = clamp (integral + ((Gains::ki * err) >> FRAC_BITS));
+
+        int64_t output = p_term + new_integral + d_term;
+
+        // Don't let the integral push further into saturation
+        if ((output > out_max && err > 0) || (output < out_min && err < 0))
+        {
+            output = p_term + integral + d_term;
+        }
+        else
+        {
+            integral = new_integral;
+        }
+
+        err_prev = (err > INT32_MAX) ? INT32_MAX
+                   : (err < INT32_MIN) ? INT32_MIN : (int32_t)err;
+        return clamp (output);
+    }
+
+    /** @brief   Clear the integral and the previous error.
+     */
+    void reset (void)
+    {
+        integral = 0;
+        err_prev = 0;
+    }
+
+    /** @brief   Round a fixed-point number to the nearest integer.
+     *  @param   value The fixed-point number
+     *  @returns The nearest integer, with halves rounded up
+     */
+    static int32_t to_int (int32_t value)
+    {
+        return (value + (1L << (FRAC_BITS - 1))) >> FRAC_BITS;
+    }
+};
+
+#endif // _FIXEDPID_H_
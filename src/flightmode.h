@@ -0,0 +1,78 @@
+/** @file flightmode.h
+ *  @brief The states and events of the glider's flight mode state machine,
+ *         which the web handlers and sensor tasks post events to.
+ *
+ *  @author ME 507 Airheads
+ *  @date 2026-Oct-16 Original file
+ */
+
+#ifndef _FLIGHTMODE_H_
+#define _FLIGHTMODE_H_
+
+#include "statemachine.h"
+
+/// States of the flight mode machine; the numbers are also put in @c tc_state
+enum FlightState : uint8_t
+{
+    ST_DISABLED = 0,        ///< Motors off, waiting to be armed from the webpage
+    ST_WAIT_FOR_LAUNCH = 1, ///< Armed, waiting to be away from the ground for a while
+    ST_ACTIVE = 2,          ///< Attitude and servo loops flying the glider
+    NUM_FLIGHT_STATES
+};
+
+/// Events which drive the flight mode machine
+enum FlightEvent : uint8_t
+{
+    EV_ACTIVATE,            ///< The webpage armed the controller
+    EV_DEACTIVATE,          ///< The webpage disarmed the controller
+    EV_CALIBRATE,           ///< The webpage asked for the potentiometers to be zeroed
+    EV_GROUND_REACHED,      ///< The ultrasonic sensor came within range of the ground
+    EV_GROUND_LEFT,         ///< The ultrasonic sensor went out of range of the ground
+    EV_TIMEOUT,             ///< The machine's timer ran out
+    NUM_FLIGHT_EVENTS
+};
+
+/// What a task's look at the flight state shows, from @c FlightEdges::update()
+enum FlightEdge : uint8_t
+{
+    FLIGHT_SAME,            ///< Still in a flight, or still out of one
+    FLIGHT_STARTED,         ///< The machine has entered ST_ACTIVE since the last look
+    FLIGHT_ENDED            ///< The machine has left ST_ACTIVE since the last look
+};
+
+/** @brief   Class which tells a task when a flight starts and ends.
+ *  @details A flight is the time the machine spends in @c ST_ACTIVE. Each
+ *           task which reports statistics per flight passes every state it
+ *           reads to its own one of these, resets the statistics when the
+ *           flight starts and prints them when it ends, so that all of the
+ *           reports agree on when a flight ends.
+ */
+class FlightEdges
+{
+protected:
+    bool flying;            ///< True if the last state seen was ST_ACTIVE
+
+public:
+    /** @brief   Create a helper which starts out of a flight.
+     */
+    FlightEdges (void) : flying (false) { }
+
+    /** @brief   Look at the flight state.
+     *  @param   state The state, as read from @c tc_state
+     *  @returns Whether a flight has started or ended since the last look
+     */
+    FlightEdge update (uint8_t state)
+    {
+        bool active = (state == ST_ACTIVE);
+        if (active == flying)
+        {
+            return FLIGHT_SAME;
+        }
+        flying = active;
+        return flying ? FLIGHT_STARTED : FLIGHT_ENDED;
+    }
+};
+
+extern StateMachine flight_mode;    ///< The flight mode state machine
+
+#endif // _FLIGHTMODE_H_
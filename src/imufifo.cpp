@@ -0,0 +1,154 @@
+/** @file imufifo.cpp
+ *  @brief This is the source file containing the constructor and methods for
+ *         a decoder of LSM6DSOX FIFO words.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include "imufifo.h"
+
+// Values of the TAG_SENSOR field, the top five bits of each FIFO tag byte
+#define TAG_GYRO 0x01               ///< Gyroscope, not compressed
+#define TAG_ACCEL 0x02              ///< Accelerometer, not compressed
+#define TAG_TIMESTAMP 0x04          ///< Timestamp
+
+/** @brief   Constructor which sets up a decoder for the sensors' settings
+ *  @param   gyro_per_count Gyro rate of one count at the set range (rad/s)
+ *  @param   accel_per_count Acceleration of one count at the set range (m/s^2)
+ *  @param   sample_rate Nominal output data rate, used until the sensor's
+ *           actual sample period has been measured (Hz)
+ */
+ImuFifoDecoder::ImuFifoDecoder(float gyro_per_count, float accel_per_count,
+                               float sample_rate)
+{
+    gyro_scale = gyro_per_count;
+    accel_scale = accel_per_count;
+    sync_us = 0;
+    sync_ticks = 0;
+    have_sync = false;
+    us_per_tick = IMU_TIMESTAMP_US;
+    stamp_ticks = 0;
+    since_stamp = 0;
+    have_stamp = false;
+    nominal_ticks = 1e6f / (sample_rate * IMU_TIMESTAMP_US);
+    period_ticks = nominal_ticks;
+    have_gyro = false;
+    have_accel = false;
+    current = {};
+}
+
+/** @brief   Ties the sensor's timestamp counter to the micros() clock
+ *  @details This should be called with the sensor's timestamp registers,
+ *           read in the same transaction as the FIFO level, before the words
+ *           of a batch are decoded. The time between this batch and the last
+ *           one also refines the length of the sensor's counts; a measurement
+ *           more than 10% from nominal, as after a long gap, is ignored.
+ *  @param   now_us The value of micros() when the registers were read
+ *  @param   sensor_ticks The sensor's timestamp counter at that time
+ */
+void ImuFifoDecoder::begin_batch(uint32_t now_us, uint32_t sensor_ticks)
+{
+    // Average the length of a count over many batches, since the time of each
+    // read jitters by the I2C transfer and by preemption
+    uint32_t ticks = sensor_ticks - sync_ticks;
+    if (have_sync && ticks > 0)
+    {
+        float measured = (float)(now_us - sync_us) / ticks;
+        if (measured > 0.9f * IMU_TIMESTAMP_US && measured < 1.1f * IMU_TIMESTAMP_US)
+        {
+            us_per_tick += 0.05f * (measured - us_per_tick);
+        }
+    }
+    sync_us = now_us;
+    sync_ticks = sensor_ticks;
+    have_sync = true;
+}
+
+/** @brief   Forgets the sample count and pairing after the FIFO lost words
+ *  @details This should be called when the FIFO's overrun flag is set, after
+ *           @c begin_batch() and before the batch's words are decoded. The
+ *           words which were overwritten may have held timestamps and either
+ *           half of a sample, so the samples until the next timestamp word
+ *           cannot be timed and are dropped. The sample period measured so
+ *           far is kept.
+ */
+void ImuFifoDecoder::overrun(void)
+{
+    since_stamp = 0;
+    have_stamp = false;
+    have_gyro = false;
+    have_accel = false;
+}
+
+/** @brief   Decodes one FIFO word
+ *  @details Words of other kinds, such as temperature or configuration
+ *           changes, are skipped.
+ *  @param   p_word Pointer to the seven bytes of the word, tag first
+ *  @returns True if this word completed a sample, which sample() returns
+ */
+bool ImuFifoDecoder::decode(const uint8_t* p_word)
+{
+    const uint8_t* p_data = p_word + 1;
+    int16_t x = (int16_t)(p_data[1] << 8 | p_data[0]);
+    int16_t y = (int16_t)(p_data[3] << 8 | p_data[2]);
+    int16_t z = (int16_t)(p_data[5] << 8 | p_data[4]);
+
+    switch (p_word[0] >> 3)
+    {
+        case TAG_TIMESTAMP:
+        {
+            uint32_t ticks = (uint32_t)p_data[3] << 24 | (uint32_t)p_data[2] << 16
+                             | (uint32_t)p_data[1] << 8 | p_data[0];
+            // Measure the sensor's sample period between two timestamps,
+            // ignoring a measurement more than 10% from nominal, as across
+            // words lost without an overrun being seen
+            if (have_stamp && since_stamp > 0)
+            {
+                float measured = (float)(ticks - stamp_ticks) / since_stamp;
+                if (measured > 0.9f * nominal_ticks && measured < 1.1f * nominal_ticks)
+                {
+                    period_ticks = measured;
+                }
+            }
+            stamp_ticks = ticks;
+            since_stamp = 0;
+            have_stamp = true;
+            have_gyro = false;
+            have_accel = false;
+            return false;
+        }
+        case TAG_GYRO:
+            current.gx = x * gyro_scale;
+            current.gy = y * gyro_scale;
+            current.gz = z * gyro_scale;
+            have_gyro = true;
+            break;
+        case TAG_ACCEL:
+            current.ax = x * accel_scale;
+            current.ay = y * accel_scale;
+            current.az = z * accel_scale;
+            have_accel = true;
+            break;
+        default:
+            return false;
+    }
+
+    if (!have_gyro || !have_accel)
+    {
+        return false;
+    }
+    have_gyro = false;
+    have_accel = false;
+    if (!have_stamp)
+    {
+        return false;
+    }
+
+    // Unsigned subtraction gives the age across a wrap of either counter
+    uint32_t ticks = stamp_ticks + (uint32_t)(since_stamp * period_ticks + 0.5f);
+    current.time_us = sync_us - (uint32_t)((sync_ticks - ticks) * us_per_tick + 0.5f);
+    since_stamp++;
+    return true;
+}
@@ -0,0 +1,93 @@
+/** @file imufifo.h
+ *  @brief The header file for a decoder which turns the words read from the
+ *         LSM6DSOX's FIFO into timestamped gyro and accelerometer samples.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// Compile this header file only once
+#ifndef _IMUFIFO_H_
+#define _IMUFIFO_H_
+
+#include <Arduino.h>
+
+/// Bytes in one FIFO word: a tag byte followed by six data bytes
+#define IMU_FIFO_WORD_SIZE 7
+
+/// Microseconds per count of the LSM6DSOX's timestamp counter
+#define IMU_TIMESTAMP_US 25
+
+/// Samples per timestamp word; the FIFO_CTRL4 DEC_TS_BATCH setting
+#define IMU_TIMESTAMP_DECIMATION 8
+
+/// One gyro and accelerometer sample taken from the FIFO
+struct ImuSample
+{
+    uint32_t time_us;       ///< When the sample was taken, on the micros() clock (us)
+    float gx, gy, gz;       ///< Gyro rates (rad/s)
+    float ax, ay, az;       ///< Accelerometer readings (m/s^2)
+};
+
+/** @brief  Class which decodes LSM6DSOX FIFO words into samples.
+ *  @details The FIFO holds a gyro word and an accelerometer word for each
+ *           sample, in either order, and a timestamp word before every
+ *           IMU_TIMESTAMP_DECIMATION'th sample. Each word's tag says which it
+ *           is. A sample is complete once both its gyro and accelerometer
+ *           words have arrived. The first sample after a timestamp word has
+ *           that word's time, and the ones after it follow at the sensor's
+ *           sample period, which is measured from successive timestamps in
+ *           the sensor's own clock. Samples before the first timestamp word
+ *           cannot be timed and are dropped, as are those after the FIFO
+ *           has overrun until the next timestamp word, because the count of
+ *           samples since the last one is lost with the overwritten words.
+ *
+ *           The sensor's timestamp counter runs from its own oscillator, so
+ *           it is put onto the micros() clock afresh for every batch. The
+ *           counter is read along with the FIFO level just before the batch
+ *           is drained, and each sample's time is the time of that read less
+ *           the sample's age by the sensor's counter. This way the ESP32's
+ *           and the sensor's clocks never drift apart. The length of a count,
+ *           nominally IMU_TIMESTAMP_US but off by up to a few percent, is
+ *           measured on the micros() clock between batches so that the ages
+ *           are right too.
+ */
+class ImuFifoDecoder
+{
+protected:
+    float gyro_scale;           ///< Gyro rate per count (rad/s)
+    float accel_scale;          ///< Acceleration per count (m/s^2)
+    uint32_t sync_us;           ///< micros() when the batch's status was read
+    uint32_t sync_ticks;        ///< Sensor timestamp when the batch's status was read
+    bool have_sync;             ///< True once one batch has been started
+    float us_per_tick;          ///< Length of one timestamp count on the micros() clock (us)
+    uint32_t stamp_ticks;       ///< Sensor timestamp in the last timestamp word
+    uint16_t since_stamp;       ///< Samples completed since the last timestamp word
+    bool have_stamp;            ///< True once a timestamp word has arrived
+    float period_ticks;         ///< Sensor timestamp counts per sample
+    float nominal_ticks;        ///< Timestamp counts per sample at the nominal data rate
+    bool have_gyro;             ///< True once the current sample's gyro word arrived
+    bool have_accel;            ///< True once the current sample's accelerometer word arrived
+    ImuSample current;          ///< The sample being built
+
+public:
+    // Set up a decoder for the sensors' full scale ranges and data rate
+    ImuFifoDecoder(float gyro_per_count, float accel_per_count,
+                   float sample_rate);
+
+    // Tie the sensor's timestamp counter to the micros() clock for one batch
+    void begin_batch(uint32_t now_us, uint32_t sensor_ticks);
+
+    // Forget the sample count and pairing after the FIFO lost words
+    void overrun(void);
+
+    // Decode one FIFO word, returning true when it completes a sample
+    bool decode(const uint8_t* p_word);
+
+    /** @brief   Returns the sample which the last call to decode() completed.
+     *  @returns A reference to the completed sample
+     */
+    const ImuSample& sample(void) { return current; }
+};
+
+#endif // _IMUFIFO_H_
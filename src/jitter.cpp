@@ -0,0 +1,102 @@
+/** @file jitter.cpp
+ *  @brief This is the source file containing the constructor and methods for
+ *         a histogram of a periodic loop's timing errors.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include "jitter.h"
+
+/** @brief   Constructor which creates an empty jitter histogram
+ *  @param   period_us The nominal period of the loop being measured (us)
+ */
+JitterHistogram::JitterHistogram(uint32_t period_us)
+{
+    nominal_us = period_us;
+    reset();
+}
+
+/** @brief   Adds one measured interval to the histogram
+ *  @param   interval_us The time between two runs of the loop (us)
+ */
+void JitterHistogram::record(uint32_t interval_us)
+{
+    uint32_t error = (interval_us > nominal_us) ? interval_us - nominal_us
+                                                : nominal_us - interval_us;
+
+    // Find the first bin whose limit is above the error
+    uint8_t bin = 0;
+    while (bin < JITTER_BINS - 1 && error >= bin_limit(bin))
+    {
+        bin++;
+    }
+    counts[bin]++;
+
+    if (interval_us < shortest_us)
+    {
+        shortest_us = interval_us;
+    }
+    if (interval_us > longest_us)
+    {
+        longest_us = interval_us;
+    }
+}
+
+/** @brief   Empties the histogram
+ */
+void JitterHistogram::reset(void)
+{
+    for (uint8_t bin = 0; bin < JITTER_BINS; bin++)
+    {
+        counts[bin] = 0;
+    }
+    shortest_us = UINT32_MAX;
+    longest_us = 0;
+}
+
+/** @brief   Changes the nominal period and empties the histogram
+ *  @param   period_us The nominal period of the loop being measured (us)
+ */
+void JitterHistogram::set_period(uint32_t period_us)
+{
+    nominal_us = period_us;
+    reset();
+}
+
+/** @brief   Returns the upper limit of the timing error counted in one bin
+ *  @details The limits are 10, 50, 100 and 500 us and 1, 5 and 10 ms; the
+ *           last bin has no limit. A one-tick error in @c vTaskDelay() lands
+ *           in the 1 to 5 ms bin.
+ *  @param   bin The bin number, from 0 to @c JITTER_BINS - 2
+ *  @returns The error (us) below which intervals are counted in the bin
+ */
+uint32_t JitterHistogram::bin_limit(uint8_t bin)
+{
+    static const uint32_t limits[JITTER_BINS - 1] =
+        { 10, 50, 100, 500, 1000, 5000, 10000 };
+
+    return limits[bin];
+}
+
+/** @brief   Prints the histogram on one line
+ *  @details The counts are printed in bin order after the label, followed by
+ *           the shortest and longest intervals.
+ *  @param   printer The serial device on which to print
+ *  @param   label A name for the loop which is printed first
+ */
+void JitterHistogram::print(Print& printer, const char* label)
+{
+    printer.printf("%s jitter (<10 <50 <100 <500 <1k <5k <10k more us):", label);
+    for (uint8_t bin = 0; bin < JITTER_BINS; bin++)
+    {
+        printer.printf(" %u", (unsigned)counts[bin]);
+    }
+    if (longest_us > 0)
+    {
+        printer.printf("; interval %u to %u us", (unsigned)shortest_us,
+                       (unsigned)longest_us);
+    }
+    printer.println();
+}
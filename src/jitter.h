@@ -0,0 +1,63 @@
+/** @file jitter.h
+ *  @brief The header file for a histogram of how far a periodic loop's
+ *         measured intervals stray from its nominal period.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// Compile this header file only once
+#ifndef _JITTER_H_
+#define _JITTER_H_
+
+#include <Arduino.h>
+
+/// Number of bins in a jitter histogram
+#define JITTER_BINS 8
+
+/** @brief  Class which counts a loop's intervals by how far they are from
+ *          the nominal period.
+ *  @details Bin @c n counts intervals whose error is below @c bin_limit(n)
+ *           microseconds, and the last bin counts everything larger. The
+ *           longest and shortest intervals are kept as well.
+ */
+class JitterHistogram
+{
+protected:
+    uint32_t nominal_us;                        ///< The period the loop should run at (us)
+    uint32_t counts[JITTER_BINS];               ///< Number of intervals in each bin
+    uint32_t shortest_us;                       ///< Shortest interval recorded (us)
+    uint32_t longest_us;                        ///< Longest interval recorded (us)
+
+public:
+    // Set up an empty histogram for a loop with the given period
+    JitterHistogram(uint32_t period_us);
+
+    // Add one measured interval to the histogram
+    void record(uint32_t interval_us);
+
+    // Empty the histogram
+    void reset(void);
+
+    // Change the nominal period and empty the histogram
+    void set_period(uint32_t period_us);
+
+    // Upper limit of the error in one bin
+    static uint32_t bin_limit(uint8_t bin);
+
+    /** @brief   Return the number of intervals in one bin.
+     *  @param   bin The bin number, from 0 to @c JITTER_BINS - 1
+     *  @returns How many intervals were counted in the bin
+     */
+    uint32_t count(uint8_t bin) { return counts[bin]; }
+
+    /** @brief   Return the nominal period.
+     *  @returns The period the loop should run at (us)
+     */
+    uint32_t period(void) { return nominal_us; }
+
+    // Print the histogram on one line
+    void print(Print& printer, const char* label);
+};
+
+#endif // _JITTER_H_
@@ -0,0 +1,263 @@
+/** @file mahony.cpp
+ *  @brief This is the source file containing the constructor and methods for
+ *         a Mahony attitude estimator.
+ *  @details The update equations follow S. Madgwick's open source
+ *           implementation of R. Mahony's nonlinear complementary filter,
+ *           with the time step passed in at each update.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include "mahony.h"
+#include "fastmath.h"
+
+/** @brief   Constructor which creates a filter at a level attitude
+ *  @param   kp Proportional gain; larger values trust the accelerometer and
+ *           magnetometer more and the gyro less
+ *  @param   ki Integral gain, which estimates the gyro bias; zero disables it
+ */
+MahonyFilter::MahonyFilter(float kp, float ki)
+{
+    q0 = 1;
+    q1 = 0;
+    q2 = 0;
+    q3 = 0;
+    two_kp = 2 * kp;
+    two_ki = 2 * ki;
+    bias_x = 0;
+    bias_y = 0;
+    bias_z = 0;
+}
+
+/** @brief   Starts the filter at the attitude given by one set of readings
+ *  @details Roll and pitch are found from the direction of gravity and yaw
+ *           from the tilt compensated magnetometer, so that the filter does
+ *           not have to converge from level at power up. If the
+ *           magnetometer reading is all zeros, yaw starts at zero.
+ *  @param   ax Accelerometer reading, x axis
+ *  @param   ay Accelerometer reading, y axis
+ *  @param   az Accelerometer reading, z axis
+ *  @param   mx Magnetometer reading, x axis
+ *  @param   my Magnetometer reading, y axis
+ *  @param   mz Magnetometer reading, z axis
+ */
+void MahonyFilter::init(float ax, float ay, float az, float mx, float my, float mz)
+{
+    float roll = fast_atan2(ay, az);
+    float pitch = fast_atan2(-ax, fast_sqrt(ay * ay + az * az));
+    float yaw = 0;
+
+    if (mx != 0 || my != 0 || mz != 0)
+    {
+        // Rotate the field back to level, then measure its heading
+        float sr, cr, sp, cp;
+        fast_sincos(roll, sr, cr);
+        fast_sincos(pitch, sp, cp);
+        float level_x = mx * cp + (my * sr + mz * cr) * sp;
+        float level_y = my * cr - mz * sr;
+        yaw = fast_atan2(-level_y, level_x);
+    }
+
+    float cr, sr, cp, sp, cy, sy;
+    fast_sincos(roll / 2, sr, cr);
+    fast_sincos(pitch / 2, sp, cp);
+    fast_sincos(yaw / 2, sy, cy);
+    q0 = cr * cp * cy + sr * sp * sy;
+    q1 = sr * cp * cy - cr * sp * sy;
+    q2 = cr * sp * cy + sr * cp * sy;
+    q3 = cr * cp * sy - sr * sp * cy;
+
+    bias_x = 0;
+    bias_y = 0;
+    bias_z = 0;
+}
+
+/** @brief   Fuses gyro, accelerometer and magnetometer readings
+ *  @details If the magnetometer reading is all zeros (no new reading), only
+ *           the gyro and accelerometer are used. If the accelerometer reading
+ *           is all zeros, the gyro is integrated alone.
+ *  @param   gx Gyro rate about the x axis (rad/s)
+ *  @param   gy Gyro rate about the y axis (rad/s)
+ *  @param   gz Gyro rate about the z axis (rad/s)
+ *  @param   ax Accelerometer reading, x axis
+ *  @param   ay Accelerometer reading, y axis
+ *  @param   az Accelerometer reading, z axis
+ *  @param   mx Magnetometer reading, x axis
+ *  @param   my Magnetometer reading, y axis
+ *  @param   mz Magnetometer reading, z axis
+ *  @param   dt Time since the previous update (s)
+ */
+void MahonyFilter::update(float gx, float gy, float gz, float ax, float ay,
+                          float az, float mx, float my, float mz, float dt)
+{
+    if (mx == 0 && my == 0 && mz == 0)
+    {
+        update_imu(gx, gy, gz, ax, ay, az, dt);
+        return;
+    }
+    if (ax == 0 && ay == 0 && az == 0)
+    {
+        integrate(gx, gy, gz, dt);
+        return;
+    }
+
+    float norm = fast_inv_sqrt(ax * ax + ay * ay + az * az);
+    ax *= norm;
+    ay *= norm;
+    az *= norm;
+    norm = fast_inv_sqrt(mx * mx + my * my + mz * mz);
+    mx *= norm;
+    my *= norm;
+    mz *= norm;
+
+    float q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+    float q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+    float q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+    // Direction of the Earth's field in the Earth frame, with its horizontal
+    // part along north
+    float hx = 2 * (mx * (0.5f - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2));
+    float hy = 2 * (mx * (q1q2 + q0q3) + my * (0.5f - q1q1 - q3q3) + mz * (q2q3 - q0q1));
+    float bx = fast_sqrt(hx * hx + hy * hy);
+    float bz = 2 * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (0.5f - q1q1 - q2q2));
+
+    // Half the directions of gravity and of the field which the attitude predicts
+    float half_vx = q1q3 - q0q2;
+    float half_vy = q0q1 + q2q3;
+    float half_vz = q0q0 - 0.5f + q3q3;
+    float half_wx = bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+    float half_wy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+    float half_wz = bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2);
+
+    // Error is the cross product of measured and predicted directions
+    float half_ex = (ay * half_vz - az * half_vy) + (my * half_wz - mz * half_wy);
+    float half_ey = (az * half_vx - ax * half_vz) + (mz * half_wx - mx * half_wz);
+    float half_ez = (ax * half_vy - ay * half_vx) + (mx * half_wy - my * half_wx);
+
+    if (two_ki > 0)
+    {
+        bias_x += two_ki * half_ex * dt;
+        bias_y += two_ki * half_ey * dt;
+        bias_z += two_ki * half_ez * dt;
+    }
+    gx += bias_x + two_kp * half_ex;
+    gy += bias_y + two_kp * half_ey;
+    gz += bias_z + two_kp * half_ez;
+
+    integrate(gx, gy, gz, dt);
+}
+
+/** @brief   Fuses gyro and accelerometer readings only
+ *  @details Roll and pitch are corrected by the accelerometer; yaw is the
+ *           integrated gyro rate and will drift.
+ *  @param   gx Gyro rate about the x axis (rad/s)
+ *  @param   gy Gyro rate about the y axis (rad/s)
+ *  @param   gz Gyro rate about the z axis (rad/s)
+ *  @param   ax Accelerometer reading, x axis
+ *  @param   ay Accelerometer reading, y axis
+ *  @param   az Accelerometer reading, z axis
+ *  @param   dt Time since the previous update (s)
+ */
+void MahonyFilter::update_imu(float gx, float gy, float gz, float ax, float ay,
+                              float az, float dt)
+{
+    if (ax != 0 || ay != 0 || az != 0)
+    {
+        float norm = fast_inv_sqrt(ax * ax + ay * ay + az * az);
+        ax *= norm;
+        ay *= norm;
+        az *= norm;
+
+        float half_vx = q1 * q3 - q0 * q2;
+        float half_vy = q0 * q1 + q2 * q3;
+        float half_vz = q0 * q0 - 0.5f + q3 * q3;
+
+        float half_ex = ay * half_vz - az * half_vy;
+        float half_ey = az * half_vx - ax * half_vz;
+        float half_ez = ax * half_vy - ay * half_vx;
+
+        if (two_ki > 0)
+        {
+            bias_x += two_ki * half_ex * dt;
+            bias_y += two_ki * half_ey * dt;
+            bias_z += two_ki * half_ez * dt;
+        }
+        gx += bias_x + two_kp * half_ex;
+        gy += bias_y + two_kp * half_ey;
+        gz += bias_z + two_kp * half_ez;
+    }
+
+    integrate(gx, gy, gz, dt);
+}
+
+/** @brief   Rotates the quaternion by the corrected gyro rates over one step
+ *  @param   gx Rate about the x axis (rad/s)
+ *  @param   gy Rate about the y axis (rad/s)
+ *  @param   gz Rate about the z axis (rad/s)
+ *  @param   dt Length of the step (s)
+ */
+void MahonyFilter::integrate(float gx, float gy, float gz, float dt)
+{
+    gx *= 0.5f * dt;
+    gy *= 0.5f * dt;
+    gz *= 0.5f * dt;
+
+    float qa = q0, qb = q1, qc = q2;
+    q0 += -qb * gx - qc * gy - q3 * gz;
+    q1 += qa * gx + qc * gz - q3 * gy;
+    q2 += qa * gy - qb * gz + q3 * gx;
+    q3 += qa * gz + qb * gy - qc * gx;
+
+    float norm = fast_inv_sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q0 *= norm;
+    q1 *= norm;
+    q2 *= norm;
+    q3 *= norm;
+}
+
+/** @brief   Returns the roll angle, about the sensor's x axis
+ *  @returns The roll angle (rad)
+ */
+float MahonyFilter::get_roll(void)
+{
+    return fast_atan2(q0 * q1 + q2 * q3, 0.5f - q1 * q1 - q2 * q2);
+}
+
+/** @brief   Returns the pitch angle, about the sensor's y axis
+ *  @returns The pitch angle (rad)
+ */
+float MahonyFilter::get_pitch(void)
+{
+    float sin_pitch = -2 * (q1 * q3 - q0 * q2);
+    sin_pitch = (sin_pitch > 1) ? 1 : ((sin_pitch < -1) ? -1 : sin_pitch);
+    // fast_asin() is slower than asinf() on the host; keep libm until
+    // FASTMATH_CYCLES shows it faster on the ESP32
+    return asinf(sin_pitch);
+}
+
+/** @brief   Returns the yaw angle, about the Earth's vertical
+ *  @returns The yaw angle (rad), zero when the x axis points along the
+ *           horizontal part of the Earth's field
+ */
+float MahonyFilter::get_yaw(void)
+{
+    return fast_atan2(q1 * q2 + q0 * q3, 0.5f - q2 * q2 - q3 * q3);
+}
+
+/** @brief   Returns the upward part of a vector measured in the sensor frame
+ *  @details This is the bottom row of the rotation from the sensor frame to
+ *           the Earth frame, in which +z is up. For an accelerometer reading
+ *           it is the upward acceleration plus gravity.
+ *  @param   x The vector's x component
+ *  @param   y The vector's y component
+ *  @param   z The vector's z component
+ *  @returns The vector's component along the Earth's vertical
+ */
+float MahonyFilter::get_vertical(float x, float y, float z)
+{
+    return 2 * (q1 * q3 - q0 * q2) * x + 2 * (q2 * q3 + q0 * q1) * y
+           + (1 - 2 * (q1 * q1 + q2 * q2)) * z;
+}
@@ -0,0 +1,70 @@
+/** @file mahony.h
+ *  @brief The header file for a Mahony attitude estimator which fuses gyro,
+ *         accelerometer and magnetometer readings into a quaternion.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// Compile this header file only once
+#ifndef _MAHONY_H_
+#define _MAHONY_H_
+
+#include <Arduino.h>
+
+/** @brief  Class for a Mahony complementary filter on the rotation group.
+ *  @details The gyro rates are integrated into an attitude quaternion at every
+ *           update. The directions of gravity and of the Earth's magnetic
+ *           field which that attitude predicts are compared with the
+ *           accelerometer and magnetometer readings, and the cross products
+ *           (the rotation which would line them up) are fed back into the
+ *           rates through a proportional gain, which sets how quickly the
+ *           gyro's drift is corrected, and an integral gain, which learns
+ *           the gyro's bias. Readings may be in any units, since only their
+ *           directions are used. The sensor frame is right handed with its
+ *           accelerometer reading +z when level; angles follow the usual
+ *           yaw-pitch-roll (Z-Y-X) convention in that frame.
+ *
+ *           The time step is passed to every update, so it can be measured
+ *           from a microsecond clock rather than assumed.
+ */
+class MahonyFilter
+{
+protected:
+    float q0, q1, q2, q3;           ///< Attitude quaternion, sensor to Earth frame
+    float two_kp;                   ///< Twice the proportional gain
+    float two_ki;                   ///< Twice the integral gain
+    float bias_x, bias_y, bias_z;   ///< Integral feedback, the negated gyro bias (rad/s)
+
+    // Rotate the quaternion by the corrected gyro rates over one step
+    void integrate(float gx, float gy, float gz, float dt);
+
+public:
+    // Set up a filter at a level attitude
+    MahonyFilter(float kp = 0.3f, float ki = 0.05f);
+
+    // Start at the attitude given by one set of readings
+    void init(float ax, float ay, float az, float mx, float my, float mz);
+
+    // Fuse gyro, accelerometer and magnetometer readings
+    void update(float gx, float gy, float gz, float ax, float ay, float az,
+                float mx, float my, float mz, float dt);
+
+    // Fuse gyro and accelerometer readings only
+    void update_imu(float gx, float gy, float gz, float ax, float ay, float az,
+                    float dt);
+
+    // Roll angle (rad)
+    float get_roll(void);
+
+    // Pitch angle (rad)
+    float get_pitch(void);
+
+    // Yaw angle (rad)
+    float get_yaw(void);
+
+    // Part of a vector in the sensor frame which points up in the Earth frame
+    float get_vertical(float x, float y, float z);
+};
+
+#endif // _MAHONY_H_
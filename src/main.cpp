@@ -8,24 +8,153 @@
 #include <Arduino.h>
 #include "shares.h"
 #include "taskshare.h"
+#include "fastshare.h"
+#include "notifyshare.h"
+#include "attitude.h"
+#include "range.h"
+#include "vertical.h"
+#include "surface.h"
+#include "taskmemory.h"
+#include "periodic.h"
+#include "flightmode.h"
+#include "subscription.h"
 #include "PrintStream.h"
 #include <time.h>
+#include <esp_timer.h>
 #include <network.h>
 
 // Modules
 #include "DRV8871.h"
 #include "ultrasonic.h"
 #include "potentiometer.h"
-#include "PIDController.h"
+#include "adcstream.h"
+#include "potcal.h"
+#include "fixedpid.h"
+#include "controllerbank.h"
+#include "rangefilter.h"
+#include "verticalfilter.h"
+#include "fastmath.h"
 #include "IMU.h"
 
 // Shares
-Share<bool> near_ground ("Near Ground");                    ///< A share boolean that reads true if the glider is near ground
-Share<uint8_t> tc_state ("Task Controller State");          ///< A share integer for finite state machine
-Share<int16_t> rudder_duty ("Rudder motor duty cycle");     ///< A share containing the duty cycle for rudder motor
-Share<int16_t> elev_duty ("Elevator motor duty cycle");     ///< A share containing the duty cycle for elevator motor
-Share<float> yawC ("Current yaw from IMU");                 ///< A share containing current yaw of the glider
-Share<float> pitchC ("Current pitch from IMU");             ///< A share containing current pitch of the glider
+FastShare<bool> near_ground ("Near Ground");                    ///< A share boolean that reads true if the glider is near ground
+FastShare<Range> ground_range ("Ground range");                 ///< A share containing the latest ultrasonic ping
+FastShare<VerticalState> vertical ("Height and climb rate");    ///< A share containing the latest height, climb rate and time to contact
+FastShare<float> imu_temperature ("IMU temperature");           ///< A share containing the IMU's die temperature (C), or NAN until it is read
+FastShare<uint8_t> tc_state ("Task Controller State");          ///< A share integer for finite state machine
+NotifyShare<int16_t> rudder_duty ("Rudder motor duty cycle");   ///< A share containing the duty cycle for rudder motor
+NotifyShare<int16_t> elev_duty ("Elevator motor duty cycle");   ///< A share containing the duty cycle for elevator motor
+FastShare<Attitude> attitude ("Attitude from IMU");             ///< A share containing the latest attitude snapshot of the glider
+FastShare<SurfaceAngles> surface_setpoint ("Surface setpoints");    ///< Surface angles wanted by the attitude controller
+FastShare<SurfaceAngles> surface_angles ("Surface angles");         ///< Surface angles measured by the servo task
+
+// Task stacks and control blocks; reserved here at compile time when the
+// program is built with STATIC_ALLOC, taken from the heap otherwise
+TaskMemory<8192> webserver_memory;          ///< Memory for the web server task
+TaskMemory<2048> rudder_motor_memory;       ///< Memory for the rudder motor task
+TaskMemory<2048> elevator_motor_memory;     ///< Memory for the elevator motor task
+TaskMemory<2048> ultrasonic_memory;         ///< Memory for the ultrasonic task
+TaskMemory<2048> controller_memory;         ///< Memory for the controller task
+TaskMemory<3072> servo_memory;              ///< Memory for the servo task, which reads and writes NVS
+TaskMemory<2048> adc_memory;                ///< Memory for the ADC task
+TaskMemory<2048> flight_mode_memory;        ///< Memory for the flight mode task
+#ifdef IMU_EKF
+TaskMemory<4096> IMU_memory;                ///< Memory for the IMU task, whose Kalman filter works on the stack
+#else
+TaskMemory<2048> IMU_memory;                ///< Memory for the IMU task
+#endif
+TaskMemory<2048> telemetry_memory;          ///< Memory for the telemetry task
+
+// Flight mode state machine. The timer measures how long the glider has
+// been away from the ground after arming, and near it after flying
+const uint32_t LAUNCH_DELAY = 2000;     ///< Time off the ground before flying (ms)
+const uint32_t LANDING_DELAY = 2000;    ///< Time near the ground before disarming (ms)
+
+/// Entry action of DISABLED: publish the state; the servo task stops the motors
+static void enter_disabled (void)
+{
+    tc_state.put(ST_DISABLED);
+}
+
+/// Entry action of WAIT FOR LAUNCH: start timing if already off the ground
+static void enter_wait_for_launch (void)
+{
+    tc_state.put(ST_WAIT_FOR_LAUNCH);
+    if (!near_ground.get())
+    {
+        flight_mode.start_timer(LAUNCH_DELAY);
+    }
+}
+
+/// Entry action of ACTIVE: publish the state so the control loops run
+static void enter_active (void)
+{
+    tc_state.put(ST_ACTIVE);
+}
+
+/// Exit action of ACTIVE: center the surfaces, so the next flight starts level
+static void leave_active (void)
+{
+    SurfaceAngles center = {0, 0};
+    surface_setpoint.put(center);
+}
+
+/// Start timing the launch when the glider leaves the ground
+static void start_launch_timer (void)
+{
+    flight_mode.start_timer(LAUNCH_DELAY);
+}
+
+/// Start timing the landing when the glider comes near the ground
+static void start_landing_timer (void)
+{
+    flight_mode.start_timer(LANDING_DELAY);
+}
+
+/// Stop timing when the glider's height changes back
+static void stop_flight_timer (void)
+{
+    flight_mode.stop_timer();
+}
+
+/// Ask the servo task to zero the potentiometers
+static void request_calibration (void)
+{
+    web_calibrate.put(1);
+}
+
+/// The states of the flight mode machine, in @c FlightState order
+const FsmState flight_states[NUM_FLIGHT_STATES] =
+{   //  Name                Entry                   Exit
+    { "DISABLED",           enter_disabled,         NULL },
+    { "WAIT FOR LAUNCH",    enter_wait_for_launch,  NULL },
+    { "ACTIVE",             enter_active,           leave_active },
+};
+
+/// The transitions of the flight mode machine; the first match is taken
+const FsmTransition flight_transitions[] =
+{   //  From                Event               To                  Action
+    { FSM_ANY_STATE,        EV_CALIBRATE,       ST_DISABLED,        request_calibration },
+    { FSM_ANY_STATE,        EV_DEACTIVATE,      ST_DISABLED,        NULL },
+    { ST_DISABLED,          EV_ACTIVATE,        ST_WAIT_FOR_LAUNCH, NULL },
+    { ST_WAIT_FOR_LAUNCH,   EV_GROUND_LEFT,     ST_WAIT_FOR_LAUNCH, start_launch_timer },
+    { ST_WAIT_FOR_LAUNCH,   EV_GROUND_REACHED,  ST_WAIT_FOR_LAUNCH, stop_flight_timer },
+    { ST_WAIT_FOR_LAUNCH,   EV_TIMEOUT,         ST_ACTIVE,          NULL },
+    { ST_ACTIVE,            EV_GROUND_REACHED,  ST_ACTIVE,          start_landing_timer },
+    { ST_ACTIVE,            EV_GROUND_LEFT,     ST_ACTIVE,          stop_flight_timer },
+    { ST_ACTIVE,            EV_TIMEOUT,         ST_DISABLED,        NULL },
+};
+
+/// Names of the events for the transition log, in @c FlightEvent order
+const char* const flight_event_names[NUM_FLIGHT_EVENTS] =
+    { "ACTIVATE", "DEACTIVATE", "CALIBRATE", "GROUND REACHED", "GROUND LEFT",
+      "TIMEOUT" };
+
+/// Flight mode state machine, run by task_flight_mode()
+StateMachine flight_mode ("Flight mode", flight_states, NUM_FLIGHT_STATES,
+                          flight_transitions,
+                          sizeof (flight_transitions) / sizeof (FsmTransition),
+                          flight_event_names, EV_TIMEOUT);
 
 // Elevator Motor (Motor 0)
 #define ELEVATOR_PIN_IN1   27       ///< GPIO 27 on ESP32: non-zero signal for (+) duty cycle
@@ -43,321 +172,477 @@ Share<float> pitchC ("Current pitch from IMU");             ///< A share contain
 #define ELEVATOR_POT_PIN 34         ///< GPIO 34 on ESP32: reads voltage from elevator potentiometer
 #define RUDDER_POT_PIN   39         ///< GPIO 39 on ESP32: reads voltage from rudder potentiometer
 
+/// Both potentiometers, sampled in the background by task_adc()
+const uint8_t POT_PINS[] = { ELEVATOR_POT_PIN, RUDDER_POT_PIN };
+
+/// Continuous ADC sampling of the potentiometers, started by task_adc()
+AdcStream pot_adc (POT_PINS, sizeof (POT_PINS));
+
+/// Tables converting each potentiometer's readings to degrees, set up by task_servo()
+PotCalibration rudder_cal;
+PotCalibration elevator_cal;                ///< See rudder_cal
+
 // Ultrasonic
 #define TRIG 12                     ///< GPIO 12 on ESP32: ultrasonic trigger pin
 #define ECHO 13                     ///< GPIO 1 on ESP32: ultrasonic echo pin
+#define ULTRASONIC_PERIOD_MS 100    ///< Time between ultrasonic pings until the scheduler picks one (ms)
+
+// IMU
+#define IMU_INT1_PIN 32             ///< GPIO 32 on ESP32: LSM6DSOX INT1, high at the FIFO watermark
+#define IMU_TEMPERATURE_MS 1000     ///< Time between reads of the IMU's die temperature (ms)
 
 /** @brief   Ultrasonic sensor measures distance to the ground
  *  @details Ultrasonic sensor mounted on the airplane measures the 
  *           distance from the airplane to the ground. When the airplane
  *           is within 1 foot of the ground, the airplane's control 
  *           surfaces will move into "landing configuration" where the 
- *           pitch will be x degrees up for a soft landing.
+ *           pitch will be x degrees up for a soft landing. The sensor's
+ *           timer sends the pings and its echo interrupt times them, so this
+ *           task sleeps until each ping finishes and only publishes it. The
+ *           pings are filtered before the near-ground decision is made, so
+ *           one spurious echo can't start the landing, and the speed of
+ *           sound follows the temperature measured by the IMU. The time
+ *           between pings follows the height and rate of descent: slow while
+ *           the ground is out of range, fast on the final approach. The rate
+ *           achieved in each phase is printed at the end of each flight.
  *  @param   p_params A pointer to parameters passed to this task. This 
- *           pointer is ignored; it should be set to @c NULL in the 
- *           call to @c xTaskCreate() which starts this task
+ *           pointer, to the task's @c PeriodicTask object, is ignored 
+ *           because the task is event driven
  */
 void task_ultrasonic (void* p_params)
 {
     Serial << "Ultrasonic Sensor Task Begin" << endl;
 
-    // Task period
-    const uint8_t period = 100;
+    // Latest ping
+    Range range;
+
+    // Near the ground below 20 cm, and no longer near above 30 cm
+    RangeFilter filter(20.0f, 30.0f);
+
+    // Chooses the time between pings and counts the rate achieved
+    RangeScheduler scheduler;
+
+    // Whether the glider was near the ground at the previous reading
+    bool was_near_ground = false;
 
-    // Distance
-    float distance;
+    // Tells when each flight starts and ends
+    FlightEdges flight;
 
-    // Height and timer threshold
-    const uint8_t threshold = 20;               // cm
+    // Pings with no echo counted before this flight
+    uint32_t flight_timeouts = 0;
 
     // Create object
     Serial.println("Constructing the ultrasonic object");
-    Ultrasonic ultra = Ultrasonic(ECHO, TRIG);
+    Ultrasonic ultra = Ultrasonic(ECHO, TRIG, ULTRASONIC_PERIOD_MS);
 
     while (true)
     {
-        // Get the distance from the sensor
-        distance = ultra.get_distance();
-        
-        // If the distance is below height threshold, start counting
-        // Stop counting when counter exceeds 10 seconds to prevent overflow
-        near_ground.put(distance < threshold);
-        vTaskDelay(period);
+        // Sleep until the sensor finishes a ping
+        if (!ultra.wait_for_range(range))
+        {
+            continue;
+        }
+        ground_range.put(range);
+
+        // Correct the speed of sound once the IMU has read its temperature;
+        // 0 C is a real reading, so "none yet" is NAN
+        float temperature = imu_temperature.get();
+        if (!isnan(temperature))
+        {
+            ultra.set_temperature(temperature);
+        }
+
+        // Share the filtered decision; when nothing is in range for several
+        // pings the ground is far away
+        near_ground.put(filter.update(range));
+
+        // Ping faster as the ground comes closer
+        ultra.set_period(scheduler.update(filter, range));
+
+        // Tell the flight mode machine when the glider crosses the threshold
+        if (near_ground.get() != was_near_ground)
+        {
+            was_near_ground = near_ground.get();
+            flight_mode.post(was_near_ground ? EV_GROUND_REACHED : EV_GROUND_LEFT);
+        }
+
+        // Report the ping rate achieved in each phase of each flight
+        FlightEdge edge = flight.update(tc_state.get());
+        if (edge == FLIGHT_STARTED)
+        {
+            scheduler.reset();
+            flight_timeouts = ultra.get_timeouts();
+        }
+        else if (edge == FLIGHT_ENDED)
+        {
+            scheduler.print(Serial, "Ultrasonic");
+            Serial << "Ultrasonic pings with no echo: " << ultra.get_timeouts() - flight_timeouts << endl;
+        }
     }
 }
 
 
-/** @brief   Controller for both rudder and elevator control surfaces
- *  @details Retrieves IMU, potentiometer, and ultrasonic sensor data and writes 
- *           motor duty cycles to shares. The motor tasks use the duty cycles
- *           to move the rudder and elevator control surfaces. The states within
- *           this task are set internally and by the webpage task.
- *  @param   p_params An unused pointer to (no) parameters passed to this task
+/** @brief   Outer attitude loops for both rudder and elevator control surfaces
+ *  @details Retrieves IMU and ultrasonic sensor data and puts the rudder and
+ *           elevator angles which the glider needs into a share. The servo
+ *           task moves the control surfaces to those angles at a much higher
+ *           rate. The loops run only while the flight mode state machine is
+ *           in its ACTIVE state.
+ *  @param   p_params A pointer to this task's @c PeriodicTask object
  */
 void task_controller (void* p_params)
 {
     Serial << "Controller Task Begin" << endl;
-  
-    const uint8_t TASK_CONTROLLER_PERIOD = 50;  ///< Period of controller task (ms)
-
-    // Controller objects
-    PIDController yaw2rudder =      ///< Controller for rudder angle based on yaw
-        PIDController(1,0,0,TASK_CONTROLLER_PERIOD); 
-    PIDController rudder2duty =     ///< Controller for duty cycle based on rudder angle
-        PIDController(3,0,0,TASK_CONTROLLER_PERIOD);
-    PIDController pitch2elev =      ///< Controller for elevator angle based on pitch
-        PIDController(1,0,0,TASK_CONTROLLER_PERIOD);
-    PIDController elev2duty =       ///< Controller for duty cycle based on elevator angle
-        PIDController(3,0,0,TASK_CONTROLLER_PERIOD);
-
-    // Create potentiometer object and zero the current reading
-    Potentiometer rudderPot = Potentiometer(RUDDER_POT_PIN, 0);
-    rudderPot.zero();
 
-    // Create potentiometer object and zero the current reading
-    Potentiometer elevPot = Potentiometer(ELEVATOR_POT_PIN, 0);
-    elevPot.zero();
+    // Releases the task at the period given in the task table
+    PeriodicTask& schedule = *(PeriodicTask*)p_params;
+    const uint32_t TASK_CONTROLLER_PERIOD =     ///< Period of controller task (ms)
+        schedule.get_period() * portTICK_PERIOD_MS;
+
+    const float rudderAngleMin = -50;   ///< Minimum allowable rudder angle (deg)
+    const float rudderAngleMax = 50;    ///< Maximum allowable rudder angle (deg)
+    const float elevAngleMin = -50;     ///< Minimum allowable elevator angle (deg)
+    const float elevAngleMax = 50;      ///< Maximum allowable elevator angle (deg)
+
+    // Controller objects. The attitude loops run together in one bank and
+    // produce the setpoints of the servo loops in task_servo()
+    const uint8_t RUDDER_LOOP = 0;      ///< Bank index of the roll to rudder angle loop
+    const uint8_t ELEV_LOOP = 1;        ///< Bank index of the pitch to elevator angle loop
+    ControllerBank<2> attitude2angle;   ///< Controllers for surface angles based on attitude
+    attitude2angle.set_loop(RUDDER_LOOP,1,0,0,TASK_CONTROLLER_PERIOD/1000.0f,rudderAngleMin,rudderAngleMax);
+    attitude2angle.set_loop(ELEV_LOOP,1,0,0,TASK_CONTROLLER_PERIOD/1000.0f,elevAngleMin,elevAngleMax);
 
     // Initialize variables
     float yawD;                     ///< Desired yaw (deg)
     float pitchD;                   ///< Desired pitch (deg)  
 
-    // Variables to keep track of previous potentiometer reading
-    float prev_rudder = 0;          ///< Rudder position at previous time (deg)
-    float prev_elevator = 0;        ///< Elevator position at previous time (deg)
-
-    float rudderAngleD;             ///< Desired rudder angle (deg)
-    float rudderAngleC;             ///< Current rudder angle (deg)
-    float rudderAngleMin = -50;     ///< Minimum allowable rudder angle (deg)
-    float rudderAngleMax = 50;      ///< Maximum allowable rudder angle (deg)
+    SurfaceAngles angleD = {0, 0};  ///< Desired surface angles (deg)
 
-    float elevAngleD;               ///< Desired elevator angle (deg)
-    float elevAngleC;               ///< Current elevator angle (deg)
-    float elevAngleMin = -50;       ///< Minimum allowable elevator angle (deg)
-    float elevAngleMax = 50;        ///< Maximum allowable elevator angle (deg)
+    float attitudeC[2];             ///< Current roll and pitch, in bank order (deg)
+    float attitudeD[2];             ///< Desired roll and pitch, in bank order (deg)
+    float bankD[2];                 ///< Desired surface angles, in bank order (deg)
 
-    float rudderDutyD;              ///< Rudder motor duty cycle (-100% to 100% incl.)
-    float elevDutyD;                ///< Elev motor duty cycle (-100% to 100% incl.)
+    Attitude att;                   ///< Latest attitude snapshot from the IMU
+    uint32_t last_sequence = 0;     ///< Sequence number of the previous snapshot used
+    const uint32_t IMU_STALE_US = 100000;   ///< Age after which an IMU snapshot is stale (us)
+    uint32_t stale_cycles = 0;      ///< Active cycles with no fresh snapshot, this flight
 
-    uint16_t delay_time = 0;        ///< Current amount of time (ms) in inactive delay
-    tc_state.put(0);                // Initialize at state 0
+    const float FLARE_TIME_S = 0.5f;    ///< Time to contact at which the flare starts (s)
+    bool flaring = false;               ///< True once the flare has started
 
-
-    // Establish initial conditions for rudder and elevator
-    rudderAngleC = rudderPot.get_angle();
-    prev_rudder = rudderAngleC;
-
-    elevAngleC = elevPot.get_angle();
-    prev_elevator = elevAngleC;
+    FlightEdges flight;                 ///< Tells when each flight starts and ends
+    surface_setpoint.put(angleD);   // Hold the surfaces centered until active
 
     
     while (true) 
     {
+        // The flight mode task changes the state as soon as an event arrives;
+        // this task only has to notice the change at its next cycle
+        uint8_t state = tc_state.get();
+        FlightEdge edge = flight.update(state);
 
-        if (web_calibrate.get()) {        // If the webpage calls for calibration
-
-            rudderPot.zero();             // Stop power to motors
-            elevPot.zero();
-
-            web_calibrate.put(0);         // Reset the calibrate flag
-
-            Serial << "   Calibrated" << endl;
-
-        }
-
-
-        if (tc_state.get() == 0)          // STATE 0: DISABLED
-        {        
-
-            delay_time = 0;               // Reset delay counter
-            rudder_duty.put(0);           // Stop power to motors
-            elev_duty.put(0);
-
-            // Passive state waiting for external callback to switch state
-            Serial.println(" 0 ");
-
-        }
-        else if (tc_state.get() == 1)     // STATE 1: WAIT FOR LAUNCH
+        if (edge == FLIGHT_STARTED)
         {
-
-            Serial.println(" 1 ");
-
-            // Add one task period to accumulated delay time (ms)
-            if (near_ground.get() == 0) 
-            {
-                delay_time += TASK_CONTROLLER_PERIOD;         
-            }  
-            else
-            {
-                delay_time = 0;
-            }
-
-            // If total delay time has reached 1000 ms...
-            if (delay_time >= 2000) 
-            {
-
-                tc_state.put(2);                // Move to active state
-                delay_time = 0;                 // Reset counter
-            }
-
+            attitude2angle.reset();             // Start timing from the first sample
+            flaring = false;
+            stale_cycles = 0;
         }
-        else if (tc_state.get() == 2)           // STATE 2: CONTROLLER ACTIVE
+        else if (edge == FLIGHT_ENDED)
         {
+            attitude2angle.get_jitter().print(Serial, "Attitude loops");
+            Serial << "Attitude loops: " << stale_cycles << " cycles with a stale IMU sample" << endl;
+        }
 
-            // Time how long the plane is near the ground
-            if (near_ground.get() == 1) 
-            {
-                delay_time += TASK_CONTROLLER_PERIOD;         
-            }  
-            else
+        if (state == ST_ACTIVE)                 // CONTROLLER ACTIVE
+        {
+            // Start the flare when touchdown is close enough for the
+            // pitch to come up in time, or at the latest near the ground.
+            // Once started it holds, since the flare itself slows the
+            // descent, unless the ground goes out of range
+            VerticalState vert = vertical.get();
+            if (near_ground.get() || (vert.valid && vert.time_to_contact < FLARE_TIME_S))
             {
-                delay_time = 0;
+                flaring = true;
             }
-
-            // If total delay time has reached 2000 ms...
-            if (delay_time >= 2000) 
+            else if (!vert.valid)
             {
-                tc_state.put(0);                // Move to deactivated state
-                delay_time = 0;                 // Reset counter
+                flaring = false;
             }
 
-            // Check whether the glider is near ground
-            if (near_ground.get()) 
+            if (flaring) 
             {
-                pitchD = 10;                    // If it is, set pitch
+                pitchD = 10;                    // If flaring, pitch up
             }
             else 
             {
-                pitchD = 0;                     // If not, set different pitch
+                pitchD = 0;                     // If not, glide level
             }
 
             yawD = 0;          
-        
-            // Calculate desired rudder angle and then saturate
-            rudderAngleD = yaw2rudder.getCtrlOutput(yawC.get(),yawD);
-            if (rudderAngleD > rudderAngleMax) 
+
+            // Read all the angles from one IMU update. Only run the attitude
+            // loops on a new, recent sample; otherwise hold the surface angles
+            att = attitude.get();
+            int64_t now_us = esp_timer_get_time();
+            uint32_t age_us = (uint32_t)now_us - att.time_us;
+            bool fresh = (att.sequence != last_sequence) && (age_us < IMU_STALE_US);
+            last_sequence = att.sequence;
+
+            if (fresh)
             {
-                rudderAngleD = rudderAngleMax;
+                // Calculate desired rudder angle from roll and elevator angle
+                // from pitch in one pass; the bank saturates both and scales
+                // its integral and derivative by the interval between the
+                // samples. micros() is the low 32 bits of esp_timer_get_time(),
+                // so the sample's age puts its time on the 64 bit clock
+                attitudeC[RUDDER_LOOP] = att.roll;
+                attitudeD[RUDDER_LOOP] = yawD;
+                attitudeC[ELEV_LOOP] = att.pitch;
+                attitudeD[ELEV_LOOP] = pitchD;
+                attitude2angle.update(attitudeC,attitudeD,bankD,now_us - age_us);
+                angleD.rudder = bankD[RUDDER_LOOP];
+                angleD.elevator = bankD[ELEV_LOOP];
+                surface_setpoint.put(angleD);
             }
-            else if (rudderAngleD < rudderAngleMin) 
+            else
             {
-                rudderAngleD = rudderAngleMin;
+                stale_cycles++;                 // Reported when the flight ends
             }
 
-            // Get current rudder angle
-            rudderAngleC = rudderPot.get_angle();
+            Serial << "C: " << surface_angles.get().elevator << "; D: " << angleD.elevator << "; Duty: " << elev_duty.get() << endl;
+
+        }
+
+        schedule.wait();
+
+    }
+}
+
+/** @brief   Load a potentiometer's calibration table, building it if need be.
+ *  @details A table saved by an earlier boot is used if there is one.
+ *           Otherwise the table is built from the ADC's eFuse
+ *           characterisation and saved, so this only writes to flash on a
+ *           board's first boot. A chip with no calibration in its eFuses
+ *           gets a table from the default reference, which is built afresh
+ *           on every boot rather than saved as if it were the chip's own.
+ *  @param   pot The potentiometer, which was given @c table
+ *  @param   table The potentiometer's calibration table
+ *  @param   label A name for the potentiometer which is printed with the table's source
+ */
+static void load_pot_calibration (Potentiometer& pot, PotCalibration& table, const char* label)
+{
+    if (!pot.load_calibration())
+    {
+        if (pot.calibrate_efuse())
+        {
+            pot.save_calibration();
+        }
+        else
+        {
+            Serial << label << " pot: no ADC calibration in eFuse, using the default reference" << endl;
+        }
+    }
+    Serial << label << " pot table: " << PotCalibration::source_name(table.get_source()) << endl;
+}
+
+/** @brief   Inner servo loops which hold the control surfaces at their setpoints
+ *  @details Reads the rudder and elevator potentiometers every period and
+ *           runs a position loop on each, putting the motor duty cycles to
+ *           shares for the motor tasks. The setpoints come from the attitude
+ *           controller, which runs many times more slowly; a DC motor servo
+ *           needs to be updated much faster than the surfaces' own response
+ *           time or it overshoots and rings. The motors are only driven while
+ *           the controller is active. This task also zeroes the
+ *           potentiometers when the webpage asks for calibration. Angles are
+ *           read through each potentiometer's calibration table.
+ *  @param   p_params A pointer to this task's @c PeriodicTask object
+ */
+void task_servo (void* p_params)
+{
+    Serial << "Servo Task Begin" << endl;
+
+    // Releases the task at the period given in the task table
+    PeriodicTask& schedule = *(PeriodicTask*)p_params;
+    const float dt = schedule.get_period() * portTICK_PERIOD_MS / 1000.0f;
+
+    PID<16> rudder2duty =           ///< Controller for duty cycle based on rudder angle
+        PID<16>(3,0,0,dt,-100,100);
+    PID<16> elev2duty =             ///< Controller for duty cycle based on elevator angle
+        PID<16>(3,0,0,dt,-100,100);
+
+    // Create potentiometer object, load its table and zero the current
+    // reading, which comes from the ADC task's oversampled stream
+    Potentiometer rudderPot = Potentiometer(RUDDER_POT_PIN, 0, &pot_adc, &rudder_cal);
+    load_pot_calibration(rudderPot, rudder_cal, "Rudder");
+    rudderPot.zero();
+
+    // Create potentiometer object, load its table and zero the current reading
+    Potentiometer elevPot = Potentiometer(ELEVATOR_POT_PIN, 0, &pot_adc, &elevator_cal);
+    load_pot_calibration(elevPot, elevator_cal, "Elevator");
+    elevPot.zero();
+
+    SurfaceAngles angleD;           ///< Desired surface angles (deg)
+    SurfaceAngles angleC;           ///< Current surface angles (deg)
+
+    // Establish initial conditions for rudder and elevator
+    float prev_rudder = rudderPot.get_angle();      ///< Rudder position at previous time (deg)
+    float prev_elevator = elevPot.get_angle();      ///< Elevator position at previous time (deg)
+
+    while (true)
+    {
+        if (web_calibrate.get()) {        // If the webpage calls for calibration
+
+            rudderPot.zero();             // Stop power to motors
+            elevPot.zero();
+
+            web_calibrate.put(0);         // Reset the calibrate flag
+
+            Serial << "   Calibrated" << endl;
+
+        }
+
+        angleC.rudder = rudderPot.get_angle();
+        angleC.elevator = elevPot.get_angle();
+        surface_angles.put(angleC);
+
+        if (tc_state.get() == ST_ACTIVE)  // Controller active
+        {
+            angleD = surface_setpoint.get();
+
             // Check if the difference in rudder angles are less than 30 degrees
             // to prevent undesired response to flickering measurements
-            if (fabs(rudderAngleC - prev_rudder) < 30)
+            if (fabs(angleC.rudder - prev_rudder) < 30)
             {
-                // Serial.println(fabs(rudderAngleC - prev_rudder));
-                prev_rudder = rudderAngleC;
-                // Calculate desired rudder motor duty cycle, saturate, then put to share
-                rudderDutyD = rudder2duty.getCtrlOutput(rudderAngleC,rudderAngleD);
-                if (rudderDutyD > 100) 
-                {
-                    rudder_duty.put(100);
-                }
-                else if (rudderDutyD < -100) 
-                {
-                    rudder_duty.put(-100);
-                }
-                else
-                {
-                    rudder_duty.put((int16_t) round(rudderDutyD));
-                }
+                // Calculate desired rudder motor duty cycle, which the
+                // controller clamps to +/-100%, then put to share
+                int32_t dutyD = rudder2duty.update(to_fixed<16>(angleC.rudder),to_fixed<16>(angleD.rudder));
+                rudder_duty.put((int16_t) PID<16>::to_int(dutyD));
             }
             else
             {
                 rudder_duty.put(0);
             }
-            
 
-            // Calculate desired elevator angle and then saturate
-            elevAngleD = pitch2elev.getCtrlOutput(pitchC.get(),pitchD);
-            if (elevAngleD > elevAngleMax)
-            {
-                elevAngleD = elevAngleMax;
-            }
-            else if (elevAngleD < elevAngleMin)
+            if (fabs(angleC.elevator - prev_elevator) < 30)
             {
-                elevAngleD = elevAngleMin;
-            }
-
-            // Get current elevator angle
-            elevAngleC = elevPot.get_angle();
-            if (fabs(elevAngleC - prev_elevator) < 30)
-            {
-                // Calculate desired elevator motor duty cycle, saturate, then put to share
-                elevDutyD = elev2duty.getCtrlOutput(elevAngleC,elevAngleD);
-                if (elevDutyD > 100) 
-                {
-                    elev_duty.put(100);
-                }
-                else if (elevDutyD < -100) 
-                {
-                    elev_duty.put(-100);
-                }
-                else 
-                {
-                    elev_duty.put((int16_t) round(elevDutyD));
-                }
+                // Calculate desired elevator motor duty cycle, which the
+                // controller clamps to +/-100%, then put to share
+                int32_t dutyD = elev2duty.update(to_fixed<16>(angleC.elevator),to_fixed<16>(angleD.elevator));
+                elev_duty.put((int16_t) PID<16>::to_int(dutyD));
             }
             else
             {
                 elev_duty.put(0);
             }
+        }
+        else                              // Stop power to motors
+        {
+            rudder2duty.reset();
+            elev2duty.reset();
+            rudder_duty.put(0);
+            elev_duty.put(0);
+        }
 
-            Serial << "C: " << elevAngleC << "; D: " << elevAngleD << "; Duty: " << elev_duty.get() << endl;
+        prev_rudder = angleC.rudder;
+        prev_elevator = angleC.elevator;
 
-            prev_elevator = elevAngleC;
-            prev_rudder = rudderAngleC;
+        schedule.wait();
+    }
+}
+
+/** @brief   Apply each new duty cycle to a motor as soon as it is published.
+ *  @details The calling task sleeps until the controller puts a different
+ *           duty cycle into the share, then writes it to the motor driver.
+ *           The time from the controller's put to the end of the PWM update
+ *           is measured, and its average and maximum are printed every
+ *           @c LATENCY_REPORT updates.
+ *  @param   motor The motor driver which is to be updated
+ *  @param   duty The share from which new duty cycles are taken
+ *  @param   label A name for the motor which is printed with the latency
+ */
+void run_motor (DRV8871& motor, NotifyShare<int16_t>& duty, const char* label)
+{
+    const uint16_t LATENCY_REPORT = 5000;   ///< Updates between latency reports
+
+    int16_t duty_now;               ///< Duty cycle just taken from the share
+    uint32_t latency;               ///< Time from put to PWM update (us)
+    uint32_t latency_sum = 0;       ///< Sum of latencies since the last report (us)
+    uint32_t latency_max = 0;       ///< Largest latency since the last report (us)
+    uint16_t updates = 0;           ///< Number of updates since the last report
 
+    while (true)
+    {
+        duty.wait(duty_now);
+        motor.set_duty(duty_now);
+
+        latency = micros() - duty.change_time();
+        latency_sum += latency;
+        if (latency > latency_max)
+        {
+            latency_max = latency;
         }
 
-        vTaskDelay(TASK_CONTROLLER_PERIOD);
+        if (++updates == LATENCY_REPORT)
+        {
+            Serial << label << " latency avg " << latency_sum / updates
+                   << " us, max " << latency_max << " us" << endl;
+            latency_sum = 0;
+            latency_max = 0;
+            updates = 0;
+        }
+    }
+}
 
+/** @brief   Task which samples the potentiometers in the background
+ *  @details The ADC converts both potentiometer pins continuously and the
+ *           DMA collects the results, so no task waits for a conversion.
+ *           This task sleeps until each frame of conversions is ready and
+ *           averages it into one reading of each pin, which the servo task
+ *           takes whenever it runs. If the ADC cannot be started, the task
+ *           ends and the potentiometers fall back to @c analogRead().
+ *  @param   p_params A pointer to parameters passed to this task. This 
+ *           pointer, to the task's @c PeriodicTask object, is ignored 
+ *           because the task is event driven
+ */
+void task_adc (void* p_params)
+{
+    Serial << "ADC Task Begin" << endl;
+
+    if (!pot_adc.begin())
+    {
+        Serial << "ADC stream failed to start; using analogRead()" << endl;
+        vTaskDelete(NULL);
     }
+    pot_adc.run();
 }
 
-/** @brief   
- *  @details 
+/** @brief   Task which drives the rudder motor
+ *  @details This task sleeps until the controller publishes a new rudder
+ *           duty cycle and then applies it to the motor driver.
  *  @param   p_params A pointer to parameters passed to this task. This 
- *           pointer is ignored; it should be set to @c NULL in the 
- *           call to @c xTaskCreate() which starts this task
+ *           pointer, to the task's @c PeriodicTask object, is ignored 
+ *           because the task is event driven
  */
 void task_rudder_motor (void* p_params)
 { 
-
-    // Motor task period
-    const uint8_t period = 50;
-
     Serial << "Rudder Motor Task Begin" << endl;
     // Create object
     DRV8871 rudder = DRV8871(RUDDER_PIN_IN1, RUDDER_PIN_IN2, RUDDER_CHANNEL_A, RUDDER_CHANNEL_B);
 
     rudder.set_duty(0);
 
-    while (true)
-    {
-        // Serial.println(rudder_duty.get());
-        rudder.set_duty(rudder_duty.get());
-        vTaskDelay(period);
-    }
+    run_motor(rudder, rudder_duty, "Rudder");
 }   
 
-/** @brief   
- *  @details 
+/** @brief   Task which drives the elevator motor
+ *  @details This task sleeps until the controller publishes a new elevator
+ *           duty cycle and then applies it to the motor driver.
  *  @param   p_params A pointer to parameters passed to this task. This 
- *           pointer is ignored; it should be set to @c NULL in the 
- *           call to @c xTaskCreate() which starts this task
+ *           pointer, to the task's @c PeriodicTask object, is ignored 
+ *           because the task is event driven
  */
 void task_elevator_motor (void* p_params)
 {
-    
-    // Motor task period
-    const uint8_t period = 50;
-
     Serial << "Elevator Motor Task Begin" << endl;
     // Create object
     DRV8871 elevator = DRV8871(
@@ -365,45 +650,185 @@ void task_elevator_motor (void* p_params)
 
     elevator.set_duty(0);
 
-    while (true)
-    {
-      elevator.set_duty(elev_duty.get());
-      vTaskDelay(period);
-    }
+    run_motor(elevator, elev_duty, "Elevator");
 }
 
 /** @brief   Task function to interface with IMU
- *  @details This task reads from the IMU to get pitch, yaw, and roll
- *           measurements. It then puts the data into shaes for the 
- *           controller to use. 
+ *  @details This task sleeps until the IMU's INT1 interrupt says its FIFO
+ *           has reached the watermark of IMU_FIFO_WATERMARK samples, then
+ *           drains the batch to get pitch, yaw, and roll measurements. It
+ *           then puts the data into shaes for the controller to use. The
+ *           vertical acceleration of each batch is fused with the latest
+ *           ultrasonic ping into a height, climb rate and time to contact,
+ *           which are published at the same rate. The time from the
+ *           interrupt to the task waking is kept in a histogram, printed
+ *           whenever the controller leaves the active state.
  *  @param   p_params A pointer to parameters passed to this task. This 
- *           pointer is ignored; it should be set to @c NULL in the 
- *           call to @c xTaskCreate() which starts this task
+ *           pointer, to the task's @c PeriodicTask object, is ignored 
  */
 void task_IMU(void* p_params) 
 {
     // INIT
-    LSM6DSOX imu;
+    LSM6DSOX imu(IMU_INT1_PIN);
     // declare float
     float pitch, yaw, roll;
+    float pitch_rate, yaw_rate, roll_rate;
+
+    // Snapshot published to the controller; zero means no sample yet
+    Attitude att = {};
+
+    // Height and climb rate, from the accelerometer and the ultrasonic pings
+    VerticalFilter height_filter;
+    VerticalState vert = {};
+    uint32_t range_sequence = 0;        ///< Sequence number of the last ping fused
+
+    JitterHistogram wake_latency(0);    ///< Time from interrupt to task (us)
+    uint32_t flight_overruns = 0;       ///< FIFO overruns counted before this flight
+    FlightEdges flight;                 ///< Tells when each flight starts and ends
+    uint32_t temperature_ms = millis(); ///< When the die temperature was last read
+
+    // THE ULTRASONIC TASK CORRECTS THE SPEED OF SOUND WITH THE DIE TEMPERATURE
+    imu_temperature.put(imu.read_temperature());
 
     // READ VALUES
     while(true)
     {
+        // SLEEP UNTIL A BATCH IS READY; A TIMEOUT ONLY RECOVERS A MISSED EDGE
+        if (imu.wait_for_data())
+        {
+            wake_latency.record(micros() - imu.get_ready_us());
+        }
 
-        // SEND IT AND THE DATA BACK IN RADIANS
-        imu.get_angle((float)time(0), pitch, yaw, roll);
+        // FUSE THE BATCH OF SAMPLES IN THE FIFO, STAMPED WITH THE NEWEST ONE'S TIME
+        uint32_t prev_time_us = att.time_us;
+        if (imu.get_angle(att.time_us, pitch, yaw, roll) == 0)
+        {
+            continue;
+        }
+        imu.get_rates(pitch_rate, yaw_rate, roll_rate);
 
         // Serial << "P: " << pitch*180/M_PI << ";  R: " << roll*180/M_PI << endl;
 
-        // PUT ANGLES TO SHARES FOR CONTROLLER
-        pitchC.put(pitch*180/M_PI);
-        yawC.put(roll*180/M_PI);
+        // PUT ALL ANGLES AND RATES TO THE SHARE FOR CONTROLLER AT ONCE
+        att.pitch = pitch * FM_RAD_TO_DEG;
+        att.roll = roll * FM_RAD_TO_DEG;
+        att.yaw = yaw * FM_RAD_TO_DEG;
+        att.pitch_rate = pitch_rate * FM_RAD_TO_DEG;
+        att.roll_rate = roll_rate * FM_RAD_TO_DEG;
+        att.yaw_rate = yaw_rate * FM_RAD_TO_DEG;
+        att.sequence++;
+        attitude.put(att);
+
+        // MOVE THE HEIGHT ON BY THE BATCH'S ACCELERATION, CORRECT IT WITH ANY
+        // NEW PING, AND PUBLISH IT
+        if (att.sequence > 1)
+        {
+            height_filter.predict(imu.get_vertical_accel(),
+                                  (att.time_us - prev_time_us) * 1e-6f);
+        }
+        Range ping = ground_range.get();
+        if (ping.sequence != range_sequence)
+        {
+            range_sequence = ping.sequence;
+            height_filter.correct(ping, att.time_us);
+        }
+        height_filter.get_state(vert);
+        vert.time_us = att.time_us;
+        vert.sequence++;
+        vertical.put(vert);
+
+        // READ THE TEMPERATURE NOW AND THEN; IT CHANGES SLOWLY
+        if (millis() - temperature_ms >= IMU_TEMPERATURE_MS)
+        {
+            temperature_ms += IMU_TEMPERATURE_MS;
+            imu_temperature.put(imu.read_temperature());
+        }
+
+        // REPORT THE WAKE LATENCY OF EACH FLIGHT
+        FlightEdge edge = flight.update(tc_state.get());
+        if (edge == FLIGHT_STARTED)
+        {
+            wake_latency.reset();
+            flight_overruns = imu.get_overruns();
+        }
+        else if (edge == FLIGHT_ENDED)
+        {
+            wake_latency.print(Serial, "IMU wake latency");
+            Serial << "IMU FIFO overruns: " << imu.get_overruns() - flight_overruns << endl;
+        }
 
         // PRINT IT
         // Serial << pitch * 180/M_PI << ", " << yaw * 180/M_PI << ", " << roll * 180/M_PI << endl;
-        
-        vTaskDelay(1);
+    }
+}
+
+
+/** @brief   Task which logs changes of the controller state and ground flag
+ *  @details This task subscribes to the controller state and near-ground
+ *           shares and sleeps until one of them is written, so it costs
+ *           nothing while nothing happens. It prints a line only when a value
+ *           actually changes.
+ *  @param   p_params A pointer to parameters passed to this task. This 
+ *           pointer, to the task's @c PeriodicTask object, is ignored 
+ *           because the task is event driven
+ */
+void task_telemetry (void* p_params)
+{
+    Subscription<uint8_t> state_topic (tc_state, 1 << 0);
+    Subscription<bool> ground_topic (near_ground, 1 << 1);
+
+    uint8_t state = ST_DISABLED;    ///< Latest controller state
+    uint8_t prev_state = 0xFF;      ///< Controller state last printed
+    bool ground = false;            ///< Latest near-ground flag
+    bool prev_ground = false;       ///< Near-ground flag last printed
+    FlightEdges flight;             ///< Tells when each flight starts and ends
+    uint32_t flight_adc_overruns = 0;   ///< Pot ADC overruns when the flight began
+
+    while (true)
+    {
+        uint32_t bits = wait_for_topics();
+
+        if ((bits & state_topic.bit()) && state_topic.get(state) && state != prev_state)
+        {
+            Serial << millis() << " ms: state " << (uint16_t)state << endl;
+
+            // Show how the schedule and the pot ADC held up during each flight
+            FlightEdge edge = flight.update(state);
+            if (edge == FLIGHT_STARTED)
+            {
+                flight_adc_overruns = pot_adc.get_overruns();
+            }
+            else if (edge == FLIGHT_ENDED)
+            {
+                PeriodicTask::print_all(Serial);
+                Serial << "Pot ADC overruns: " << pot_adc.get_overruns() - flight_adc_overruns << endl;
+            }
+            prev_state = state;
+        }
+        if ((bits & ground_topic.bit()) && ground_topic.get(ground) && ground != prev_ground)
+        {
+            Serial << millis() << " ms: near ground " << ground << endl;
+            prev_ground = ground;
+        }
+    }
+}
+
+
+/** @brief   Task which runs the flight mode state machine
+ *  @details This task sleeps until an event is posted by the webpage or the
+ *           ultrasonic task, or until the machine's timer runs out, and then
+ *           makes the transition at once. The machine's actions run here.
+ *  @param   p_params A pointer to parameters passed to this task. This 
+ *           pointer, to the task's @c PeriodicTask object, is ignored 
+ *           because the task is event driven
+ */
+void task_flight_mode (void* p_params)
+{
+    flight_mode.begin(ST_DISABLED);
+
+    while (true)
+    {
+        flight_mode.run();
     }
 }
 
@@ -414,6 +839,9 @@ void task_IMU(void* p_params)
  */
 void setup (void) 
 {
+    // Time from here to the end of setup() is reported once the tasks start
+    uint32_t setup_start = micros ();
+
     // The serial port must begin before it may be used
     Serial.begin (115200);
 
@@ -424,6 +852,11 @@ void setup (void)
 
     Serial << "Serial is ready. " << endl;
 
+#ifdef FASTMATH_CYCLES
+    // Time the attitude math before any task can interrupt it
+    fastmath_print_cycles (Serial);
+#endif
+
     // start i2c
     Wire.begin();
 
@@ -433,23 +866,44 @@ void setup (void)
     // Initialize web_calibrate to zero
     web_calibrate.put(1);
 
-    // Task which runs the web server. It runs at a low priority
-    xTaskCreate (task_webserver, "Web Server", 8192, NULL, 10, NULL);
-
-    // Task for the potentiometer testing
-    xTaskCreate (task_rudder_motor, "Rudder Motor", 2048, NULL, 20, NULL);
-
-    // Task for the potentiometer testing
-    xTaskCreate (task_elevator_motor, "Elevator Motor", 2048, NULL, 40, NULL);
-    
-    // Task for the ultrasonic sensor
-    xTaskCreate (task_ultrasonic, "Ultrasonic Sensor", 2048, NULL, 50, NULL);
+    // No temperature until the IMU task reads one
+    imu_temperature.put(NAN);
+
+    // Every task in the program, with its timing, priority and memory. A
+    // period of zero means that the task waits for events instead. The web
+    // server shares core 0 with WiFi; the flight tasks have core 1. The
+    // flight tasks' priorities count down from the highest there is, as
+    // FreeRTOS would make any higher ones equal to it. The IMU is one above
+    // the controller, so that a new attitude is published before the
+    // controller reads it rather than the two taking turns
+    const UBaseType_t TOP = configMAX_PRIORITIES - 1;
+    static PeriodicTask tasks[] =
+    {   //  Function             Name                 Period  Priority  Core  Memory
+        { task_webserver,       "Web Server",           500,     10,     0,   webserver_memory },
+        { task_rudder_motor,    "Rudder Motor",           0,  TOP - 7,   1,   rudder_motor_memory },
+        { task_elevator_motor,  "Elevator Motor",         0,  TOP - 6,   1,   elevator_motor_memory },
+        { task_ultrasonic,      "Ultrasonic Sensor",      0,  TOP - 5,   1,   ultrasonic_memory },
+        { task_controller,      "Flight Controls",       50,  TOP - 4,   1,   controller_memory },
+        { task_adc,             "ADC",                    0,  TOP - 1,   1,   adc_memory },
+        { task_servo,           "Servo",                  1,  TOP,       1,   servo_memory },
+        { task_flight_mode,     "Flight Mode",            0,  TOP - 2,   1,   flight_mode_memory },
+        { task_IMU,             "IMU",                    0,  TOP - 3,   1,   IMU_memory },
+        { task_telemetry,       "Telemetry",              0,      5,     0,   telemetry_memory },
+    };
+    for (PeriodicTask& task : tasks)
+    {
+        task.start ();
+    }
 
-    // Task for the flight surface controls (rudder and elevator)
-    xTaskCreate (task_controller, "Flight Controls", 2048,  NULL, 60, NULL);
+    // Report how long booting took and where the tasks' memory came from, so
+    // that builds with and without STATIC_ALLOC can be compared
+    Serial << "Boot took " << micros () - setup_start << " us in setup(), "
+           << micros () << " us since reset" << endl;
+    Serial << "Task memory: " << PeriodicTask::static_bytes () << " bytes static, "
+           << xPortGetFreeHeapSize () << " bytes of heap free" << endl;
 
-    // Task for the IMU readings
-    xTaskCreate (task_IMU, "IMU", 2048, NULL, 30, NULL);
+    // Show the task table; the timing columns fill in as the tasks run
+    PeriodicTask::print_all (Serial);
 }
 
 
@@ -0,0 +1,222 @@
+/** @file matrix.h
+ *  @brief A small matrix template whose size is fixed when the program is
+ *         compiled.
+ *  @details A @c Matrix<R,C> is just an array of @c R times @c C floats, so it
+ *           lives on the stack or inside the object which uses it and is
+ *           never allocated from the heap. Since every size is a constant,
+ *           the compiler checks that the sizes of a product or sum agree, and
+ *           the loops in each operation have fixed lengths and are unrolled;
+ *           an operation always takes the same time. It is meant for the
+ *           3 to 7 row matrices of a Kalman filter, not for large ones.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// Compile this header file only once
+#ifndef _MATRIX_H_
+#define _MATRIX_H_
+
+#include <Arduino.h>
+
+/// Asks the compiler to unroll the loop which follows, even when optimizing for size
+#define MATRIX_UNROLL _Pragma("GCC unroll 8")
+
+
+/** @brief   Matrix of floats with a fixed number of rows and columns.
+ *  @details Elements are read and written as @c A(row, col), counting from
+ *           zero. The elements are public so that a matrix may be filled in
+ *           with braces, row by row.
+ *  @tparam  R The number of rows
+ *  @tparam  C The number of columns
+ */
+template <uint8_t R, uint8_t C> class Matrix
+{
+public:
+    float m[R][C];                  ///< The elements, row by row
+
+    /// Get a reference to one element
+    float& operator()(uint8_t row, uint8_t col) { return m[row][col]; }
+
+    /// Get the value of one element
+    float operator()(uint8_t row, uint8_t col) const { return m[row][col]; }
+
+    /** @brief   Make a matrix full of zeros.
+     *  @returns The zero matrix
+     */
+    static Matrix zeros(void)
+    {
+        Matrix result;
+        for (uint8_t row = 0; row < R; row++)
+        {
+            MATRIX_UNROLL
+            for (uint8_t col = 0; col < C; col++)
+            {
+                result.m[row][col] = 0.0f;
+            }
+        }
+        return result;
+    }
+
+    /** @brief   Make a square matrix with a given value on its diagonal.
+     *  @param   value The value of each diagonal element
+     *  @returns The matrix, @c value times the identity
+     */
+    static Matrix diagonal(float value = 1.0f)
+    {
+        static_assert(R == C, "Only a square matrix has a diagonal");
+        Matrix result = zeros();
+        for (uint8_t index = 0; index < R; index++)
+        {
+            result.m[index][index] = value;
+        }
+        return result;
+    }
+
+    /** @brief   Transpose the matrix.
+     *  @returns A new matrix whose rows are this one's columns
+     */
+    Matrix<C, R> transpose(void) const
+    {
+        Matrix<C, R> result;
+        for (uint8_t row = 0; row < R; row++)
+        {
+            MATRIX_UNROLL
+            for (uint8_t col = 0; col < C; col++)
+            {
+                result.m[col][row] = m[row][col];
+            }
+        }
+        return result;
+    }
+
+    /** @brief   Add another matrix of the same size.
+     *  @param   other The matrix to add
+     *  @returns The sum
+     */
+    Matrix operator+(const Matrix& other) const
+    {
+        Matrix result;
+        for (uint8_t row = 0; row < R; row++)
+        {
+            MATRIX_UNROLL
+            for (uint8_t col = 0; col < C; col++)
+            {
+                result.m[row][col] = m[row][col] + other.m[row][col];
+            }
+        }
+        return result;
+    }
+
+    /** @brief   Subtract another matrix of the same size.
+     *  @param   other The matrix to subtract
+     *  @returns The difference
+     */
+    Matrix operator-(const Matrix& other) const
+    {
+        Matrix result;
+        for (uint8_t row = 0; row < R; row++)
+        {
+            MATRIX_UNROLL
+            for (uint8_t col = 0; col < C; col++)
+            {
+                result.m[row][col] = m[row][col] - other.m[row][col];
+            }
+        }
+        return result;
+    }
+
+    /** @brief   Multiply every element by a number.
+     *  @param   scale The number
+     *  @returns The scaled matrix
+     */
+    Matrix operator*(float scale) const
+    {
+        Matrix result;
+        for (uint8_t row = 0; row < R; row++)
+        {
+            MATRIX_UNROLL
+            for (uint8_t col = 0; col < C; col++)
+            {
+                result.m[row][col] = m[row][col] * scale;
+            }
+        }
+        return result;
+    }
+
+    /** @brief   Multiply by a matrix with as many rows as this one has columns.
+     *  @tparam  K The number of columns of the other matrix
+     *  @param   other The matrix on the right
+     *  @returns The product, with this matrix's rows and the other's columns
+     */
+    template <uint8_t K>
+    Matrix<R, K> operator*(const Matrix<C, K>& other) const
+    {
+        Matrix<R, K> result;
+        for (uint8_t row = 0; row < R; row++)
+        {
+            for (uint8_t col = 0; col < K; col++)
+            {
+                float sum = 0.0f;
+                MATRIX_UNROLL
+                for (uint8_t inner = 0; inner < C; inner++)
+                {
+                    sum += m[row][inner] * other.m[inner][col];
+                }
+                result.m[row][col] = sum;
+            }
+        }
+        return result;
+    }
+
+    /** @brief   Make a square matrix exactly symmetric.
+     *  @details Each pair of elements across the diagonal is set to its mean,
+     *           which stops rounding from slowly making a covariance matrix
+     *           lopsided.
+     */
+    void symmetrize(void)
+    {
+        static_assert(R == C, "Only a square matrix can be symmetric");
+        for (uint8_t row = 0; row < R; row++)
+        {
+            for (uint8_t col = row + 1; col < C; col++)
+            {
+                float mean = 0.5f * (m[row][col] + m[col][row]);
+                m[row][col] = mean;
+                m[col][row] = mean;
+            }
+        }
+    }
+};
+
+
+/** @brief   Invert a 3 by 3 matrix by its cofactors.
+ *  @param   A The matrix to invert
+ *  @param   inverse Set to the inverse of @c A, if it has one
+ *  @returns True if @c A was inverted, false if it is singular
+ */
+inline bool invert(const Matrix<3, 3>& A, Matrix<3, 3>& inverse)
+{
+    float c00 = A(1, 1) * A(2, 2) - A(1, 2) * A(2, 1);
+    float c01 = A(1, 2) * A(2, 0) - A(1, 0) * A(2, 2);
+    float c02 = A(1, 0) * A(2, 1) - A(1, 1) * A(2, 0);
+    float det = A(0, 0) * c00 + A(0, 1) * c01 + A(0, 2) * c02;
+    if (det == 0.0f)
+    {
+        return false;
+    }
+
+    float inv_det = 1.0f / det;
+    inverse(0, 0) = c00 * inv_det;
+    inverse(1, 0) = c01 * inv_det;
+    inverse(2, 0) = c02 * inv_det;
+    inverse(0, 1) = (A(0, 2) * A(2, 1) - A(0, 1) * A(2, 2)) * inv_det;
+    inverse(1, 1) = (A(0, 0) * A(2, 2) - A(0, 2) * A(2, 0)) * inv_det;
+    inverse(2, 1) = (A(0, 1) * A(2, 0) - A(0, 0) * A(2, 1)) * inv_det;
+    inverse(0, 2) = (A(0, 1) * A(1, 2) - A(0, 2) * A(1, 1)) * inv_det;
+    inverse(1, 2) = (A(0, 2) * A(1, 0) - A(0, 0) * A(1, 2)) * inv_det;
+    inverse(2, 2) = (A(0, 0) * A(1, 1) - A(0, 1) * A(1, 0)) * inv_det;
+    return true;
+}
+
+#endif // _MATRIX_H_
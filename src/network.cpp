@@ -21,6 +21,8 @@
 #include <WebServer.h>
 #include <shares.h>
 #include <taskshare.h>
+#include "periodic.h"
+#include "flightmode.h"
 
 Share<bool> web_calibrate ("Flag to calibrate/zero");       ///< A share containing a boolean flagging the main script to zero the potentiometers
 
@@ -199,14 +201,13 @@ void handle_NotFound (void)
 }
 
 
-/** @brief   Switches the state in a FSM when called by the web server.
- *  @details This method alters a shared variable that contains the current state
- *           of a FSM in the controller task located in main.cpp. The state is switched
- *           to 1.
+/** @brief   Arms the controller when called by the web server.
+ *  @details This method posts an activate event to the flight mode state
+ *           machine in main.cpp, which moves from DISABLED to WAIT FOR LAUNCH.
  */
 void handle_Activate (void)
 {
-    tc_state.put(1);
+    flight_mode.post(EV_ACTIVATE);
 
     String toggle_page = "<!DOCTYPE html> <html> <head>\n";
     toggle_page += "<meta http-equiv=\"refresh\" content=\"1; url='/'\" />\n";
@@ -217,14 +218,13 @@ void handle_Activate (void)
 }
 
 
-/** @brief   Switches the state in a FSM when called by the web server.
- *  @details This method alters a shared variable that contains the current state
- *           of a FSM in the controller task located in main.cpp. The state is switched
- *           to 0.
+/** @brief   Disarms the controller when called by the web server.
+ *  @details This method posts a deactivate event to the flight mode state
+ *           machine in main.cpp, which moves to DISABLED from any state.
  */
 void handle_Deactivate (void)
 {
-    tc_state.put(0);
+    flight_mode.post(EV_DEACTIVATE);
 
     String toggle_page = "<!DOCTYPE html> <html> <head>\n";
     toggle_page += "<meta http-equiv=\"refresh\" content=\"1; url='/'\" />\n";
@@ -235,16 +235,14 @@ void handle_Deactivate (void)
 }
 
 
-/** @brief   Switches the state in a FSM when called by the web server.
- *  @details This method alters a shared variable that contains the current state
- *           of a FSM in the controller task located in main.cpp. The state is switched
- *           to 1 and a calibrate boolean is set to true whic will be handled in the
- *           controller task.
+/** @brief   Asks for the potentiometers to be zeroed when called by the web server.
+ *  @details This method posts a calibrate event to the flight mode state
+ *           machine in main.cpp, which moves to DISABLED and sets the
+ *           calibrate flag that is handled in the servo task.
  */
 void handle_Calibrate (void)
 {
-    web_calibrate.put(1);
-    tc_state.put(0);
+    flight_mode.post(EV_CALIBRATE);
 
     String toggle_page = "<!DOCTYPE html> <html> <head>\n";
     toggle_page += "<meta http-equiv=\"refresh\" content=\"1; url='/'\" />\n";
@@ -260,10 +258,14 @@ void handle_Calibrate (void)
  *           to check for page requests from web clients. One could run this
  *           task as the lowest priority task with a short or no delay, as there
  *           generally isn't much rush in replying to web queries.
- *  @param   p_params Pointer to unused parameters
+ *  @param   p_params A pointer to this task's @c PeriodicTask object
  */
 void task_webserver (void* p_params)
 {
+    // Releases the task at the period given in the task table
+    PeriodicTask& schedule = *(PeriodicTask*)p_params;
+
+
     // The server has been created statically when the program was started and
     // is accessed as a global object because not only this function but also
     // the page handling functions referenced below need access to the server
@@ -281,6 +283,6 @@ void task_webserver (void* p_params)
     {
         // The web server must be periodically run to watch for page requests
         server.handleClient ();
-        vTaskDelay (500);
+        schedule.wait ();
     }
 }
\ No newline at end of file
@@ -0,0 +1,191 @@
+/** @file    notifyshare.h
+ *  @brief   Lock-free shared data which wakes a waiting task when it changes.
+ *  @details This file contains a template class which adds change
+ *           notification to @c FastShare<DataType>. One task may sleep in
+ *           @c wait() until another task or an ISR puts a different value
+ *           into the share, instead of polling the share periodically.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// This define prevents this .h file from being included more than once
+#ifndef _NOTIFYSHARE_H_
+#define _NOTIFYSHARE_H_
+
+#include "fastshare.h"
+
+
+/** @brief   Class for lock-free shared data which notifies a task of changes.
+ *  @details A @c NotifyShare works like a @c FastShare, except that putting a
+ *           value which differs from the one already in the share wakes the
+ *           share's subscriber. The subscriber is the task which most recently
+ *           called @c wait(); only one task should wait on a given share. The
+ *           subscriber is woken with its FreeRTOS task notification, so it
+ *           should not use its notification for anything else. Putting the
+ *           same value again does nothing, so a producer which rewrites an
+ *           unchanged value every cycle causes no wakeups.
+ *
+ *           The time at which the latest change was put is kept so that the
+ *           subscriber can measure how long it took to respond.
+ *
+ *           @section usage_notifyshare Usage
+ *           @code
+ *           NotifyShare<int16_t> duty_share ("Duty");
+ *           ...
+ *           duty_share.put (duty);               // In the sending task
+ *           ...
+ *           int16_t duty_now;                    // In the receiving task
+ *           duty_share.wait (duty_now);          // Sleeps until duty changes
+ *           motor.set_duty (duty_now);
+ *           @endcode
+ */
+template <class DataType> class NotifyShare : public FastShare<DataType>
+{
+protected:
+    /// The task which is waiting for changes, or @c NULL if none has waited
+    std::atomic<TaskHandle_t> subscriber;
+
+    /// Value of micros() when the latest change was put
+    std::atomic<uint32_t> change_time_us;
+
+    /// Sequence number of the value the subscriber read most recently
+    uint32_t seen_sequence;
+
+    /** @brief   Write new data if it differs from the data in the share.
+     *  @details This method must only be called while the write lock is held.
+     *  @param   new_data A reference to the data which is to be written
+     *  @returns @c true if the data changed and the subscriber should be woken
+     */
+    bool write_if_changed (const DataType& new_data)
+    {
+        if (memcmp (&this->data, &new_data, sizeof (DataType)) == 0
+            && this->sequence.load (std::memory_order_relaxed) != 0)
+        {
+            return false;
+        }
+        change_time_us.store (micros (), std::memory_order_relaxed);
+        this->write (new_data);
+        return true;
+    }
+
+public:
+    /** @brief   Construct a notifying shared data item.
+     *  @param   p_name A name to be shown in the list of task shares
+     *           (default @c NULL)
+     */
+    NotifyShare<DataType> (const char* p_name = NULL)
+        : FastShare<DataType> (p_name), subscriber (NULL), change_time_us (0),
+          seen_sequence (0)
+    {
+    }
+
+    /** @brief   Put data into the share and wake the subscriber if it changed.
+     *  @details This method must @b not be called from within an ISR.
+     *  @param   new_data The data which is to be written
+     */
+    void put (DataType new_data)
+    {
+        portENTER_CRITICAL (&this->write_lock);
+        bool changed = write_if_changed (new_data);
+        portEXIT_CRITICAL (&this->write_lock);
+
+        // The counter was written before the subscriber is read, and wait()
+        // does the reverse; only sequentially consistent ordering keeps both
+        // sides from reading the old value, which would lose the wakeup
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        TaskHandle_t task = subscriber.load (std::memory_order_seq_cst);
+        if (changed && task != NULL)
+        {
+            xTaskNotifyGive (task);
+        }
+        if (changed)
+        {
+            this->publish ();
+        }
+    }
+
+    /** @brief   Put data into the share from within an ISR, waking the
+     *           subscriber if the data changed.
+     *  @details This method must only be called from within an interrupt
+     *           service routine, not a normal task.
+     *  @param   new_data The data to be written into the shared data item
+     */
+    void ISR_put (DataType new_data)
+    {
+        portENTER_CRITICAL_ISR (&this->write_lock);
+        bool changed = write_if_changed (new_data);
+        portEXIT_CRITICAL_ISR (&this->write_lock);
+
+        // Ordered against wait() as in put()
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        TaskHandle_t task = subscriber.load (std::memory_order_seq_cst);
+        if (changed && task != NULL)
+        {
+            BaseType_t higher_priority_woken = pdFALSE;
+            vTaskNotifyGiveFromISR (task, &higher_priority_woken);
+            portYIELD_FROM_ISR (higher_priority_woken);
+        }
+        if (changed)
+        {
+            this->ISR_publish ();
+        }
+    }
+
+    /** @brief   Operator which inserts data into the share.
+     *  @details This operator calls @c ISR_put() or @c put() depending on
+     *           whether it is running in an ISR.
+     *  @param   new_data The data which is to be put into the share
+     */
+    void operator << (DataType new_data)
+    {
+        if (CHECK_IF_IN_ISR ())
+        {
+            ISR_put (new_data);
+        }
+        else
+        {
+            put (new_data);
+        }
+    }
+
+    /** @brief   Sleep until the share holds data this task hasn't read yet.
+     *  @details The calling task becomes the share's subscriber. If the data
+     *           has changed since the subscriber's last call, this method
+     *           returns at once; otherwise the task sleeps until a change is
+     *           put or the wait times out.
+     *  @param   recv_data A reference to the variable in which to put the data
+     *  @param   ticks_to_wait How many RTOS ticks to wait for a change
+     *           (default: forever)
+     *  @returns @c true if new data was read, @c false if the wait timed out
+     */
+    bool wait (DataType& recv_data, TickType_t ticks_to_wait = portMAX_DELAY)
+    {
+        subscriber.store (xTaskGetCurrentTaskHandle (), std::memory_order_seq_cst);
+
+        // A change put after this check leaves a notification pending, so
+        // ulTaskNotifyTake() returns at once and the change is not missed.
+        // The store above and this load are sequentially consistent, so a
+        // put() which finds no subscriber is one whose change is seen here
+        while (this->sequence.load (std::memory_order_seq_cst) == seen_sequence)
+        {
+            if (ulTaskNotifyTake (pdTRUE, ticks_to_wait) == 0)
+            {
+                return false;
+            }
+        }
+
+        seen_sequence = this->read (recv_data);
+        return true;
+    }
+
+    /** @brief   Return the time at which the latest change was put.
+     *  @returns The value of micros() when the data last changed
+     */
+    uint32_t change_time (void)
+    {
+        return change_time_us.load (std::memory_order_relaxed);
+    }
+}; // class NotifyShare<DataType>
+
+#endif  // _NOTIFYSHARE_H_
@@ -0,0 +1,198 @@
+/** @file    periodic.cpp
+ *  @brief   Source file for tasks which are released at fixed intervals.
+ *  @details This file contains the methods of class @c PeriodicTask, which
+ *           start each task, hold periodic tasks to their release times and
+ *           report how the schedule has been running.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "periodic.h"
+
+
+// Set pointer to most recently created task to initially be NULL
+PeriodicTask* PeriodicTask::p_newest = NULL;
+
+
+/** @brief   Describe one task.
+ *  @details The task is put in the list of all tasks, from which the schedule
+ *           report is printed. It is not started until @c start() is called.
+ *  @param   function The function which runs as the task
+ *  @param   p_name A name for the task
+ *  @param   period_ms The time between releases (ms), or 0 if the task is
+ *           event driven
+ *  @param   priority The task's priority
+ *  @param   core The core on which the task runs, or @c tskNO_AFFINITY
+ *  @param   memory The task's stack and control block
+ */
+PeriodicTask::PeriodicTask (TaskFunction_t function, const char* p_name,
+                            TickType_t period_ms, UBaseType_t priority,
+                            BaseType_t core, TaskMemoryBase& memory)
+    : function (function), name (p_name),
+      period (period_ms / portTICK_PERIOD_MS), priority (priority),
+      core (core), memory (memory)
+{
+    reset_stats ();
+
+    // Install this task in the linked list of tasks
+    p_next = p_newest;
+    p_newest = this;
+}
+
+
+/** @brief   Start the task.
+ *  @details The task function receives a pointer to this object as its
+ *           parameter, so that it can call @c wait(). FreeRTOS quietly
+ *           lowers a priority of @c configMAX_PRIORITIES or more to the
+ *           highest there is, which would leave tasks meant to be ordered
+ *           sharing it, so such a priority is caught here.
+ *  @returns A handle to the new task, or @c NULL if it couldn't be created
+ */
+TaskHandle_t PeriodicTask::start (void)
+{
+    configASSERT (priority < configMAX_PRIORITIES);
+    return memory.start (function, name, priority, this, core);
+}
+
+
+/** @brief   End the current cycle and sleep until the next release.
+ *  @details The first call only marks the first release, so that the time a
+ *           task spends setting up before its loop is not counted as a cycle.
+ *           After that each call measures the cycle's execution time. If the
+ *           deadline (the next release) has already passed, the cycle is
+ *           counted as an overrun and the releases which passed are skipped,
+ *           so the task resumes at the next release on its original grid.
+ */
+void PeriodicTask::wait (void)
+{
+    if (first_release_us < 0)
+    {
+        last_release = xTaskGetTickCount ();
+        first_release_us = esp_timer_get_time ();
+    }
+    else
+    {
+        uint32_t execution_us = (uint32_t)(esp_timer_get_time () - release_us);
+        busy_us += execution_us;
+        if (execution_us > worst_us)
+        {
+            worst_us = execution_us;
+        }
+        cycles++;
+
+        TickType_t late = xTaskGetTickCount () - last_release;
+        if (late >= period)
+        {
+            overruns++;
+            missed += late / period;
+            last_release += (late / period) * period;
+        }
+    }
+
+    vTaskDelayUntil (&last_release, period);
+    release_us = esp_timer_get_time ();
+}
+
+
+/** @brief   Clear the task's timing statistics.
+ *  @details The next call to @c wait() marks a new first release.
+ */
+void PeriodicTask::reset_stats (void)
+{
+    first_release_us = -1;
+    cycles = 0;
+    overruns = 0;
+    missed = 0;
+    worst_us = 0;
+    busy_us = 0;
+}
+
+
+/** @brief   Print one line of the schedule report.
+ *  @details The line shows the task's configuration and, for a periodic
+ *           task, its cycles, overruns and skipped releases, average and
+ *           worst case execution times, and the fraction of the time since
+ *           its first release for which it was running.
+ *  @param   printer The serial device on which to print
+ */
+void PeriodicTask::print_in_list (Print& printer)
+{
+    printer.printf ("%-18s %4s %4u %6u ", name,
+                    (core == tskNO_AFFINITY) ? "any" : (core ? "1" : "0"),
+                    (unsigned)priority, (unsigned)memory.stack_size ());
+
+    if (period == 0)
+    {
+        printer.printf ("  event\r\n");
+        return;
+    }
+
+    printer.printf ("%7u", (unsigned)(period * portTICK_PERIOD_MS));
+    if (cycles == 0)
+    {
+        printer.printf ("\r\n");
+        return;
+    }
+
+    int64_t elapsed_us = esp_timer_get_time () - first_release_us;
+    float utilisation = (elapsed_us > 0) ? 100.0f * busy_us / elapsed_us : 0;
+    printer.printf (" %7u %5u %5u %8u %8u %6.2f\r\n", (unsigned)cycles,
+                    (unsigned)overruns, (unsigned)missed,
+                    (unsigned)(busy_us / cycles), (unsigned)worst_us,
+                    utilisation);
+}
+
+
+/** @brief   Print the schedule report for every task.
+ *  @details One line is printed per task, oldest first, followed by the sum
+ *           of the periodic tasks' utilisations. Event driven tasks show only
+ *           their configuration.
+ *  @param   printer The serial device on which to print
+ */
+void PeriodicTask::print_all (Print& printer)
+{
+    printer.printf ("Task               Core Prio  Stack Period  Cycles  Over  Miss"
+                    "   Avg us  WCET us  Util%%\r\n");
+
+    // The list runs newest to oldest; print it in the order of the table
+    uint16_t count = 0;
+    for (PeriodicTask* p_task = p_newest; p_task != NULL; p_task = p_task->p_next)
+    {
+        count++;
+    }
+    float total = 0;
+    for (uint16_t index = count; index > 0; index--)
+    {
+        PeriodicTask* p_task = p_newest;
+        for (uint16_t step = 1; step < index; step++)
+        {
+            p_task = p_task->p_next;
+        }
+        p_task->print_in_list (printer);
+
+        int64_t elapsed_us = esp_timer_get_time () - p_task->first_release_us;
+        if (p_task->cycles > 0 && elapsed_us > 0)
+        {
+            total += 100.0f * p_task->busy_us / elapsed_us;
+        }
+    }
+    printer.printf ("Periodic tasks' total utilisation %.2f%%\r\n", total);
+}
+
+
+/** @brief   Add up the memory reserved at compile time for every task.
+ *  @returns The number of bytes of stacks and control blocks which are
+ *           reserved statically; zero unless built with @c STATIC_ALLOC
+ */
+uint32_t PeriodicTask::static_bytes (void)
+{
+    uint32_t bytes = 0;
+    for (PeriodicTask* p_task = p_newest; p_task != NULL; p_task = p_task->p_next)
+    {
+        bytes += p_task->memory.static_bytes ();
+    }
+    return bytes;
+}
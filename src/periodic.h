@@ -0,0 +1,131 @@
+/** @file    periodic.h
+ *  @brief   Tasks which are released at fixed, drift-free intervals.
+ *  @details This file contains a class which describes one task of the
+ *           program: its function, name, period, priority, core and memory.
+ *           The tasks are declared together in one table in @c setup() and
+ *           started from it. A periodic task calls @c wait() at the end of
+ *           each cycle, which sleeps until the task's next release time with
+ *           @c vTaskDelayUntil(). Release times are counted from the first
+ *           release, so unlike @c vTaskDelay(period) the cycles don't stretch
+ *           by the time the task takes to run or spends preempted.
+ *
+ *           Each periodic task counts its cycles and overruns and keeps its
+ *           longest and total execution times, from which
+ *           @c PeriodicTask::print_all() prints a table of the whole
+ *           program's schedule and measured utilisation.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// This define prevents this .h file from being included more than once
+#ifndef _PERIODIC_H_
+#define _PERIODIC_H_
+
+#include <Arduino.h>
+#include "taskmemory.h"
+
+
+/** @brief   Class which describes, starts and times one task.
+ *  @details The task function is given a pointer to its @c PeriodicTask
+ *           object as its parameter. A task with a period of zero is event
+ *           driven (it waits on a share or notification instead) and never
+ *           calls @c wait(); it is started from the table like the others.
+ *
+ *           A cycle's execution time is measured from its release to its
+ *           call of @c wait(), so it includes any time the task spent
+ *           preempted by higher priority tasks. The worst case is then an
+ *           upper bound on the task's own execution time. When a cycle runs
+ *           past its deadline, the releases it missed are skipped rather
+ *           than run back to back, and the next release stays on the
+ *           original grid of periods.
+ *
+ *           @section usage_periodic Usage
+ *           @code
+ *           void task_sensor (void* p_params)
+ *           {
+ *               PeriodicTask& schedule = *(PeriodicTask*)p_params;
+ *               ...                                  // Set up the task
+ *               while (true)
+ *               {
+ *                   ...                              // Do one cycle's work
+ *                   schedule.wait ();
+ *               }
+ *           }
+ *           ...
+ *           static PeriodicTask tasks[] =            // In setup()
+ *           {   //  Function     Name      Period Priority Core  Memory
+ *               { task_sensor, "Sensor",    10,     30,     1,  sensor_memory },
+ *           };
+ *           for (PeriodicTask& task : tasks)
+ *           {
+ *               task.start ();
+ *           }
+ *           @endcode
+ */
+class PeriodicTask
+{
+protected:
+    TaskFunction_t function;                ///< The function which runs as the task
+    const char* name;                       ///< The task's name
+    TickType_t period;                      ///< Time between releases (ticks), or 0
+    UBaseType_t priority;                   ///< The task's priority
+    BaseType_t core;                        ///< The core it runs on, or @c tskNO_AFFINITY
+    TaskMemoryBase& memory;                 ///< The task's stack and control block
+
+    TickType_t last_release;                ///< Tick count of the latest release
+    int64_t release_us;                     ///< Time of the latest release (us)
+    int64_t first_release_us;               ///< Time of the first release (us), or -1
+    uint32_t cycles;                        ///< Number of cycles completed
+    uint32_t overruns;                      ///< Cycles which ran past their deadline
+    uint32_t missed;                        ///< Releases skipped because of overruns
+    uint32_t worst_us;                      ///< Longest execution time (us)
+    uint64_t busy_us;                       ///< Total execution time (us)
+
+    /// Next task in the list of all tasks; the list goes newest to oldest
+    PeriodicTask* p_next;
+
+    /// The most recently created task, at the head of the list
+    static PeriodicTask* p_newest;
+
+public:
+    // Describe a task; it is not started until start() is called
+    PeriodicTask (TaskFunction_t function, const char* p_name,
+                  TickType_t period_ms, UBaseType_t priority, BaseType_t core,
+                  TaskMemoryBase& memory);
+
+    // Start the task, passing it a pointer to this object
+    TaskHandle_t start (void);
+
+    // End a cycle and sleep until the next release
+    void wait (void);
+
+    // Clear the task's timing statistics
+    void reset_stats (void);
+
+    // Print one line of the schedule report
+    void print_in_list (Print& printer);
+
+    // Print the schedule report for every task
+    static void print_all (Print& printer);
+
+    // Add up the memory reserved at compile time for every task
+    static uint32_t static_bytes (void);
+
+    /** @brief   Return the task's period.
+     *  @returns The time between releases (ticks), or 0 if event driven
+     */
+    TickType_t get_period (void) { return period; }
+
+    /** @brief   Return the number of cycles which ran past their deadline.
+     *  @returns The number of overruns since the task started
+     */
+    uint32_t get_overruns (void) { return overruns; }
+
+    /** @brief   Return the longest execution time measured.
+     *  @returns The worst case execution time (us)
+     */
+    uint32_t get_worst_us (void) { return worst_us; }
+}; // class PeriodicTask
+
+#endif // _PERIODIC_H_
@@ -0,0 +1,123 @@
+/** @file potcal.cpp
+ *  @brief This is the source file containing the constructor and methods for
+ *         a potentiometer calibration table.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include "potcal.h"
+
+/// Names of the sources of a table, in the order of PotCalSource
+static const char* SOURCE_NAMES[POTCAL_SOURCES] =
+    { "none", "nominal", "eFuse", "sweep", "default Vref" };
+
+/** @brief   Constructor which creates a table which reads zero everywhere
+ */
+PotCalibration::PotCalibration(void)
+{
+    for (uint16_t segment = 0; segment < POTCAL_SEGMENTS; segment++)
+    {
+        slope[segment] = 0.0f;
+        intercept[segment] = 0.0f;
+    }
+    source = POTCAL_NONE;
+}
+
+/** @brief   Sets the table from the angles at each of its points
+ *  @param   degrees The angles at 0, 1, 2... times 2^POTCAL_SHIFT counts,
+ *           @c POTCAL_POINTS of them (deg)
+ *  @param   from Where the angles came from
+ */
+void PotCalibration::set_points(const float* degrees, PotCalSource from)
+{
+    const float width = (float)(1 << POTCAL_SHIFT);
+    for (uint16_t segment = 0; segment < POTCAL_SEGMENTS; segment++)
+    {
+        float start = (float)(segment << POTCAL_SHIFT);
+        slope[segment] = (degrees[segment + 1] - degrees[segment]) / width;
+        intercept[segment] = degrees[segment] - slope[segment] * start;
+    }
+    source = from;
+}
+
+/** @brief   Sets the table to a straight line
+ *  @details This is the conversion used before there was a table, so a
+ *           potentiometer which has not been calibrated reads as it did.
+ *  @param   degrees_per_count The scale (deg/count)
+ *  @param   degrees_at_zero The angle at zero counts (deg)
+ */
+void PotCalibration::set_linear(float degrees_per_count, float degrees_at_zero)
+{
+    for (uint16_t segment = 0; segment < POTCAL_SEGMENTS; segment++)
+    {
+        slope[segment] = degrees_per_count;
+        intercept[segment] = degrees_at_zero;
+    }
+    source = POTCAL_NOMINAL;
+}
+
+/** @brief   Sets the table to pass through measured angles
+ *  @details Between the measurements the angle is taken to be a straight
+ *           line, and beyond the first and last it carries on along the
+ *           line to the next one in. A handful of measurements spread across
+ *           the travel, with more where the response bends, is enough.
+ *  @param   counts The ADC readings, in increasing order (counts)
+ *  @param   degrees The angle at each reading (deg)
+ *  @param   count The number of measurements, at least two
+ *  @returns True if the table was set, false if there were too few
+ *           measurements or they were out of order, leaving it as it was
+ */
+bool PotCalibration::fit(const float* counts, const float* degrees, uint8_t count)
+{
+    if (count < 2)
+    {
+        return false;
+    }
+    for (uint8_t index = 1; index < count; index++)
+    {
+        if (counts[index] <= counts[index - 1])
+        {
+            return false;
+        }
+    }
+
+    float points[POTCAL_POINTS];
+    uint8_t above = 1;                  // The measurement which ends the current line
+    for (uint16_t point = 0; point < POTCAL_POINTS; point++)
+    {
+        float at = (float)(point << POTCAL_SHIFT);
+        while (above < count - 1 && counts[above] < at)
+        {
+            above++;
+        }
+        float fraction = (at - counts[above - 1]) / (counts[above] - counts[above - 1]);
+        points[point] = degrees[above - 1] + fraction * (degrees[above] - degrees[above - 1]);
+    }
+    set_points(points, POTCAL_SWEEP);
+    return true;
+}
+
+/** @brief   Copies the angles at each of the table's points
+ *  @param   degrees Filled with @c POTCAL_POINTS angles, as given to
+ *           @c set_points() (deg)
+ */
+void PotCalibration::get_points(float* degrees) const
+{
+    for (uint16_t segment = 0; segment < POTCAL_SEGMENTS; segment++)
+    {
+        degrees[segment] = this->degrees((float)(segment << POTCAL_SHIFT));
+    }
+    degrees[POTCAL_SEGMENTS] = intercept[POTCAL_SEGMENTS - 1]
+                               + slope[POTCAL_SEGMENTS - 1] * POTCAL_RANGE;
+}
+
+/** @brief   Returns the name of where a table came from
+ *  @param   from The source
+ *  @returns A short name, for printing
+ */
+const char* PotCalibration::source_name(PotCalSource from)
+{
+    return (from < POTCAL_SOURCES) ? SOURCE_NAMES[from] : "?";
+}
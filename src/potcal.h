@@ -0,0 +1,92 @@
+/** @file potcal.h
+ *  @brief The header file for a lookup table which converts potentiometer
+ *         ADC counts to degrees.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// Compile this header file only once
+#ifndef _POTCAL_H_
+#define _POTCAL_H_
+
+#include <Arduino.h>
+
+/// Counts per segment of the table are 2 to this power
+#define POTCAL_SHIFT 6
+
+/// Range of the 12 bit ADC (counts)
+#define POTCAL_RANGE 4096
+
+/// Straight segments in the table
+#define POTCAL_SEGMENTS (POTCAL_RANGE >> POTCAL_SHIFT)
+
+/// Points where the segments join, including both ends
+#define POTCAL_POINTS (POTCAL_SEGMENTS + 1)
+
+/// Where a table came from
+enum PotCalSource
+{
+    POTCAL_NONE,            ///< Nothing yet; every reading is zero degrees
+    POTCAL_NOMINAL,         ///< A straight line through the nominal scale
+    POTCAL_EFUSE,           ///< The chip's ADC characterisation from its eFuses
+    POTCAL_SWEEP,           ///< Angles measured at points across the travel
+    POTCAL_DEFAULT_VREF,    ///< The ADC's typical curve, for a chip with no eFuse calibration
+    POTCAL_SOURCES
+};
+
+/** @brief  Class which converts ADC counts to degrees with a table.
+ *  @details The ADC's range is split into @c POTCAL_SEGMENTS segments of
+ *           equal width, each a straight line. The segment is picked by
+ *           shifting the integer part of the counts, and the angle is then
+ *           one multiply and one add, so a curved or per-chip response costs
+ *           no more than the fixed scale did. The lines meet at
+ *           @c POTCAL_POINTS points, which are all that needs storing; the
+ *           slope and intercept of each segment are worked out from them
+ *           when the table is set.
+ */
+class PotCalibration
+{
+protected:
+    float slope[POTCAL_SEGMENTS];       ///< Degrees per count in each segment
+    float intercept[POTCAL_SEGMENTS];   ///< Degrees at zero counts on each segment's line
+    PotCalSource source;                ///< Where the table came from
+
+public:
+    // Create an empty table
+    PotCalibration(void);
+
+    // Set the table from the angles at each of its points
+    void set_points(const float* degrees, PotCalSource from);
+
+    // Set the table to a straight line
+    void set_linear(float degrees_per_count, float degrees_at_zero);
+
+    // Set the table to pass through measured angles
+    bool fit(const float* counts, const float* degrees, uint8_t count);
+
+    // Copy the angles at each of the table's points
+    void get_points(float* degrees) const;
+
+    // Return where the table came from
+    PotCalSource get_source(void) const { return source; }
+
+    // Return the name of where a table came from
+    static const char* source_name(PotCalSource from);
+
+    /** @brief   Converts a reading to degrees.
+     *  @param   counts The ADC reading, which may have a fraction (counts)
+     *  @returns The angle (deg)
+     */
+    float degrees(float counts) const
+    {
+        uint32_t segment = (uint32_t)counts >> POTCAL_SHIFT;
+        if (segment >= POTCAL_SEGMENTS)
+        {
+            segment = POTCAL_SEGMENTS - 1;
+        }
+        return intercept[segment] + slope[segment] * counts;
+    }
+};
+
+#endif // _POTCAL_H_
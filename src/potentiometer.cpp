@@ -4,47 +4,117 @@
  * 
  *  @author  Damond Li
  *  @date    2022-Nov-03 Original file
+ *  @date    2026-Oct-16 Readings from an @c AdcStream
+ *  @date    2026-Oct-16 Calibration tables from eFuses, kept in NVS
  */
 
 #include <Arduino.h>
+#include <Preferences.h>
+#include <esp_adc_cal.h>
 #include "potentiometer.h"
 
+/// NVS namespace holding the calibration tables
+#define POT_NVS_NAMESPACE "potcal"
+
+/// Layout of the stored tables; change it whenever the record changes. Version
+/// 1 could hold default reference tables marked as eFuse ones, so they are
+/// built again
+#define POT_NVS_VERSION 2
+
+/// One calibration table as stored in NVS
+struct PotCalRecord
+{
+    uint8_t version;                    ///< POT_NVS_VERSION when it was stored
+    uint8_t source;                     ///< Where the table came from, a PotCalSource
+    float points[POTCAL_POINTS];        ///< The table's points (deg)
+};
+
 /** @brief   Constructor which creates a potentiometer object
  *  @param   pin The GPIO input pin to read voltages from
  *  @param   offset The offset values used to zero the potentiometer
+ *  @param   p_stream A stream which samples the pin, or NULL to read it with
+ *           @c analogRead()
+ *  @param   p_table A calibration table to convert readings to angles, or
+ *           NULL to scale the voltage. Until it is loaded or built, the
+ *           table is set to the nominal scale.
  */
-Potentiometer::Potentiometer(uint8_t pin, float offset)
+Potentiometer::Potentiometer(uint8_t pin, float offset, AdcStream* p_stream,
+                             PotCalibration* p_table)
 {
     // Establish the pin that will read the voltage
     ADC_PIN = pin;
     // Establish the voltage offset
     voltage_offset = offset;
+    // Establish where the readings come from
+    p_adc = p_stream;
+    // Establish how readings become angles
+    p_cal = p_table;
+    if (p_cal != NULL && p_cal->get_source() == POTCAL_NONE)
+    {
+        p_cal->set_linear(VOLTAGE_TO_DEGREES * VOLTAGE_SOURCE / ADC_RANGE, 0);
+    }
+    counts = 0;
+    angle_offset = voltage_offset * VOLTAGE_TO_DEGREES;
+    adc_value = 0;
+    voltage = 0;
+    sample_us = 0;
 }
 
-/** @brief   Measures the voltage at the input pin
- *  @returns The voltage measured at the input pin
+/** @brief   Takes the latest reading of the pin and converts it to a voltage
+ *  @details With a running stream, the reading is copied from it; this only
+ *           waits, a tick at a time, if the stream has not finished its
+ *           first reading. The oversampled reading has a fraction of a count,
+ *           which is kept in the voltage.
  */
-float Potentiometer::get_voltage(void)
+void Potentiometer::read(void)
 {
+    AdcReading reading;
+    if (p_adc != NULL && p_adc->is_running())
+    {
+        while (!p_adc->get(ADC_PIN, reading))
+        {
+            vTaskDelay(1);
+        }
+        counts = reading.counts;
+        adc_value = (uint16_t)(reading.counts + 0.5f);
+        voltage = VOLTAGE_SOURCE * reading.counts / ADC_RANGE;
+        sample_us = reading.time_us;
+        return;
+    }
+
     // Default resolution is 12 bits. Outputs 0 - 4096
     adc_value = analogRead(ADC_PIN);
+    counts = adc_value;
+    sample_us = micros();
 
     // Convert the ADC values to a voltage
     voltage = VOLTAGE_SOURCE * adc_value / ADC_RANGE;
+}
+
+/** @brief   Measures the voltage at the input pin
+ *  @returns The voltage measured at the input pin
+ */
+float Potentiometer::get_voltage(void)
+{
+    read();
 
     return voltage;
 }
 
 /** @brief   Measures position of the potentiometer
+ *  @details The time which the measurement describes is left in
+ *           @c sample_us. With a calibration table, the angle is looked up
+ *           in it, which takes no more work than scaling the voltage.
  *  @returns The position of the potentiometer in units of degrees
  */
 float Potentiometer::get_angle(void)
 {
-    // Default resolution is 12 bits. Outputs 0 - 4096
-    adc_value = analogRead(ADC_PIN);
+    read();
 
-    // Convert the ADC values to a voltage
-    voltage = VOLTAGE_SOURCE * adc_value / ADC_RANGE;
+    if (p_cal != NULL)
+    {
+        return p_cal->degrees(counts) - angle_offset;
+    }
 
     // Offset the voltage reading and convert to degrees
     float angle = (voltage - voltage_offset) * VOLTAGE_TO_DEGREES;
@@ -63,4 +133,106 @@ void Potentiometer::zero(void)
 
     // Set the offset to the current voltage
     voltage_offset = current_voltage;
-}
\ No newline at end of file
+
+    // and to the table's angle there
+    if (p_cal != NULL)
+    {
+        angle_offset = p_cal->degrees(counts);
+    }
+}
+
+/** @brief   Loads this pin's calibration table from NVS
+ *  @returns True if a table was found and loaded, false if there is none or
+ *           it was stored in another layout, leaving the table as it was
+ */
+bool Potentiometer::load_calibration(void)
+{
+    if (p_cal == NULL)
+    {
+        return false;
+    }
+
+    char key[8];
+    snprintf(key, sizeof(key), "pin%u", ADC_PIN);
+    PotCalRecord record;
+    Preferences nvs;
+    nvs.begin(POT_NVS_NAMESPACE, true);
+    size_t length = nvs.getBytes(key, &record, sizeof(record));
+    nvs.end();
+
+    if (length != sizeof(record) || record.version != POT_NVS_VERSION
+        || record.source == POTCAL_NONE || record.source >= POTCAL_SOURCES)
+    {
+        return false;
+    }
+    p_cal->set_points(record.points, (PotCalSource)record.source);
+    return true;
+}
+
+/** @brief   Saves this pin's calibration table to NVS
+ *  @details This writes to flash, so it belongs in setup or calibration,
+ *           never in a control loop.
+ *  @returns True if the table was saved
+ */
+bool Potentiometer::save_calibration(void)
+{
+    if (p_cal == NULL)
+    {
+        return false;
+    }
+
+    char key[8];
+    snprintf(key, sizeof(key), "pin%u", ADC_PIN);
+    PotCalRecord record;
+    record.version = POT_NVS_VERSION;
+    record.source = p_cal->get_source();
+    p_cal->get_points(record.points);
+    Preferences nvs;
+    nvs.begin(POT_NVS_NAMESPACE, false);
+    size_t length = nvs.putBytes(key, &record, sizeof(record));
+    nvs.end();
+    return length == sizeof(record);
+}
+
+/** @brief   Builds the calibration table from the ADC's eFuse characterisation
+ *  @details The ESP-IDF's calibration turns each point of the table into the
+ *           voltage this chip's ADC really reads there at 11 dB, which takes
+ *           in its reference voltage, or its two point calibration if the
+ *           chip has one, and the curve of the ADC near the top of its
+ *           range. The voltage is then scaled to degrees as before. The last
+ *           point, one count past the ADC's range, is carried on from the
+ *           top segment.
+ *  @returns True if the chip had calibration in its eFuses, false if the
+ *           default reference voltage had to be used. The table is built
+ *           either way, but in the second case is marked as coming from
+ *           @c POTCAL_DEFAULT_VREF and is not worth saving.
+ */
+bool Potentiometer::calibrate_efuse(void)
+{
+    if (p_cal == NULL)
+    {
+        return false;
+    }
+
+    esp_adc_cal_characteristics_t characteristics;
+    esp_adc_cal_value_t type = esp_adc_cal_characterize(ADC_UNIT_1,
+        ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &characteristics);
+
+    float points[POTCAL_POINTS];
+    for (uint16_t point = 0; point < POTCAL_SEGMENTS; point++)
+    {
+        uint32_t millivolts = esp_adc_cal_raw_to_voltage(point << POTCAL_SHIFT,
+                                                         &characteristics);
+        points[point] = millivolts / 1000.0f * VOLTAGE_TO_DEGREES;
+    }
+    const uint32_t top = ADC_RANGE - 1;
+    const uint32_t last = (POTCAL_SEGMENTS - 1) << POTCAL_SHIFT;
+    float top_degrees = esp_adc_cal_raw_to_voltage(top, &characteristics)
+                        / 1000.0f * VOLTAGE_TO_DEGREES;
+    points[POTCAL_SEGMENTS] = points[POTCAL_SEGMENTS - 1]
+        + (top_degrees - points[POTCAL_SEGMENTS - 1]) * (ADC_RANGE - last) / (top - last);
+
+    bool from_efuse = (type != ESP_ADC_CAL_VAL_DEFAULT_VREF);
+    p_cal->set_points(points, from_efuse ? POTCAL_EFUSE : POTCAL_DEFAULT_VREF);
+    return from_efuse;
+}
@@ -4,6 +4,9 @@
  * 
  *  @author  Damond Li
  *  @date    2022-Nov-03 Original file
+ *  @date    2026-Oct-16 Readings may come from a continuously sampling
+ *           @c AdcStream rather than @c analogRead()
+ *  @date    2026-Oct-16 Angles may come from a calibration table kept in NVS
  */
 
 // Compile this header file only once
@@ -12,9 +15,20 @@
 
 // Include appropriate modules
 #include <Arduino.h>
+#include "adcstream.h"
+#include "potcal.h"
 
 /** @brief  Class for a generic potentiometer which is used to determine
  * its position.
+ * @details If the potentiometer is given an @c AdcStream which samples its
+ *          pin, each reading is the latest oversampled average from the
+ *          stream, which is taken without waiting for the ADC. Otherwise
+ *          each reading is one blocking @c analogRead().
+ *
+ *          If the potentiometer is given a @c PotCalibration, angles are
+ *          looked up in it, which corrects for the ADC's curved response,
+ *          rather than scaled from the voltage. The table is kept in NVS
+ *          under the pin's number, so it is only built once per board.
  */
 class Potentiometer
 {
@@ -32,9 +46,25 @@ protected:
     // Voltage to angle conversion
     float VOLTAGE_TO_DEGREES = 60;              ///< Conversion from voltage to degrees determined experimentally
 
+    // Stream which samples the pin, if any
+    AdcStream* p_adc;                           ///< Stream which samples the pin, or NULL to use analogRead()
+
+    // Table which converts readings to angles, if any
+    PotCalibration* p_cal;                      ///< Calibration table, or NULL to scale the voltage
+
+    // Latest reading with its fraction
+    float counts;                               ///< The latest reading, with a fraction if oversampled (counts)
+
+    // Angle to zero the potentiometer when using the table
+    float angle_offset;                         ///< The table's angle at the zero position (deg)
+
+    // Read the ADC and set the voltage
+    void read(void);                            ///< The method to take the latest reading and convert it to a voltage
+
 public:
     // Setup object
-    Potentiometer(uint8_t pin, float offset);   ///< Constructor for the potentiometer class
+    Potentiometer(uint8_t pin, float offset, AdcStream* p_stream = NULL,
+                  PotCalibration* p_table = NULL);  ///< Constructor for the potentiometer class
 
     // Value from ADC reading
     uint16_t adc_value;                         ///< ADC value from the GPIO input pin
@@ -42,6 +72,9 @@ public:
     // Voltage from ADC reading
     float voltage;                              ///< Input voltage from ADC reading
 
+    // Time of the ADC reading
+    uint32_t sample_us;                         ///< micros() time which the last reading describes
+
     // Get the position of the potentiometer
     float get_voltage(void);                    ///< The method to retrieve the voltage at the input pin
 
@@ -50,6 +83,15 @@ public:
 
     // Zero the potentiometer
     void zero(void);                            ///< The method to zero the potentiometer to its current position
+
+    // Load the calibration table from NVS
+    bool load_calibration(void);                ///< The method to load this pin's table from NVS
+
+    // Save the calibration table to NVS
+    bool save_calibration(void);                ///< The method to save this pin's table to NVS
+
+    // Build the calibration table from the ADC's eFuse characterisation
+    bool calibrate_efuse(void);                 ///< The method to build the table from the chip's eFuses
 };
 
 #endif // _POT_
\ No newline at end of file
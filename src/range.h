@@ -0,0 +1,29 @@
+/** @file range.h
+ *  @brief One reading of the height above the ground which is published by
+ *         the ultrasonic task.
+ *
+ *  @author ME 507 Airheads
+ *  @date 2026-Oct-16 Original file
+ */
+
+#ifndef _RANGE_H_
+#define _RANGE_H_
+
+#include <Arduino.h>
+
+/** @brief  One ping of the ultrasonic sensor.
+ *  @details All the fields are written together into a @c FastShare<Range>.
+ *           A ping which got no echo, or an echo from farther than the sensor
+ *           can measure, is published with @c valid false so that readers
+ *           can tell that nothing is in range rather than seeing a stale or
+ *           zero distance.
+ */
+struct Range
+{
+    float distance;         ///< Distance to the ground (cm), if valid
+    uint32_t time_us;       ///< Time at which the ping was sent, from micros() (us)
+    bool valid;             ///< True if an echo came back from within range
+    uint32_t sequence;      ///< Number of pings published, including this one
+};
+
+#endif // _RANGE_H_
@@ -0,0 +1,238 @@
+/** @file rangefilter.cpp
+ *  @brief This is the source file containing the constructor and methods for
+ *         a filter of ultrasonic pings.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include "rangefilter.h"
+#include "fastmath.h"
+
+/** @brief   Constructor which creates a filter with no height yet
+ *  @param   near_below Height below which the glider is near the ground (cm)
+ *  @param   far_above Height above which the glider is no longer near the
+ *           ground (cm), which should be above @c near_below by more than
+ *           the noise on the height
+ */
+RangeFilter::RangeFilter(float near_below, float far_above)
+{
+    near_cm = near_below;
+    far_cm = far_above;
+    near = false;
+    clear();
+}
+
+/** @brief   Forgets every distance, as when the ground goes out of range
+ */
+void RangeFilter::clear(void)
+{
+    count = 0;
+    next = 0;
+    height = 0;
+    rejects = 0;
+    misses = 0;
+    descent = 0;
+    have_descent = false;
+}
+
+/** @brief   Adds one ping and returns the near-ground decision
+ *  @details When the ground has gone out of range, the glider is taken to be
+ *           far from it.
+ *  @param   ping The ping, from @c Ultrasonic::wait_for_range()
+ *  @returns True if the glider is near the ground
+ */
+bool RangeFilter::update(const Range& ping)
+{
+    if (!ping.valid)
+    {
+        if (++misses >= RANGE_MAX_MISSES)
+        {
+            clear();
+            near = false;
+        }
+        return near;
+    }
+    misses = 0;
+
+    // Gate each ping around where the height should be by now
+    float expected = height - descent * (ping.time_us - height_us) * 1e-6f;
+    if (is_valid() && fabsf(ping.distance - expected) > RANGE_GATE_CM)
+    {
+        if (rejects < RANGE_MAX_REJECTS)
+        {
+            rejected[rejects++] = ping.distance;
+            return near;
+        }
+
+        // The height has really changed; start the window again from the
+        // pings which showed it
+        for (uint8_t index = 0; index < rejects; index++)
+        {
+            window[index] = rejected[index];
+        }
+        count = rejects;
+        next = rejects;
+    }
+    rejects = 0;
+
+    window[next] = ping.distance;
+    next = (next + 1) % RANGE_MEDIAN_SIZE;
+    if (++count < RANGE_MEDIAN_SIZE)
+    {
+        return near;
+    }
+    count = RANGE_MEDIAN_SIZE;
+
+    // Sort a copy of the window to find its median
+    float sorted[RANGE_MEDIAN_SIZE];
+    for (uint8_t index = 0; index < count; index++)
+    {
+        float value = window[index];
+        uint8_t place = index;
+        for (; place > 0 && sorted[place - 1] > value; place--)
+        {
+            sorted[place] = sorted[place - 1];
+        }
+        sorted[place] = value;
+    }
+    float previous = height;
+    height = (RANGE_MEDIAN_SIZE % 2) ? sorted[RANGE_MEDIAN_SIZE / 2]
+             : 0.5f * (sorted[RANGE_MEDIAN_SIZE / 2 - 1] + sorted[RANGE_MEDIAN_SIZE / 2]);
+
+    // Smooth the rate of descent from one height to the next
+    uint32_t elapsed_us = ping.time_us - height_us;
+    if (have_descent && elapsed_us > 0)
+    {
+        float rate = (previous - height) * 1e6f / elapsed_us;
+        descent += RANGE_RATE_GAIN * (rate - descent);
+    }
+    have_descent = true;
+    height_us = ping.time_us;
+
+    if (height < near_cm)
+    {
+        near = true;
+    }
+    else if (height > far_cm)
+    {
+        near = false;
+    }
+    return near;
+}
+
+/** @brief   Constructor which creates a scheduler with no pings counted
+ */
+RangeScheduler::RangeScheduler(void)
+{
+    reset();
+}
+
+/** @brief   Forgets the pings counted so far, as at the start of a flight
+ */
+void RangeScheduler::reset(void)
+{
+    for (uint8_t phase = 0; phase < RANGE_PHASES; phase++)
+    {
+        pings[phase] = 0;
+        phase_us[phase] = 0;
+    }
+    started = false;
+}
+
+/** @brief   Counts a ping and chooses the time until the next one
+ *  @details The time since the previous ping is counted in the phase the
+ *           glider was in after this one, which is the phase whose period
+ *           was chosen for it to within a ping. Above the final approach,
+ *           the time left before reaching the near-ground height is split
+ *           into @c RANGE_PINGS_TO_GO pings, rounded down to a whole number
+ *           of @c RANGE_PERIOD_STEP_MS so that small changes in the descent
+ *           rate leave the period alone; if the height is not falling, the
+ *           cruise period is used.
+ *  @param   filter The filter which has just been given the ping
+ *  @param   ping The ping, from @c Ultrasonic::wait_for_range()
+ *  @returns The time from now until the next ping (ms)
+ */
+uint32_t RangeScheduler::update(RangeFilter& filter, const Range& ping)
+{
+    RangePhase phase;
+    uint32_t period_ms;
+    if (!filter.is_valid())
+    {
+        phase = RANGE_OUT;
+        period_ms = RANGE_MAX_PERIOD_MS;
+    }
+    else if (filter.get_height() < RANGE_FINAL_CM)
+    {
+        phase = RANGE_FINAL;
+        period_ms = RANGE_MIN_PERIOD_MS;
+    }
+    else
+    {
+        phase = RANGE_CRUISE;
+        period_ms = RANGE_CRUISE_PERIOD_MS;
+        float descent = filter.get_descent_rate();
+        if (descent > 0.0f)
+        {
+            float to_go_ms = 1000.0f * (filter.get_height() - filter.get_near_height())
+                             / descent;
+            float wanted_ms = to_go_ms / RANGE_PINGS_TO_GO;
+            if (wanted_ms < RANGE_CRUISE_PERIOD_MS)
+            {
+                period_ms = (uint32_t)wanted_ms / RANGE_PERIOD_STEP_MS * RANGE_PERIOD_STEP_MS;
+                period_ms = (period_ms > RANGE_MIN_PERIOD_MS) ? period_ms
+                            : RANGE_MIN_PERIOD_MS;
+            }
+        }
+    }
+
+    if (started)
+    {
+        phase_us[phase] += ping.time_us - last_us;
+    }
+    pings[phase]++;
+    last_us = ping.time_us;
+    started = true;
+    return period_ms;
+}
+
+/** @brief   Finds the ping rate achieved in one phase
+ *  @param   phase The phase of flight
+ *  @returns The pings per second spent in the phase, or zero if no time was
+ *           spent in it
+ */
+float RangeScheduler::get_rate(RangePhase phase)
+{
+    return phase_us[phase] ? pings[phase] * 1e6f / phase_us[phase] : 0.0f;
+}
+
+/** @brief   Prints the pings, time and rate achieved in each phase
+ *  @param   printer The serial port or other device to which to print
+ *  @param   label A name printed at the start of the line
+ */
+void RangeScheduler::print(Print& printer, const char* label)
+{
+    static const char* const names[RANGE_PHASES] = { "out", "cruise", "final" };
+
+    printer.printf("%s pings", label);
+    for (uint8_t phase = 0; phase < RANGE_PHASES; phase++)
+    {
+        printer.printf("  %s %u in %.1f s, %.1f Hz", names[phase],
+                       (unsigned)pings[phase], phase_us[phase] * 1e-6f,
+                       get_rate((RangePhase)phase));
+    }
+    printer.println();
+}
+
+/** @brief   Finds the speed of sound in air at a temperature, halved because
+ *           an echo goes out and back
+ *  @details The speed is 331.3 m/s at 0 C and grows as the square root of
+ *           the absolute temperature, which is about 0.17% per degree.
+ *  @param   temperature The temperature of the air (C)
+ *  @returns Centimeters of distance per microsecond of echo
+ */
+float range_cm_per_us(float temperature)
+{
+    return 331.3f * 0.5e-4f * fast_sqrt(1.0f + temperature * (1.0f / 273.15f));
+}
@@ -0,0 +1,166 @@
+/** @file rangefilter.h
+ *  @brief The header file for a filter which turns ultrasonic pings into a
+ *         height above the ground and a near-ground decision.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// Compile this header file only once
+#ifndef _RANGEFILTER_H_
+#define _RANGEFILTER_H_
+
+#include <Arduino.h>
+#include "range.h"
+
+/// Number of accepted pings whose median is the height
+#define RANGE_MEDIAN_SIZE 3
+
+/// Farthest a ping may be from the height and still be accepted (cm)
+#define RANGE_GATE_CM 25.0f
+
+/// Pings in a row outside the gate after which they are believed instead
+#define RANGE_MAX_REJECTS 2
+
+/// Pings in a row with no echo after which nothing is taken to be in range
+#define RANGE_MAX_MISSES 3
+
+/// Weight of each new measurement in the smoothed descent rate
+#define RANGE_RATE_GAIN 0.3f
+
+/// Shortest time between pings, longer than the sensor's longest echo of
+/// about 38 ms, so that a missed echo has ended before the next trigger (ms)
+#define RANGE_MIN_PERIOD_MS 40
+
+/// Steps in which the time between pings is chosen, so that the ping timer
+/// is only restarted when the period really changes (ms)
+#define RANGE_PERIOD_STEP_MS 10
+
+/// Time between pings while the ground is in range but not coming closer (ms)
+#define RANGE_CRUISE_PERIOD_MS 100
+
+/// Time between pings while nothing is in range (ms)
+#define RANGE_MAX_PERIOD_MS 250
+
+/// Height below which pings are sent as often as the sensor allows (cm)
+#define RANGE_FINAL_CM 50.0f
+
+/// Pings wanted between now and reaching the near-ground height
+#define RANGE_PINGS_TO_GO 10
+
+/// Phases of flight for which the ping rate is counted
+enum RangePhase : uint8_t
+{
+    RANGE_OUT,              ///< Nothing in range
+    RANGE_CRUISE,           ///< Ground in range, above the final approach
+    RANGE_FINAL,            ///< Final approach, below RANGE_FINAL_CM
+    RANGE_PHASES            ///< Number of phases
+};
+
+/** @brief  Class which filters ultrasonic pings and decides whether the
+ *          glider is near the ground.
+ *  @details Each ping with an echo is compared with the current height; one
+ *           which is farther from it than a gate, such as an echo from a
+ *           blade of grass or another sensor's ping, is dropped. If several
+ *           pings in a row fall outside the gate, the height really has
+ *           changed and the window starts again from them. Accepted pings go
+ *           into a short sliding window whose median is the height; there is
+ *           no height, and the decision is left alone, until the window is
+ *           full, so the first ping can't decide it on its own. A ping with
+ *           no echo is ignored unless several come in a row, which means that
+ *           the ground is out of range.
+ *
+ *           The near-ground decision has hysteresis: it becomes true below
+ *           one height and false only above a higher one, so noise on a
+ *           height near the threshold cannot flip it back and forth.
+ */
+class RangeFilter
+{
+protected:
+    float window[RANGE_MEDIAN_SIZE];    ///< Latest accepted distances (cm)
+    float rejected[RANGE_MAX_REJECTS];  ///< Distances outside the gate since the last accepted one (cm)
+    uint8_t count;                      ///< Number of distances in the window
+    uint8_t next;                       ///< Index in the window for the next distance
+    float height;                       ///< Median of the window (cm)
+    uint8_t rejects;                    ///< Pings in a row outside the gate
+    uint8_t misses;                     ///< Pings in a row with no echo
+    bool near;                          ///< Latest near-ground decision
+    float descent;                      ///< Smoothed rate at which the height falls (cm/s)
+    uint32_t height_us;                 ///< Time of the ping which gave the height (us)
+    bool have_descent;                  ///< True once two heights in a row have been found
+    float near_cm;                      ///< Height below which the glider is near the ground (cm)
+    float far_cm;                       ///< Height above which it is no longer near (cm)
+
+    // Forget every distance, as when the ground goes out of range
+    void clear(void);
+
+public:
+    // Create a filter with the heights of its near-ground decision
+    RangeFilter(float near_below = 20.0f, float far_above = 30.0f);
+
+    // Add one ping and return the near-ground decision
+    bool update(const Range& ping);
+
+    // Return true if the filter has a height
+    bool is_valid(void) { return count == RANGE_MEDIAN_SIZE; }
+
+    // Return the filtered height (cm), meaningful if is_valid()
+    float get_height(void) { return height; }
+
+    // Return the near-ground decision
+    bool is_near(void) { return near; }
+
+    // Return the rate at which the height is falling (cm/s), zero if unknown
+    float get_descent_rate(void) { return descent; }
+
+    // Return the height below which the glider is near the ground (cm)
+    float get_near_height(void) { return near_cm; }
+};
+
+
+/** @brief  Class which chooses the time between ultrasonic pings from the
+ *          height and the rate of descent, and counts the rate achieved.
+ *  @details While nothing is in range, pings are sent slowly, just often
+ *           enough to notice the ground coming into range. In range, they
+ *           are sent so that about @c RANGE_PINGS_TO_GO of them come between
+ *           now and reaching the near-ground height at the present rate of
+ *           descent, and as often as the sensor allows on final approach,
+ *           where the flare is decided. The pings and time spent in each
+ *           phase are counted, so the rate actually achieved in each can be
+ *           printed after a flight.
+ */
+class RangeScheduler
+{
+protected:
+    uint32_t pings[RANGE_PHASES];       ///< Pings counted in each phase
+    uint32_t phase_us[RANGE_PHASES];    ///< Time spent in each phase (us)
+    uint32_t last_us;                   ///< Time of the previous ping (us)
+    bool started;                       ///< True once a ping has been counted
+
+public:
+    // Create a scheduler with no pings counted
+    RangeScheduler(void);
+
+    // Count a ping and return the time until the next one (ms)
+    uint32_t update(RangeFilter& filter, const Range& ping);
+
+    // Forget the pings counted so far
+    void reset(void);
+
+    // Return the pings counted in one phase
+    uint32_t get_pings(RangePhase phase) { return pings[phase]; }
+
+    // Return the time spent in one phase (us)
+    uint32_t get_time_us(RangePhase phase) { return phase_us[phase]; }
+
+    // Return the rate achieved in one phase (Hz), zero if no time was spent in it
+    float get_rate(RangePhase phase);
+
+    // Print the pings and rate achieved in each phase
+    void print(Print& printer, const char* label);
+};
+
+// Speed of sound in air at a temperature, halved for the trip out and back (cm/us)
+float range_cm_per_us(float temperature);
+
+#endif // _RANGEFILTER_H_
@@ -14,13 +14,15 @@
 
 #include "taskqueue.h"
 #include "taskshare.h"
+#include "fastshare.h"
+#include "notifyshare.h"
+#include "attitude.h"
 
-extern Share<bool> near_ground;         ///< A share describing whether the glider is near the ground
-extern Share<uint8_t> tc_state;         ///< A share describing the state of the controller FSM
-extern Share<int16_t> rudder_duty;      ///< A share for the duty cycle for the rudder motor
-extern Share<int16_t> elev_duty;        ///< A share for the duty cycle for the elevator motor
-extern Share<float> yawC;               ///< A share for the current yaw
-extern Share<float> pitchC;             ///< A share for the current pitch
+extern FastShare<bool> near_ground;       ///< A share describing whether the glider is near the ground
+extern FastShare<uint8_t> tc_state;       ///< A share describing the state of the controller FSM
+extern NotifyShare<int16_t> rudder_duty;  ///< A share for the duty cycle for the rudder motor
+extern NotifyShare<int16_t> elev_duty;    ///< A share for the duty cycle for the elevator motor
+extern FastShare<Attitude> attitude;      ///< A share for the current attitude snapshot from the IMU
 extern Share<bool> web_calibrate;       ///< A share for a calibration variable
 
 #endif // _SHARES_H_
\ No newline at end of file
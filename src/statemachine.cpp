@@ -0,0 +1,208 @@
+/** @file    statemachine.cpp
+ *  @brief   Source file for a table-driven state machine which runs on events.
+ *  @details This file contains the methods of class @c StateMachine, which
+ *           queue events, look them up in the transition table, run the
+ *           exit, transition and entry actions and keep the machine's timer.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "statemachine.h"
+
+
+/** @brief   Create a state machine from its tables.
+ *  @details The tables are not copied, so they should be constant globals.
+ *           The machine is in no state until @c begin() is called, but events
+ *           may be posted before then; they wait in the queue.
+ *  @param   p_name A name for the machine, printed in the transition log
+ *  @param   p_states The table of states, indexed by state number
+ *  @param   state_count The number of states in the table
+ *  @param   p_transitions The table of transitions, searched in order
+ *  @param   transition_count The number of transitions in the table
+ *  @param   p_event_names The names of the events, indexed by event number
+ *  @param   timeout The event which is handled when the timer runs out
+ *  @param   queue_length How many events may wait to be handled (default 8)
+ */
+StateMachine::StateMachine (const char* p_name, const FsmState* p_states,
+                            uint8_t state_count,
+                            const FsmTransition* p_transitions,
+                            uint8_t transition_count,
+                            const char* const* p_event_names, uint8_t timeout,
+                            uint8_t queue_length)
+    : name (p_name), states (p_states), num_states (state_count),
+      transitions (p_transitions), num_transitions (transition_count),
+      event_names (p_event_names), timeout_event (timeout)
+{
+    queue = xQueueCreate (queue_length, sizeof (FsmEvent));
+    state = FSM_ANY_STATE;
+    overflows = 0;
+    timer_running = false;
+    timer_start = 0;
+    timer_length = 0;
+}
+
+
+/** @brief   Post an event from a task.
+ *  @details The event is stamped with the current time and put at the back
+ *           of the queue. This never blocks; if the queue is full the event
+ *           is dropped and counted.
+ *  @param   event The event to post
+ *  @returns @c true if the event was queued, @c false if the queue was full
+ */
+bool StateMachine::post (uint8_t event)
+{
+    FsmEvent item = { event, esp_timer_get_time () };
+
+    if (xQueueSendToBack (queue, &item, 0) != pdTRUE)
+    {
+        overflows++;
+        return false;
+    }
+    return true;
+}
+
+
+/** @brief   Post an event from an interrupt service routine.
+ *  @details If the machine's task was waiting and has a higher priority than
+ *           the interrupted task, it runs as soon as the ISR returns.
+ *  @param   event The event to post
+ *  @returns @c true if the event was queued, @c false if the queue was full
+ */
+bool StateMachine::ISR_post (uint8_t event)
+{
+    FsmEvent item = { event, esp_timer_get_time () };
+    BaseType_t woken = pdFALSE;
+
+    if (xQueueSendToBackFromISR (queue, &item, &woken) != pdTRUE)
+    {
+        overflows++;
+        return false;
+    }
+    portYIELD_FROM_ISR (woken);
+    return true;
+}
+
+
+/** @brief   Enter the first state, running its entry action.
+ *  @param   initial_state The state in which the machine starts
+ */
+void StateMachine::begin (uint8_t initial_state)
+{
+    state = initial_state;
+    Serial.printf ("%lu ms: %s starts in %s\r\n", (unsigned long)millis (),
+                   name, states[state].name);
+    if (states[state].on_entry != NULL)
+    {
+        states[state].on_entry ();
+    }
+}
+
+
+/** @brief   Wait for one event, or for the timer to run out, and handle it.
+ *  @details The calling task sleeps on the queue until an event arrives or
+ *           the timer runs out, whichever comes first, so it uses no time
+ *           while nothing happens. This is meant to be called in the task's
+ *           endless loop.
+ */
+void StateMachine::run (void)
+{
+    FsmEvent event;
+    TickType_t wait = portMAX_DELAY;
+
+    if (timer_running)
+    {
+        TickType_t elapsed = xTaskGetTickCount () - timer_start;
+        if (elapsed >= timer_length)
+        {
+            timer_running = false;
+            event.type = timeout_event;
+            event.time_us = esp_timer_get_time ();
+            dispatch (event);
+            return;
+        }
+        wait = timer_length - elapsed;
+    }
+
+    if (xQueueReceive (queue, &event, wait) == pdTRUE)
+    {
+        dispatch (event);
+    }
+}
+
+
+/** @brief   Handle one event.
+ *  @details The first matching row of the transition table is taken. For a
+ *           change of state, the old state's exit action runs and the timer
+ *           is stopped, then the row's action, then the new state's entry
+ *           action. The transition is printed with the time the event was
+ *           posted and the time from then until the new state was entered.
+ *  @param   event The event to handle
+ */
+void StateMachine::dispatch (const FsmEvent& event)
+{
+    for (uint8_t row = 0; row < num_transitions; row++)
+    {
+        const FsmTransition& transition = transitions[row];
+        if ((transition.from != state && transition.from != FSM_ANY_STATE)
+            || transition.event != event.type)
+        {
+            continue;
+        }
+
+        // An internal transition only runs its action
+        if (transition.to == state)
+        {
+            if (transition.action != NULL)
+            {
+                transition.action ();
+            }
+            return;
+        }
+
+        uint8_t from = state;
+        if (states[from].on_exit != NULL)
+        {
+            states[from].on_exit ();
+        }
+        stop_timer ();
+        if (transition.action != NULL)
+        {
+            transition.action ();
+        }
+        state = transition.to;
+        if (states[state].on_entry != NULL)
+        {
+            states[state].on_entry ();
+        }
+
+        Serial.printf ("%lu ms: %s %s -> %s on %s (%lu us)\r\n",
+                       (unsigned long)(event.time_us / 1000), name,
+                       states[from].name, states[state].name,
+                       event_names[event.type],
+                       (unsigned long)(esp_timer_get_time () - event.time_us));
+        return;
+    }
+}
+
+
+/** @brief   Start the timer, or restart it if it is already running.
+ *  @details When the timer runs out, the machine handles its timeout event.
+ *  @param   ms The time until the timer runs out (ms)
+ */
+void StateMachine::start_timer (uint32_t ms)
+{
+    timer_start = xTaskGetTickCount ();
+    timer_length = ms / portTICK_PERIOD_MS;
+    timer_running = true;
+}
+
+
+/** @brief   Stop the timer so that it posts no timeout event.
+ */
+void StateMachine::stop_timer (void)
+{
+    timer_running = false;
+}
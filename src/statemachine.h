@@ -0,0 +1,152 @@
+/** @file    statemachine.h
+ *  @brief   A table-driven finite state machine which runs on events.
+ *  @details This file contains a class which runs a state machine described
+ *           by two constant tables: one of states, each with optional entry
+ *           and exit actions, and one of transitions, each taking the machine
+ *           from one state to another when a given event arrives. Events are
+ *           posted into a FreeRTOS queue by any task or ISR, so a transition
+ *           takes effect as soon as the machine's task wakes up for the
+ *           event rather than at the next poll of a state variable. The
+ *           machine also has one timer, which actions start and stop and
+ *           which posts a timeout event when it runs out; it is stopped
+ *           whenever the machine leaves a state. Each transition is printed
+ *           with the time of the event and how long the machine took to
+ *           handle it.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// This define prevents this .h file from being included more than once
+#ifndef _STATEMACHINE_H_
+#define _STATEMACHINE_H_
+
+#include <Arduino.h>
+#include <atomic>
+
+/// A transition's source state which matches every state
+#define FSM_ANY_STATE 0xFF
+
+/// An entry, exit or transition action; it may start or stop the timer
+typedef void (*FsmAction) (void);
+
+/// One state of a machine
+struct FsmState
+{
+    const char* name;               ///< Name printed in the transition log
+    FsmAction on_entry;             ///< Run on entering the state, or @c NULL
+    FsmAction on_exit;              ///< Run on leaving the state, or @c NULL
+};
+
+/// One row of a machine's transition table
+struct FsmTransition
+{
+    uint8_t from;                   ///< Source state, or @c FSM_ANY_STATE
+    uint8_t event;                  ///< Event which fires the transition
+    uint8_t to;                     ///< Destination state
+    FsmAction action;               ///< Run between exit and entry, or @c NULL
+};
+
+/// An event as it travels through the queue
+struct FsmEvent
+{
+    uint8_t type;                   ///< Which event it is
+    int64_t time_us;                ///< When it was posted, from @c esp_timer_get_time()
+};
+
+
+/** @brief   Class which runs a table-driven state machine on queued events.
+ *  @details States and events are small integers, normally from @c enum's,
+ *           which index the state table and the table of event names. For
+ *           each event the transition table is searched in order and the
+ *           first row whose source state (or @c FSM_ANY_STATE) and event
+ *           match is taken; an event with no matching row is ignored. A row
+ *           whose destination is the current state is an internal
+ *           transition: its action runs, but the state is not exited or
+ *           re-entered and the timer keeps running.
+ *
+ *           Any number of tasks may post events. Exactly one task should
+ *           call @c run() in its loop; the actions run in that task.
+ *
+ *           @section usage_statemachine Usage
+ *           @code
+ *           enum { OFF, ON };                            // States
+ *           enum { EV_PRESS, EV_TIMEOUT };               // Events
+ *           const FsmState lamp_states[] =
+ *               { { "OFF", NULL, NULL }, { "ON", lamp_on, lamp_off } };
+ *           const FsmTransition lamp_table[] =
+ *               { { OFF, EV_PRESS, ON, NULL },
+ *                 { ON, EV_PRESS, OFF, NULL },
+ *                 { ON, EV_TIMEOUT, OFF, NULL } };
+ *           const char* lamp_events[] = { "PRESS", "TIMEOUT" };
+ *           StateMachine lamp ("Lamp", lamp_states, 2, lamp_table, 3,
+ *                              lamp_events, EV_TIMEOUT);
+ *           ...
+ *           lamp.post (EV_PRESS);                        // In any task
+ *           ...
+ *           lamp.begin (OFF);                            // In the FSM task
+ *           while (true)
+ *           {
+ *               lamp.run ();
+ *           }
+ *           @endcode
+ */
+class StateMachine
+{
+protected:
+    const char* name;                       ///< Name printed in the log
+    const FsmState* states;                 ///< Table of states
+    uint8_t num_states;                     ///< Number of rows in @c states
+    const FsmTransition* transitions;       ///< Table of transitions
+    uint8_t num_transitions;                ///< Number of rows in @c transitions
+    const char* const* event_names;         ///< Names of the events, by number
+    uint8_t timeout_event;                  ///< Event posted when the timer runs out
+
+    QueueHandle_t queue;                    ///< Events waiting to be handled
+    std::atomic<uint8_t> state;             ///< The current state, which other tasks may read
+    uint32_t overflows;                     ///< Events lost because the queue was full
+
+    bool timer_running;                     ///< @c true while the timer is running
+    TickType_t timer_start;                 ///< Tick count when the timer started
+    TickType_t timer_length;                ///< Ticks until the timer runs out
+
+    // Handle one event
+    void dispatch (const FsmEvent& event);
+
+public:
+    // Create a state machine from its tables
+    StateMachine (const char* p_name, const FsmState* p_states,
+                  uint8_t state_count, const FsmTransition* p_transitions,
+                  uint8_t transition_count, const char* const* p_event_names,
+                  uint8_t timeout, uint8_t queue_length = 8);
+
+    // Post an event from a task
+    bool post (uint8_t event);
+
+    // Post an event from an interrupt service routine
+    bool ISR_post (uint8_t event);
+
+    // Enter the first state, running its entry action
+    void begin (uint8_t initial_state);
+
+    // Wait for one event or timeout and handle it
+    void run (void);
+
+    // Start (or restart) the timer
+    void start_timer (uint32_t ms);
+
+    // Stop the timer
+    void stop_timer (void);
+
+    /** @brief   Return the current state.
+     *  @returns The number of the state the machine is in
+     */
+    uint8_t get_state (void) { return state.load (std::memory_order_relaxed); }
+
+    /** @brief   Return the number of events lost because the queue was full.
+     *  @returns How many posts have failed
+     */
+    uint32_t get_overflows (void) { return overflows; }
+}; // class StateMachine
+
+#endif // _STATEMACHINE_H_
@@ -0,0 +1,116 @@
+/** @file    subscription.h
+ *  @brief   Typed subscriptions to lock-free shares.
+ *  @details This file contains a small template class through which a task
+ *           follows one @c FastShare (or @c NotifyShare). Together with
+ *           @c wait_for_topics(), it lets a logger or estimator sleep until
+ *           any of several shares is written, then read only the ones which
+ *           have new data. Publishing costs the writer one task notification
+ *           per subscriber; the data itself stays in the share and each
+ *           subscriber copies it out only when it wants it.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// This define prevents this .h file from being included more than once
+#ifndef _SUBSCRIPTION_H_
+#define _SUBSCRIPTION_H_
+
+#include "fastshare.h"
+
+
+/** @brief   Class through which a task follows one lock-free share.
+ *  @details A subscription must be constructed by the task which is to be
+ *           woken, since it subscribes the calling task. Each subscription
+ *           held by a task should use a different notification bit.
+ *
+ *           @section usage_subscription Usage
+ *           @code
+ *           void task_logger (void* p_params)
+ *           {
+ *               Subscription<uint8_t> state_topic (tc_state, 1 << 0);
+ *               Subscription<Attitude> attitude_topic (attitude, 1 << 1);
+ *               uint8_t state;
+ *               while (true)
+ *               {
+ *                   uint32_t bits = wait_for_topics ();
+ *                   if ((bits & state_topic.bit ()) && state_topic.get (state))
+ *                   {
+ *                       Serial << "State " << state << endl;
+ *                   }
+ *                   ...
+ *               }
+ *           }
+ *           @endcode
+ */
+template <class DataType> class Subscription
+{
+protected:
+    /// The share which is being followed
+    FastShare<DataType>& topic;
+
+    /// The notification bit which the share sets when it is written
+    uint32_t notify_bit;
+
+    /// Sequence number of the data which was read most recently
+    uint32_t seen_sequence;
+
+public:
+    /** @brief   Subscribe the calling task to a share.
+     *  @param   share The share which is to be followed
+     *  @param   bit The notification bit which is set when the share is
+     *           written
+     */
+    Subscription (FastShare<DataType>& share, uint32_t bit)
+        : topic (share), notify_bit (bit), seen_sequence (0)
+    {
+        topic.subscribe (notify_bit);
+    }
+
+    /** @brief   Check whether the share was written since it was last read.
+     *  @returns @c true if there is data which this subscriber hasn't read
+     */
+    bool is_new (void)
+    {
+        return topic.sequence.load (std::memory_order_acquire) != seen_sequence;
+    }
+
+    /** @brief   Read the share's data.
+     *  @param   recv_data A reference to the variable in which to put the data
+     *  @returns @c true if the data is new since this subscriber last read it
+     */
+    bool get (DataType& recv_data)
+    {
+        uint32_t sequence = topic.read (recv_data);
+        bool fresh = (sequence != seen_sequence);
+        seen_sequence = sequence;
+        return fresh;
+    }
+
+    /** @brief   Return the notification bit used by this subscription.
+     *  @returns The bit which the share sets when it is written
+     */
+    uint32_t bit (void)
+    {
+        return notify_bit;
+    }
+}; // class Subscription<DataType>
+
+
+/** @brief   Sleep until a share to which the calling task subscribes is
+ *           written.
+ *  @param   ticks_to_wait How many RTOS ticks to wait (default: forever)
+ *  @returns The notification bits of the shares which were written, or zero
+ *           if the wait timed out
+ */
+inline uint32_t wait_for_topics (TickType_t ticks_to_wait = portMAX_DELAY)
+{
+    uint32_t bits = 0;
+    if (xTaskNotifyWait (0, 0xFFFFFFFF, &bits, ticks_to_wait) != pdTRUE)
+    {
+        return 0;
+    }
+    return bits;
+}
+
+#endif // _SUBSCRIPTION_H_
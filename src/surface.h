@@ -0,0 +1,26 @@
+/** @file surface.h
+ *  @brief Angles of the glider's control surfaces, which are passed as one
+ *         item between the attitude controller and the servo task.
+ *
+ *  @author ME 507 Airheads
+ *  @date 2026-Oct-16 Original file
+ */
+
+#ifndef _SURFACE_H_
+#define _SURFACE_H_
+
+#include <Arduino.h>
+
+/** @brief  Rudder and elevator angles.
+ *  @details The attitude controller puts the angles it wants into one
+ *           @c FastShare<SurfaceAngles>, and the servo task puts the angles
+ *           it measures into another, so that the two surfaces are always
+ *           read as a pair from the same update.
+ */
+struct SurfaceAngles
+{
+    float rudder;           ///< Rudder angle (deg)
+    float elevator;         ///< Elevator angle (deg)
+};
+
+#endif // _SURFACE_H_
@@ -0,0 +1,138 @@
+/** @file    taskmemory.h
+ *  @brief   Memory for a task which can be reserved at compile time.
+ *  @details This file contains a small template class which holds the stack
+ *           and control block of one task. When the program is built with
+ *           @c STATIC_ALLOC defined, the memory is part of the object, which
+ *           is meant to be a global variable, and the task is started with
+ *           @c xTaskCreateStatic(); no heap is used, and the linker's RAM
+ *           report includes every task's stack. Without @c STATIC_ALLOC the
+ *           object is empty and the task is started with @c xTaskCreate() as
+ *           usual, so the two ways of starting tasks can be compared by
+ *           changing one build flag.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ *  @date    2026-Oct-16 Added a base class so tasks can be started from a table
+ */
+
+// This define prevents this .h file from being included more than once
+#ifndef _TASKMEMORY_H_
+#define _TASKMEMORY_H_
+
+#include <Arduino.h>
+
+
+/** @brief   Memory for one task, whatever the size of its stack.
+ *  @details This base class lets tasks with different stack sizes be started
+ *           from one table; the memory itself is in the descendent class
+ *           @c TaskMemory<STACK_SIZE>, which fills in the pointers.
+ */
+class TaskMemoryBase
+{
+protected:
+    uint32_t stack_depth;                   ///< Stack size, as given to @c xTaskCreate()
+#ifdef STATIC_ALLOC
+    StackType_t* p_stack;                   ///< The task's stack
+    StaticTask_t* p_control_block;          ///< The task's control block
+#endif
+
+    /** @brief   Save the size and location of the memory.
+     *  @param   depth The size of the stack
+     *  @param   p_stack_memory The stack, or @c NULL without @c STATIC_ALLOC
+     *  @param   p_block_memory The control block, or @c NULL without
+     *           @c STATIC_ALLOC
+     */
+    TaskMemoryBase (uint32_t depth, StackType_t* p_stack_memory,
+                    StaticTask_t* p_block_memory)
+    {
+        stack_depth = depth;
+#ifdef STATIC_ALLOC
+        p_stack = p_stack_memory;
+        p_control_block = p_block_memory;
+#else
+        (void)p_stack_memory;
+        (void)p_block_memory;
+#endif
+    }
+
+public:
+    /** @brief   Start a task which uses this memory.
+     *  @param   function The function which runs as the task
+     *  @param   p_name A name for the task
+     *  @param   priority The task's priority
+     *  @param   p_params A pointer to parameters for the task (default @c NULL)
+     *  @param   core The core on which the task runs (default either one)
+     *  @returns A handle to the new task, or @c NULL if it couldn't be created
+     */
+    TaskHandle_t start (TaskFunction_t function, const char* p_name,
+                        UBaseType_t priority, void* p_params = NULL,
+                        BaseType_t core = tskNO_AFFINITY)
+    {
+#ifdef STATIC_ALLOC
+        return xTaskCreateStaticPinnedToCore (function, p_name, stack_depth,
+                                              p_params, priority, p_stack,
+                                              p_control_block, core);
+#else
+        TaskHandle_t handle = NULL;
+        xTaskCreatePinnedToCore (function, p_name, stack_depth, p_params,
+                                 priority, &handle, core);
+        return handle;
+#endif
+    }
+
+    /** @brief   Return the size of the task's stack.
+     *  @returns The stack size, in the units of @c xTaskCreate()
+     */
+    uint32_t stack_size (void)
+    {
+        return stack_depth;
+    }
+
+    /** @brief   Return how much memory this object reserves at compile time.
+     *  @returns The size of the stack and control block in bytes, or zero
+     *           if the task's memory comes from the heap
+     */
+    uint32_t static_bytes (void)
+    {
+#ifdef STATIC_ALLOC
+        return sizeof (StackType_t) * stack_depth + sizeof (StaticTask_t);
+#else
+        return 0;
+#endif
+    }
+}; // class TaskMemoryBase
+
+
+/** @brief   Class which holds (or sizes) the memory for one task.
+ *  @details The stack size is given in the same units as the stack depth
+ *           parameter of @c xTaskCreate(), which on the ESP32 is bytes.
+ *
+ *           @section usage_taskmemory Usage
+ *           @code
+ *           TaskMemory<2048> motor_task_memory;      // Global variable
+ *           ...
+ *           motor_task_memory.start (task_motor, "Motor", 20);  // In setup()
+ *           @endcode
+ */
+template <uint32_t STACK_SIZE> class TaskMemory : public TaskMemoryBase
+{
+protected:
+#ifdef STATIC_ALLOC
+    StackType_t stack[STACK_SIZE];          ///< The task's stack
+    StaticTask_t control_block;             ///< The task's control block
+#endif
+
+public:
+    /** @brief   Create the memory for one task.
+     */
+    TaskMemory (void)
+#ifdef STATIC_ALLOC
+        : TaskMemoryBase (STACK_SIZE, stack, &control_block)
+#else
+        : TaskMemoryBase (STACK_SIZE, NULL, NULL)
+#endif
+    {
+    }
+}; // class TaskMemory
+
+#endif // _TASKMEMORY_H_
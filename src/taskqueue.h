@@ -1,608 +1,740 @@
-// /** @file taskqueue.h
-//  *    This file contains a very simple wrapper class for the FreeRTOS queue. 
-//  *    It makes using the queue just a little bit easier in C++ than it is in C.
-//  *    This version has been tested on STM32's and ESP32's only because the 
-//  *    insertion and extraction operators @c << and @c >> need specific 
-//  *    functions to determine if they're running in ISR's or not. 
-//  *
-//  *  @date 2012-Oct-21 JRR Original file
-//  *  @date 2014-Aug-26 JRR Changed file names and queue class name to Queue
-//  *  @date 2020-Oct-10 JRR Made compatible with Arduino/FreeRTOS environment
-//  *  @date 2020-Nov-18 JRR Added @c << and @c >> operators for ESP32 and STM32
-//  *  @date 2021-Sep-19 JRR Added overloads of @c get(), @c ISR_get(), @c peek(), 
-//  *                        and @c ISR_peek() which return copies
-//  *
-//  *  License:
-//  *    This file is copyright 2012-2020 by JR Ridgely and released under the 
-//  *    Lesser GNU Public License, version 2. It intended for educational use 
-//  *    only, but its use is not limited thereto. */
-// /*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
-//  *    IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
-//  *    THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR 
-//  *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIB-
-//  *    UTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
-//  *    OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
-//  *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-//  *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
-//  *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
-//  *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
-//  *    THE POSSIBILITY OF SUCH DAMAGE. */
-
-// // This define prevents this .h file from being included more than once
-// #ifndef _TASKQUEUE_H_
-// #define _TASKQUEUE_H_
-
-// #include <Arduino.h>
-// #if (defined STM32F4xx || defined STM32L4xx)
-//     #include "FreeRTOS.h"                       // Main header for FreeRTOS
-// #endif
-// #include "baseshare.h"
-
-
-// /** @brief   Implements a queue to transmit data from one RTOS task to another. 
-//  *  @details Since multithreaded tasks must not use unprotected shared data 
-//  *           items for communication, queues are a primary means of intertask 
-//  *           communication. Other means include shared data items (see 
-//  *           @c taskshare.h) and carrier pigeons. The use of a C++ class
-//  *           template allows the compiler to check that you're putting the 
-//  *           correct type of data into each queue and getting the correct type
-//  *           of data out, thus helping to prevent programming mistakes that can
-//  *           corrupt your data. 
-//  * 
-//  *           As a template class, @c Queue<dataType> can be used to make 
-//  *           queues which hold data of many types. "Plain Old Data" types such
-//  *           as @c bool or @c uint16_t are supported, of course. But you can 
-//  *           also use queues which hold compound data types. For example, if
-//  *           you have @c class @c my_data which holds several measurements 
-//  *           together in an object, you can make a queue for @c my_data objects
-//  *           with @c Queue<my_data>.  Each item in the queue will then hold
-//  *           several measurements. 
-//  * 
-//  *           The size of FreeRTOS queues is limited to 255 items in 8-bit 
-//  *           microcontrollers whose @c portBASE_TYPE is an 8-bit number. This 
-//  *           is a FreeRTOS feature. 
-//  * 
-//  *           Normal writing and reading are done with methods @c put() and 
-//  *           @c get(). Normal writing means that the sending task must wait 
-//  *           until there is empty space in the queue, and then it puts a data
-//  *           item into the "back" of the queue, where "back" means that the 
-//  *           item in the back of the queue will be read after all items that 
-//  *           were previously put into the queue have been read. Normal reading
-//  *           means that when an item is read from the front of the queue, it 
-//  *           will then be removed, making space for more items at the back. 
-//  *           This process is often used to synchronize tasks, as the reading 
-//  *           task's @c get() method blocks, meaning that the reading task gets
-//  *           stuck waiting for an item to arrive in the queue; it won't do 
-//  *           anything useful until new data has been read. Note that this is 
-//  *           acceptable behavior in an RTOS because the RTOS scheduler will
-//  *           ensure that other tasks get to run even while the reading task 
-//  *           is blocking itself waiting for data. 
-//  * 
-//  *           In some cases, one may need to use less normal reading and writing
-//  *           methods. Methods whose name begins with @c ISR_ are to be used 
-//  *           only within a hardware interrupt service routine. If there is a
-//  *           need to put data at the front of the queue instead of the back, 
-//  *           use @c butt_in() instead of @c put(). If one needs to read data 
-//  *           from the queue without removing that data, the @c look_at() method
-//  *           allows this to be done. If something particularly unusual needs to
-//  *           be done with the queue, one can use the method @c get_handle() to
-//  *           retrieve the handle used by the C language functions in FreeRTOS
-//  *           to access the Queue object's underlying data structure directly. 
-//  * 
-//  *           @section queue_usage Usage
-//  *           The following bits of code show how to set up and use a queue to
-//  *           transfer data of type @c int16_t from one hypothetical task 
-//  *           called @c task_A to another called @c task_B.
-//  *  
-//  *           Near the top of the file which contains @c setup() we create a 
-//  *           queue. The constructor of the @c Queue<int16_t> class is given the
-//  *           number of items in the queue (10 in this example) and an optional 
-//  *           name for the queue: 
-//  *           @code
-//  *           #include "taskqueue.h"
-//  *           ...
-//  *           /// This queue holds hockey puck accelerations
-//  *           Queue<int16_t> hockey_queue (10, "Puckey");
-//  *           @endcode
-//  *           In a location which is before we use the queue in any other file
-//  *           than the one in which the queue was created, we re-declare the
-//  *           queue with the keyword @c extern to make it accessible to any task
-//  *           within that file:
-//  *           @code
-//  *           extern Queue<int16_t> hockey_queue;
-//  *           @endcode
-//  *           In the sending task, data is put into the queue:
-//  *           @code
-//  *           int16_t an_item = -3;                 ///< Local acceleration data
-//  *           ...
-//  *           an_item = stick_sensor.get_data (2);  // Read data from sensor 
-//  *           hockey_queue.put (a_data_item);       // Put data into queue
-//  *           @endcode
-//  *           In the receiving task, data is read from the queue. In typical 
-//  *           usage, the call to @c get() will block the receiving task until 
-//  *           data has been put into the queue by the sending task:
-//  *           @code
-//  *           int16_t data_we_got;                  ///< Holds received data
-//  *           ...
-//  *           hockey_queue.get (data_we_got);       // Get data from the queue
-//  *           @endcode
-//  */
-// template <class dataType> class Queue : public BaseShare
-// {
-// // This protected data can only be accessed from this class or its 
-// // descendents
-// protected:
-//     QueueHandle_t handle;             ///< Hhandle for the FreeTOS queue
-//     TickType_t ticks_to_wait;         ///< RTOS ticks to wait for empty
-//     uint16_t buf_size;                ///< Size of queue buffer in bytes
-//     uint16_t max_full;                ///< Maximum number of bytes in queue
-
-// // Public methods can be called from anywhere in the program where there is
-// // a pointer or reference to an object of this class
-// public:
-//     // The constructor creates a FreeRTOS queue
-//     Queue (BaseType_t queue_size, const char* p_name = NULL, 
-//             TickType_t = portMAX_DELAY);
-
-//     // Put an item into the queue behind other items.
-//     bool put (const dataType item);
-
-//     // This method puts an item of data into the back of the queue from 
-//     // within an interrupt service routine. It must not be used within 
-//     // non-ISR code. 
-//     bool ISR_put (const dataType item);
-
-//     /** @brief   Put an item into the front of the queue to be retrieved 
-//      *           first.
-//      *  @details This method puts an item into the front of the queue so
-//      *           that it will be received first as long as nothing else is
-//      *           put in front of it. This is not the normal way to put 
-//      *           things into a queue; using @c put() to put items into the
-//      *           back of the queue is. If you always use this method, 
-//      *           you're making a stack rather than a queue, you weirdo. 
-//      *           This method must @b not be used within an interrupt 
-//      *           service routine. 
-//      *  @param   item The item which is going to be (rudely) put into the front
-//      *           of the queue
-//      *  @return  @c True if the item was successfully queued, false if not
-//      */
-//     bool butt_in (const dataType item)
-//     {
-//         return ((bool)(xQueueSendToFront (handle, &item, ticks_to_wait)));
-//     }
-
-//     // This method puts an item into the front of the queue from within 
-//     // an ISR. It must not be used within normal, non-ISR code. 
-//     bool ISR_butt_in (const dataType item);
-
-//     /** @brief   Return true if the queue is empty.
-//      *  @details This method checks if the queue is empty. It returns 
-//      *           @c true if there are no items in the queue and @c false if
-//      *           there are items.
-//      *  @return  @c true if the queue is empty, @c false if it's not empty
-//      */
-//     bool is_empty (void)
-//     {
-//         return (uxQueueMessagesWaiting (handle) == 0);
-//     }
-
-//     /** @brief   Return true if the queue is empty, from within an ISR.
-//      *  @details This method checks if the queue is empty from within an 
-//      *           interrupt service routine. It must @b not be used in normal
-//      *           non-ISR code. 
-//      *  @return  @c true if the queue is empty, @c false if it's not empty
-//      */
-//     bool ISR_is_empty (void)
-//     {
-//         return (uxQueueMessagesWaitingFromISR (handle) == 0);
-//     }
-
-//     /** @brief   Retrieve and remove the item at the head of the queue.
-//      *  @details This method gets the item at the head of the queue and removes
-//      *           that item from the queue. If there's nothing in the queue, 
-//      *           this method waits, blocking the calling task, for the number 
-//      *           of RTOS ticks specified in the @c wait_time parameter to the 
-//      *           queue constructor (the default is forever) or until something 
-//      *           shows up. 
-//      *  @param   recv_item A reference to the item to be filled with data from 
-//      *           the queue
-//      */
-//     void get (dataType& recv_item)
-//     {
-//         // If xQueueReceive doesn't return pdTrue, nothing was found in the
-//         // queue, so no changes are made to the item
-//         xQueueReceive (handle, &recv_item, ticks_to_wait);
-//     }
-
-//     /** @brief   Retrieve, remove, and return the item at the head of the queue.
-//      *  @details This method gets the item at the head of the queue and removes
-//      *           it from the queue. A copy of the item's contents is returned. 
-//      *           If there's nothing in the queue, this method waits, blocking 
-//      *           the calling task, for the number of RTOS ticks specified in 
-//      *           the @c wait_time parameter to the queue constructor (the 
-//      *           default is forever) or until something shows up. 
-//      *  @returns A copy of the contents of the queue item
-//      */
-//     dataType get (void)
-//     {
-//         dataType return_this;
-//         xQueueReceive (handle, &return_this, ticks_to_wait);
-//         return return_this;
-//     }
-
-//     /** @brief   Remove the item at the head of the queue from within an ISR.
-//      *  @details This method gets and returns the item at the head of the queue 
-//      *           from within an interrupt service routine. This method must 
-//      *           @b not be called from within normal non-ISR code. 
-//      *  @param   recv_item A reference to the item to be filled with data from
-//      *           the queue
-//      */
-//     void ISR_get (dataType& recv_item)
-//     {
-//         portBASE_TYPE task_awakened;         // Checks if context switch needed
-
-//         // If xQueueReceive doesn't return pdTrue, nothing was found in the
-//         // queue, so we won't change the data referenced in the parameter
-//         xQueueReceiveFromISR (handle, &recv_item, &task_awakened);
-//     }
-
-//     /** @brief   Retrieve, remove, and return the item at the head of the queue
-//      *           when called by ISR code.
-//      *  @details This method gets the item at the head of the queue and removes
-//      *           it from the queue. A copy of the item's contents is returned. 
-//      *           This method must @b not be called from within normal non-ISR 
-//      *           code.
-//      *  @returns A copy of the contents of the queue item
-//      */
-//     dataType ISR_get (void)
-//     {
-//         portBASE_TYPE task_awakened;         // Checks if context switch needed
-
-//         dataType return_this;
-//         xQueueReceiveFromISR (handle, &return_this, &task_awakened);
-//         return return_this;
-//     }
-
-//     /** @brief   Get the item at the queue head without removing it.
-//      *  @details This method gets the item at the head of the queue without 
-//      *           removing that item from the queue. If there's nothing in the 
-//      *           queue this method waits, blocking the calling task, for for 
-//      *           the number of RTOS ticks specified in the @c wait_time 
-//      *           parameter to the queue constructor (the default is forever) or
-//      *           until something shows up. This method must @b not be called 
-//      *           from within an interrupt service routine. 
-//      *  @param   recv_item A reference to a variable to be filled with data 
-//      *           from the queue item
-//      */
-//     void peek (dataType& recv_item)
-//     {
-//         // If xQueueReceive doesn't return pdTrue, nothing was found in the
-//         // queue, so don't change the item
-//         xQueuePeek (handle, &recv_item, ticks_to_wait);
-//     }
-
-//     /** @brief   Return a copy of the item at the queue head without removing 
-//      *           it.
-//      *  @details This method returns the item at the head of the queue without 
-//      *           removing that item from the queue. If there's nothing in the 
-//      *           queue this method waits, blocking the calling task, for for 
-//      *           the number of RTOS ticks specified in the @c wait_time 
-//      *           parameter to the queue constructor (the default is forever) or
-//      *           until something shows up. This method must @b not be called 
-//      *           from within an interrupt service routine. 
-//      *  @returns A copy of the data in the item at the head of the queue
-//      */
-//     dataType peek (void)
-//     {
-//         dataType recv_item;
-//         xQueuePeek (handle, &recv_item, ticks_to_wait);
-//         return recv_item;
-//     }
-
-//     /** @brief   Get the item at the front of the queue without deleting it, 
-//      *           from within an ISR.
-//      *  @details This method returns the item at the head of the queue without 
-//      *           removing that item from the queue. If there's nothing in the 
-//      *           queue, this method doesn't change the value of the data given
-//      *           as its parameter. This method must @b only be called within an
-//      *           interrupt service routine. 
-//      *  @param   recv_item A reference to the item to be filled with data from 
-//      *           the queue
-//      */
-//     void ISR_peek (dataType& recv_item)
-//     {
-//         portBASE_TYPE task_awakened;           // Checks if a task will wake up
-
-//         // If xQueueReceive doesn't return pdTrue, nothing was found in the 
-//         // queue, so the value of recv_item is not changed
-//         xQueuePeekFromISR (handle, &recv_item, &task_awakened);
-//     }
-
-//     /** @brief   Return a copy of the item at the front of the queue without 
-//      *           deleting it, from within an ISR.
-//      *  @details This method returns the item at the head of the queue without 
-//      *           removing that item from the queue. If there's nothing in the 
-//      *           queue, this method returns a default value of the type of data
-//      *           in the queue. This method must @b only be called within an
-//      *           interrupt service routine. 
-//      *  @returns A copy of the data in the queue
-//      */
-//     dataType ISR_peek (void)
-//     {
-//         portBASE_TYPE task_awakened;           // Checks if a task will wake up
-//         dataType recv_item;
-//         xQueuePeekFromISR (handle, &recv_item, &task_awakened);
-//         return recv_item;
-//     }
-
-//     /** @brief   Return true if the queue has contents which can be read.
-//      *  @details This method allows one to check if the queue has any 
-//      *           contents. It must @b not be called from within an 
-//      *           interrupt service routine.
-//      *  @return  @c true if there's something in the queue, @c false if not
-//      */
-//     bool any (void)
-//     {
-//         return (uxQueueMessagesWaiting (handle) != 0);
-//     }
-
-//     /** @brief   Operator which inserts data into the queue.
-//      *  @details This convenient operator puts data into the queue, protecting
-//      *           the data from corruption by thread switching. It checks if the
-//      *           processor is currently in an interupt service routine (ISR);
-//      *           if so, it calls ISR specific functions to prevent corruption,
-//      *           so this function may be used within an ISR or outside one. It
-//      *           runs a little more slowly than the @c put() method. 
-//      *  @param   new_data The data which is to be put into the queue
-//      */
-//     void operator << (dataType new_data)
-//     {
-//         if (CHECK_IF_IN_ISR ())
-//         {
-//             ISR_put (new_data);
-//         }
-//         else
-//         {
-//             put (new_data);
-//         }
-//     }
-
-//     /** @brief   Read data from the queue.
-//      *  @details This method is used to read data from the queue . The 
-//      *           retrieved data is copied into the variable which is given as 
-//      *           this method's parameter, replacing the previous contents. This 
-//      *           method checks if the processor is currently in an interupt 
-//      *           service routine (ISR) and if so, it calls ISR specific 
-//      *           functions to prevent corruption, so this function may be used 
-//      *           within an ISR or outside one. It runs a little more slowly 
-//      *           than the @c get() method. 
-//      *  @param   put_here A reference to the variable in which to put received
-//      *           data
-//      */
-//     void operator >> (dataType& put_here)
-//     {
-//         if (CHECK_IF_IN_ISR ())
-//         {
-//             portBASE_TYPE task_awakened;     // Checks if context switch needed
-
-//              // Copy the data from the queue into the receiving variable
-//             xQueueReceiveFromISR (handle, &put_here, &task_awakened);
-//         }
-//         else
-//         {
-//             xQueueReceive (handle, &put_here, ticks_to_wait);
-//         }
-//     }
-
-//     /** @brief   Return true if the queue has items in it, from within an 
-//      *           ISR.
-//      *  @details This method allows one to check if the queue has any 
-//      *           contents from within an interrupt service routine. It must
-//      *           @b not be called from within normal, non-ISR code. 
-//      *  @return  @c true if there's something in the queue, @c false if not
-//      */
-//     bool ISR_any (void)
-//     {
-//         return (uxQueueMessagesWaitingFromISR (handle) != 0);
-//     }
-
-//     /** @brief   Return the number of items in the queue.
-//      *  @details This method returns the number of items waiting in the 
-//      *           queue. It must @b not be called from within an interrupt 
-//      *           service routine; the method @c ISR_num_items_in() can be 
-//      *           called from within an ISR. 
-//      *  @return  The number of items in the queue
-//      */
-//     unsigned portBASE_TYPE available (void)
-//     {
-//         return (uxQueueMessagesWaiting (handle));
-//     }
-
-//     /** @brief   Return the number of items in the queue, to an ISR.
-//      *  @details This method returns the number of items waiting in the 
-//      *           queue; it must be called only from within an interrupt 
-//      *           service routine.
-//      *  @return  The number of items in the queue
-//      */
-//     unsigned portBASE_TYPE ISR_available (void)
-//     {
-//         return (uxQueueMessagesWaitingFromISR (handle));
-//     }
-
-//     /** @brief   Print the queue's status to a serial device.
-//      *  @details This method makes a printout of the queue's status on 
-//      *           the given serial device, then calls this same method 
-//      *           for the next item of thread-safe data in the linked list
-//      *           of items. 
-//      *  @param   print_dev Reference to the serial device on which to print
-//      */
-//     void print_in_list (Print& print_dev);
-
-//     /** @brief   Indicates whether this queue is usable.
-//      *  @details This method returns a value which is @c true if this queue
-//      *           has been successfully set up and can be used. 
-//      *  @returns @c true if this queue is usable, @c false if not
-//      */
-//     bool usable (void)
-//     {
-//         return (bool)handle;
-//     }
-
-//     /** @brief   Return a handle to the FreeRTOS structure which runs this
-//      *           queue.
-//      *  @details If somebody wants to do something which FreeRTOS queues 
-//      *           can do but this class doesn't support, a handle for the 
-//      *           queue wrapped by this class can be used to access the 
-//      *           queue directly. This isn't commonly done.
-//      *  @return  The handle of the FreeRTOS queue which is wrapped within 
-//      *           this C++ class
-//      */
-//     QueueHandle_t get_handle (void)
-//     {
-//         return handle;
-//     }
-// }; // class Queue 
-
-
-// /** @brief   Construct a queue object, allocating memory for the buffer.
-//  *  @details This constructor creates the FreeRTOS queue which is wrapped by 
-//  *           the @c Queue class. 
-//  *  @param   queue_size The number of items which can be stored in the queue
-//  *  @param   p_name A name to be shown in the list of task shares (default 
-//  *           empty String)
-//  *  @param   wait_time How long, in RTOS ticks, to wait for a queue to become
-//  *           empty before a character can be sent. (Default: @c portMAX_DELAY,
-//  *           which causes the sending task to block until sending occurs.)
-//  */
-// template <class dataType>
-// Queue<dataType>::Queue (BaseType_t queue_size, const char* p_name, 
-//                         TickType_t wait_time)
-//     : BaseShare (p_name)
-// {
-//     // Create a FreeRTOS queue object with space for the data items
-//     handle = xQueueCreate (queue_size, sizeof (dataType));
-
-//     // Store the wait time; it will be used when writing to the queue
-//     ticks_to_wait = wait_time;
-
-//     // Save the buffer size
-//     buf_size = queue_size;
-
-//     // We haven't stored any items in the queue yet
-//     max_full = 0;
-// }
-
-
-// /** @brief   Put an item into the queue behind other items.
-//  *  @details This method puts an item of data into the back of the queue, which
-//  *           is the normal way to put something into a queue. If you want to be
-//  *           rude and put an item into the front of the queue so it will be 
-//  *           retrieved first, use @c butt_in() instead. <b>This method must not
-//  *           be used within an Interrupt Service Routine.</b>
-//  *  @param   item The item which is going to be put into the queue
-//  *  @return  True if the item was successfully queued, false if not
-//  */
-// template <class dataType>
-// inline bool Queue<dataType>::put (const dataType item)
-// {
-//     bool return_value = (bool)(xQueueSendToBack (handle, &item, 
-//                                                  ticks_to_wait));
-
-//     // Keep track of the maximum fillage of the queue
-//     uint16_t fillage = uxQueueMessagesWaiting (handle);
-//     if (fillage > max_full)
-//     {
-//         max_full = fillage;
-//     }
-
-//     return (return_value);
-// }
-
-
-// /** @brief   Put an item into the queue from within an ISR.
-//  *  @details This method puts an item of data into the back of the queue from
-//  *           within an interrupt service routine. It must \b not be used within
-//  *           non-ISR code. 
-//  *  @param   item The item which is going to be put into the queue
-//  *  @return  True if the item was successfully queued, false if not
-//  */
-// template <class dataType>
-// inline bool Queue<dataType>::ISR_put (const dataType item)
-// {
-//     // This value is set true if a context switch should occur due to this data
-//     signed portBASE_TYPE shouldSwitch = pdFALSE;
-
-//     bool return_value;                      // Value returned from this method
-
-//     // Call the FreeRTOS function and save its return value
-//     return_value = (bool)(xQueueSendToBackFromISR (handle, &item, 
-//                                                    &shouldSwitch));
-
-//     // Keep track of the maximum fillage of the queue. BUG: max_full isn't
-//     // thread safe (but getting max_full corrupted shouldn't cause a calamity)
-//     uint16_t fillage = uxQueueMessagesWaitingFromISR (handle);
-//     if (fillage > max_full)
-//     {
-//         max_full = fillage;
-//     }
-
-//     // Return the return value saved from the call to xQueueSendToBackFromISR()
-//     return (return_value);
-// }
-
-
-// /** @brief   Put an item into the front of the queue from within an ISR.
-//  *  @details This method puts an item into the front of the queue from within
-//  *           an ISR. It must \b not be used within normal, non-ISR code. 
-//  *  @param   item The item which is going to be (rudely) put into the front of
-//  *           the queue
-//  *  @return  True if the item was successfully queued, false if not
-//  */
-// template <class dataType>
-// inline bool Queue<dataType>::ISR_butt_in (const dataType item)
-// {
-//     // This value is set true if a context switch should occur due to this data
-//     signed portBASE_TYPE shouldSwitch = pdFALSE;
-
-//     bool return_value;                        // Value returned from this method
-
-//     // Call the FreeRTOS function and save its return value
-//     return_value = (bool)(xQueueSendToFrontFromISR (handle, &item, 
-//                                                     &shouldSwitch));
-
-//     // Return the return value saved from the call to xQueueSendToBackFromISR()
-//     return (return_value);
-// }
-
-
-// /** @brief   Print the queue's status to a serial device.
-//  *  @details This method makes a printout of the queue's status on the given
-//  *           serial device, then calls this same method for the next item of 
-//  *           thread-safe data in the linked list of items. 
-//  *  @param   print_dev Reference to the serial device on which to print
-//  */
-// template <class dataType>
-// void Queue<dataType>::print_in_list (Print& print_dev)
-// {
-//     // Print this task's name and pad it to 16 characters
-//     print_dev.printf ("%-16squeue\t", name);
-
-//     // Print the free and total number of spaces in the queue or an error
-//     // message if this queue can't be used (probably due to a memory error)
-//     if (usable ())
-//     {
-//         print_dev << max_full << '/' << buf_size << endl;
-//     }
-//     else
-//     {
-//         print_dev << "UNUSABLE" << endl;
-//     }
-
-//     // Call the next item
-//     if (p_next != NULL)
-//     {
-//         p_next->print_in_list (print_dev);
-//     }
-// }
-
-// #endif  // _TASKQUEUE_H_
\ No newline at end of file
+/** @file taskqueue.h
+ *    This file contains a queue class which carries a stream of data items
+ *    from one RTOS task (or interrupt service routine) to another. It is a
+ *    lock-free single-producer, single-consumer ring buffer: putting and
+ *    getting items takes no lock and makes no kernel call, except that a
+ *    consumer which finds the queue empty sleeps on its task notification
+ *    until the producer puts something in. This version has been tested on
+ *    ESP32's and on the host (see @c native/) only.
+ *
+ *  @date 2012-Oct-21 JRR Original file
+ *  @date 2014-Aug-26 JRR Changed file names and queue class name to Queue
+ *  @date 2020-Oct-10 JRR Made compatible with Arduino/FreeRTOS environment
+ *  @date 2020-Nov-18 JRR Added @c << and @c >> operators for ESP32 and STM32
+ *  @date 2021-Sep-19 JRR Added overloads of @c get(), @c ISR_get(), @c peek(),
+ *                        and @c ISR_peek() which return copies
+ *  @date 2026-Oct-16 Rewritten as a lock-free SPSC ring buffer with batch
+ *                        @c put_n() and @c get_n() and a notification wait
+ *  @date 2026-Oct-16 Added a constructor which uses a caller's buffer, so a
+ *                        queue can be built without heap memory
+ *
+ *  License:
+ *    This file is copyright 2012-2020 by JR Ridgely and released under the
+ *    Lesser GNU Public License, version 2. It intended for educational use
+ *    only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *    IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *    THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIB-
+ *    UTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ *    OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE. */
+
+// This define prevents this .h file from being included more than once
+#ifndef _TASKQUEUE_H_
+#define _TASKQUEUE_H_
+
+#include <Arduino.h>
+#include <atomic>
+#include "baseshare.h"
+#include <PrintStream.h>
+
+/// Size in bytes of the blocks in which the CPU caches memory. The producer's
+/// and consumer's indices are kept this far apart so that a write by one does
+/// not invalidate the cached copy of the other's on a multi-core machine
+#define QUEUE_CACHE_LINE 64
+
+
+/** @brief   Implements a queue to stream data from one RTOS task to another.
+ *  @details Since multithreaded tasks must not use unprotected shared data
+ *           items for communication, queues are a primary means of intertask
+ *           communication. Other means include shared data items (see
+ *           @c taskshare.h) and carrier pigeons. The use of a C++ class
+ *           template allows the compiler to check that you're putting the
+ *           correct type of data into each queue and getting the correct type
+ *           of data out, thus helping to prevent programming mistakes that can
+ *           corrupt your data.
+ *
+ *           Unlike a share, which only holds the most recent value, a queue
+ *           holds every item put into it until the item is read, so no samples
+ *           are lost when the consumer runs more slowly than the producer, as
+ *           long as the queue is big enough. The queue is a ring buffer whose
+ *           size is rounded up to a power of two. Exactly @b one task or ISR
+ *           may put items into a given queue and exactly @b one task or ISR
+ *           may get items from it; with that restriction no lock is needed.
+ *
+ *           Putting never blocks. If the queue is full, the new item is
+ *           dropped and the queue's overflow count goes up, so a producer in
+ *           an ISR can never be held up by a slow consumer. Getting blocks the
+ *           consumer task, for up to the wait time given to the constructor,
+ *           until an item arrives. A blocked consumer sleeps on its FreeRTOS
+ *           task notification, which the producer gives when it puts an item
+ *           into the empty queue. The consuming task should therefore not use
+ *           its task notification for anything else.
+ *
+ *           Methods @c put_n() and @c get_n() move many items at once with a
+ *           single update of the shared indices, which is much cheaper than
+ *           moving them one at a time when a task drains a burst of samples.
+ *
+ *           @section queue_usage Usage
+ *           The following bits of code show how to set up and use a queue to
+ *           transfer data of type @c int16_t from one hypothetical task
+ *           called @c task_A to another called @c task_B.
+ *
+ *           Near the top of the file which contains @c setup() we create a
+ *           queue. The constructor of the @c Queue<int16_t> class is given the
+ *           number of items in the queue (10 in this example, which will be
+ *           rounded up to 16) and an optional name for the queue:
+ *           @code
+ *           #include "taskqueue.h"
+ *           ...
+ *           /// This queue holds hockey puck accelerations
+ *           Queue<int16_t> hockey_queue (10, "Puckey");
+ *           @endcode
+ *           In a location which is before we use the queue in any other file
+ *           than the one in which the queue was created, we re-declare the
+ *           queue with the keyword @c extern to make it accessible to any task
+ *           within that file:
+ *           @code
+ *           extern Queue<int16_t> hockey_queue;
+ *           @endcode
+ *           In the sending task, data is put into the queue:
+ *           @code
+ *           int16_t an_item = -3;                 ///< Local acceleration data
+ *           ...
+ *           an_item = stick_sensor.get_data (2);  // Read data from sensor
+ *           hockey_queue.put (a_data_item);       // Put data into queue
+ *           @endcode
+ *           In the receiving task, data is read from the queue. In typical
+ *           usage, the call to @c get() will block the receiving task until
+ *           data has been put into the queue by the sending task:
+ *           @code
+ *           int16_t data_we_got;                  ///< Holds received data
+ *           ...
+ *           hockey_queue.get (data_we_got);       // Get data from the queue
+ *           @endcode
+ *           A task which handles items in batches can take all those waiting:
+ *           @code
+ *           int16_t batch[16];                    ///< Holds received data
+ *           ...
+ *           uint32_t how_many = hockey_queue.get_n (batch, 16);
+ *           @endcode
+ */
+template <class dataType> class Queue : public BaseShare
+{
+// This protected data can only be accessed from this class or its
+// descendents
+protected:
+    // Written by the producer only
+    /// Free-running count of items ever put into the queue
+    alignas (QUEUE_CACHE_LINE) std::atomic<uint32_t> head;
+    uint32_t tail_seen;               ///< Producer's last look at @c tail
+    std::atomic<uint32_t> max_full;   ///< Most items ever in the queue at once
+    std::atomic<uint32_t> overflows;  ///< Number of items dropped when full
+
+    // Written by the consumer only
+    /// Free-running count of items ever taken out of the queue
+    alignas (QUEUE_CACHE_LINE) std::atomic<uint32_t> tail;
+    uint32_t head_seen;               ///< Consumer's last look at @c head
+    /// The consumer's task while it sleeps waiting for data, else @c NULL
+    std::atomic<TaskHandle_t> waiting_task;
+
+    // Set by the constructor and not changed afterwards
+    alignas (QUEUE_CACHE_LINE) dataType* buffer;  ///< Storage for the items
+    uint32_t buf_size;                ///< Number of items the buffer holds
+    uint32_t index_mask;              ///< Turns a count into a buffer index
+    TickType_t ticks_to_wait;         ///< RTOS ticks to wait for data
+
+    /** @brief   Get the number of items the producer may still put in.
+     *  @details The consumer's index is only re-read when the last value seen
+     *           shows too little space, which keeps the producer from pulling
+     *           the consumer's cache line over on every put.
+     *  @param   wanted The number of spaces the producer would like
+     *  @returns The number of free spaces, at least as many as wanted if the
+     *           queue has that many
+     */
+    uint32_t space (uint32_t wanted)
+    {
+        uint32_t in = head.load (std::memory_order_relaxed);
+        if (buf_size - (in - tail_seen) < wanted)
+        {
+            tail_seen = tail.load (std::memory_order_acquire);
+        }
+        return buf_size - (in - tail_seen);
+    }
+
+    /** @brief   Get the number of items the consumer may take out.
+     *  @param   wanted The number of items the consumer would like
+     *  @returns The number of items in the queue, at least as many as wanted
+     *           if there are that many
+     */
+    uint32_t filled (uint32_t wanted)
+    {
+        uint32_t out = tail.load (std::memory_order_relaxed);
+        if (head_seen - out < wanted)
+        {
+            head_seen = head.load (std::memory_order_acquire);
+        }
+        return head_seen - out;
+    }
+
+    /** @brief   Release items which have been copied into the buffer.
+     *  @details This method moves the head past the new items, records the
+     *           queue's fill level, and returns the consumer's task if it is
+     *           asleep waiting for data, so that the caller can wake it up.
+     *  @param   count The number of new items
+     *  @returns The handle of a sleeping consumer, or @c NULL if there is none
+     */
+    TaskHandle_t release_items (uint32_t count)
+    {
+        uint32_t in = head.load (std::memory_order_relaxed) + count;
+
+        // The store to head and load of waiting_task must not be reordered,
+        // or a consumer going to sleep at the same moment could be missed
+        head.store (in, std::memory_order_seq_cst);
+        TaskHandle_t sleeper = NULL;
+        if (waiting_task.load (std::memory_order_seq_cst) != NULL)
+        {
+            sleeper = waiting_task.exchange (NULL);
+        }
+
+        SHARE_STATS_PUT_N (count);
+
+        uint32_t fillage = in - tail.load (std::memory_order_relaxed);
+        if (fillage > max_full.load (std::memory_order_relaxed))
+        {
+            max_full.store (fillage, std::memory_order_relaxed);
+        }
+        return sleeper;
+    }
+
+    /** @brief   Copy items into the buffer behind those already there.
+     *  @param   p_items Pointer to the first item to be copied
+     *  @param   count How many items to copy; there must be space for them
+     */
+    void copy_in (const dataType* p_items, uint32_t count)
+    {
+        uint32_t in = head.load (std::memory_order_relaxed);
+        for (uint32_t index = 0; index < count; index++)
+        {
+            buffer[(in + index) & index_mask] = p_items[index];
+        }
+    }
+
+    /** @brief   Copy items out of the front of the buffer and free the space.
+     *  @param   p_items Pointer to where the first item is to be copied
+     *  @param   count How many items to copy; there must be that many
+     */
+    void copy_out (dataType* p_items, uint32_t count)
+    {
+        uint32_t out = tail.load (std::memory_order_relaxed);
+        for (uint32_t index = 0; index < count; index++)
+        {
+            p_items[index] = buffer[(out + index) & index_mask];
+        }
+        SHARE_STATS_GET_N (count);
+        tail.store (out + count, std::memory_order_release);
+    }
+
+    /** @brief   Sleep until the queue holds at least one item or time runs out.
+     *  @details The consumer announces that it is going to sleep, then looks
+     *           once more before sleeping in case an item was put in just
+     *           before the announcement. A notification given between that
+     *           look and the call to @c ulTaskNotifyTake() is remembered by
+     *           FreeRTOS, so it cannot be lost. Such a notification may also
+     *           be left over after the consumer found data without sleeping,
+     *           so waking up with the queue still empty just means sleeping
+     *           again for whatever is left of the wait time.
+     *  @returns The number of items now in the queue, which is zero if the
+     *           wait timed out
+     */
+    uint32_t wait_for_data (void)
+    {
+        uint32_t count = filled (1);
+        TickType_t start = xTaskGetTickCount ();
+
+        while (count == 0)
+        {
+            TickType_t waited = xTaskGetTickCount () - start;
+            if (ticks_to_wait != portMAX_DELAY && waited >= ticks_to_wait)
+            {
+                break;
+            }
+
+            waiting_task.store (xTaskGetCurrentTaskHandle (),
+                                std::memory_order_seq_cst);
+
+            // This look at head must be sequentially consistent too, as
+            // filled()'s acquire load could be ordered before the store
+            // above and miss an item whose producer saw no sleeper
+            head_seen = head.load (std::memory_order_seq_cst);
+            count = head_seen - tail.load (std::memory_order_relaxed);
+            if (count == 0)
+            {
+                SHARE_STATS_WAIT_START ();
+                ulTaskNotifyTake (pdTRUE, (ticks_to_wait == portMAX_DELAY)
+                                          ? portMAX_DELAY
+                                          : ticks_to_wait - waited);
+                SHARE_STATS_WAIT_END ();
+                count = filled (1);
+            }
+            waiting_task.store (NULL, std::memory_order_seq_cst);
+        }
+
+        return count;
+    }
+
+// Public methods can be called from anywhere in the program where there is
+// a pointer or reference to an object of this class
+public:
+    // The constructor allocates the ring buffer
+    Queue (uint32_t queue_size, const char* p_name = NULL,
+           TickType_t wait_time = portMAX_DELAY);
+
+    // This constructor uses a buffer supplied by the caller
+    Queue (dataType* p_storage, uint32_t storage_size, const char* p_name = NULL,
+           TickType_t wait_time = portMAX_DELAY);
+
+    // Put an item into the queue behind other items
+    bool put (const dataType item);
+
+    // Put an item into the queue from within an interrupt service routine
+    bool ISR_put (const dataType item);
+
+    // Put as many of a block of items as will fit into the queue
+    uint32_t put_n (const dataType* p_items, uint32_t count);
+
+    // Put a block of items into the queue from within an ISR
+    uint32_t ISR_put_n (const dataType* p_items, uint32_t count);
+
+    // Take up to a given number of items from the queue, waiting for one
+    uint32_t get_n (dataType* p_items, uint32_t max_count);
+
+    /** @brief   Return true if the queue is empty.
+     *  @details This method may be called by the consumer only.
+     *  @return  @c true if the queue is empty, @c false if it's not empty
+     */
+    bool is_empty (void)
+    {
+        return (filled (1) == 0);
+    }
+
+    /** @brief   Return true if the queue has contents which can be read.
+     *  @details This method may be called by the consumer only.
+     *  @return  @c true if there's something in the queue, @c false if not
+     */
+    bool any (void)
+    {
+        return (filled (1) != 0);
+    }
+
+    /** @brief   Retrieve and remove the item at the head of the queue.
+     *  @details This method gets the item at the head of the queue and removes
+     *           that item from the queue. If there's nothing in the queue,
+     *           this method waits, blocking the calling task, for the number
+     *           of RTOS ticks specified in the @c wait_time parameter to the
+     *           queue constructor (the default is forever) or until something
+     *           shows up.
+     *  @param   recv_item A reference to the item to be filled with data from
+     *           the queue
+     *  @return  @c true if an item was received, @c false if the wait timed
+     *           out or the queue is not usable, in which case @c recv_item
+     *           is not changed
+     */
+    bool get (dataType& recv_item)
+    {
+        if (!usable () || wait_for_data () == 0)
+        {
+            return false;
+        }
+        copy_out (&recv_item, 1);
+        return true;
+    }
+
+    /** @brief   Retrieve, remove, and return the item at the head of the queue.
+     *  @details This method gets the item at the head of the queue and removes
+     *           it from the queue, waiting as @c get(dataType&) does.
+     *  @returns A copy of the contents of the queue item, or a default value
+     *           of the data type if the wait timed out
+     */
+    dataType get (void)
+    {
+        dataType return_this = dataType ();
+        get (return_this);
+        return return_this;
+    }
+
+    /** @brief   Remove the item at the head of the queue from within an ISR.
+     *  @details This method never blocks. It must only be used when the ISR
+     *           is the queue's one consumer.
+     *  @param   recv_item A reference to the item to be filled with data from
+     *           the queue
+     *  @return  @c true if an item was received, @c false if the queue was
+     *           empty, in which case @c recv_item is not changed
+     */
+    bool ISR_get (dataType& recv_item)
+    {
+        if (filled (1) == 0)
+        {
+            return false;
+        }
+        copy_out (&recv_item, 1);
+        return true;
+    }
+
+    /** @brief   Get the item at the queue head without removing it.
+     *  @details This method waits for an item as @c get() does, but leaves
+     *           the item in the queue.
+     *  @param   recv_item A reference to a variable to be filled with data
+     *           from the queue item
+     *  @return  @c true if an item was found, @c false if the wait timed out
+     *           or the queue is not usable
+     */
+    bool peek (dataType& recv_item)
+    {
+        if (!usable () || wait_for_data () == 0)
+        {
+            return false;
+        }
+        recv_item = buffer[tail.load (std::memory_order_relaxed) & index_mask];
+        return true;
+    }
+
+    /** @brief   Operator which inserts data into the queue.
+     *  @details This convenient operator puts data into the queue. It checks
+     *           if the processor is currently in an interupt service routine
+     *           (ISR) and calls @c ISR_put() or @c put() as appropriate, so
+     *           this function may be used within an ISR or outside one.
+     *  @param   new_data The data which is to be put into the queue
+     */
+    void operator << (dataType new_data)
+    {
+        if (CHECK_IF_IN_ISR ())
+        {
+            ISR_put (new_data);
+        }
+        else
+        {
+            put (new_data);
+        }
+    }
+
+    /** @brief   Read data from the queue.
+     *  @details This operator calls @c ISR_get() inside an ISR and @c get()
+     *           outside one, so it may be used in either place.
+     *  @param   put_here A reference to the variable in which to put received
+     *           data
+     */
+    void operator >> (dataType& put_here)
+    {
+        if (CHECK_IF_IN_ISR ())
+        {
+            ISR_get (put_here);
+        }
+        else
+        {
+            get (put_here);
+        }
+    }
+
+    /** @brief   Return the number of items in the queue.
+     *  @details This method may be called from any task, but the result may
+     *           be out of date by the time the caller uses it unless the
+     *           caller is the producer or the consumer.
+     *  @return  The number of items in the queue
+     */
+    uint32_t available (void)
+    {
+        return (head.load (std::memory_order_acquire)
+                - tail.load (std::memory_order_acquire));
+    }
+
+    /** @brief   Return the largest number of items ever in the queue.
+     *  @return  The queue's high-water mark
+     */
+    uint32_t high_water_mark (void)
+    {
+        return max_full.load (std::memory_order_relaxed);
+    }
+
+    /** @brief   Return the number of items dropped because the queue was full.
+     *  @return  The queue's overflow count
+     */
+    uint32_t overflow_count (void)
+    {
+        return overflows.load (std::memory_order_relaxed);
+    }
+
+    /** @brief   Return the number of items which the queue can hold.
+     *  @return  The size of the queue's buffer, in items
+     */
+    uint32_t size (void)
+    {
+        return buf_size;
+    }
+
+    /** @brief   Print the queue's status to a serial device.
+     *  @details This method makes a printout of the queue's status on
+     *           the given serial device, then calls this same method
+     *           for the next item of thread-safe data in the linked list
+     *           of items.
+     *  @param   print_dev Reference to the serial device on which to print
+     */
+    void print_in_list (Print& print_dev);
+
+    /** @brief   Indicates whether this queue is usable.
+     *  @details This method returns a value which is @c true if this queue
+     *           has been successfully set up and can be used.
+     *  @returns @c true if this queue is usable, @c false if not
+     */
+    bool usable (void)
+    {
+        return (buffer != NULL);
+    }
+}; // class Queue
+
+
+/** @brief   Construct a queue object, allocating memory for the buffer.
+ *  @details This constructor allocates the ring buffer which holds the
+ *           queue's items. The number of items is rounded up to a power of
+ *           two so that buffer indices can be found with a mask.
+ *  @param   queue_size The number of items which can be stored in the queue
+ *  @param   p_name A name to be shown in the list of task shares (default
+ *           empty String)
+ *  @param   wait_time How long, in RTOS ticks, a consumer waits for data to
+ *           arrive in an empty queue. (Default: @c portMAX_DELAY, which causes
+ *           the receiving task to block until data arrives.)
+ */
+template <class dataType>
+Queue<dataType>::Queue (uint32_t queue_size, const char* p_name,
+                        TickType_t wait_time)
+    : BaseShare (p_name), head (0), tail_seen (0), max_full (0),
+      overflows (0), tail (0), head_seen (0), waiting_task (NULL)
+{
+    // Round the size up to a power of two
+    buf_size = 1;
+    while (buf_size < queue_size)
+    {
+        buf_size <<= 1;
+    }
+    index_mask = buf_size - 1;
+
+    buffer = new dataType[buf_size];
+
+    // Store the wait time; it will be used when reading from the queue
+    ticks_to_wait = wait_time;
+}
+
+
+/** @brief   Construct a queue object which uses a buffer given by the caller.
+ *  @details This constructor allocates no memory, so a queue whose buffer is a
+ *           global array needs no heap at all. Since the buffer's size must be
+ *           a power of two, only the largest power of two items which fits in
+ *           the given buffer are used.
+ *           @code
+ *           uint16_t sample_buffer[64];            // Global variables
+ *           Queue<uint16_t> samples (sample_buffer, 64, "Samples");
+ *           @endcode
+ *  @param   p_storage Pointer to an array which will hold the queue's items
+ *  @param   storage_size The number of items in the array at @c p_storage
+ *  @param   p_name A name to be shown in the list of task shares (default
+ *           empty String)
+ *  @param   wait_time How long, in RTOS ticks, a consumer waits for data to
+ *           arrive in an empty queue (default: @c portMAX_DELAY)
+ */
+template <class dataType>
+Queue<dataType>::Queue (dataType* p_storage, uint32_t storage_size,
+                        const char* p_name, TickType_t wait_time)
+    : BaseShare (p_name), head (0), tail_seen (0), max_full (0),
+      overflows (0), tail (0), head_seen (0), waiting_task (NULL)
+{
+    // Round the size down to a power of two
+    buf_size = 1;
+    while ((buf_size << 1) <= storage_size)
+    {
+        buf_size <<= 1;
+    }
+    index_mask = buf_size - 1;
+
+    // A queue with no storage can't hold anything; usable() reports it
+    configASSERT (storage_size > 0);
+    buffer = (storage_size > 0) ? p_storage : NULL;
+    ticks_to_wait = wait_time;
+}
+
+
+/** @brief   Put an item into the queue behind other items.
+ *  @details This method puts an item of data into the back of the queue and
+ *           wakes the consumer if it was waiting for data. It never blocks;
+ *           if the queue is full, the item is dropped and counted as an
+ *           overflow. <b>This method must not be used within an Interrupt
+ *           Service Routine.</b>
+ *  @param   item The item which is going to be put into the queue
+ *  @return  @c true if the item was successfully queued, @c false if not
+ */
+template <class dataType>
+inline bool Queue<dataType>::put (const dataType item)
+{
+    return (put_n (&item, 1) == 1);
+}
+
+
+/** @brief   Put an item into the queue from within an ISR.
+ *  @details This method puts an item of data into the back of the queue from
+ *           within an interrupt service routine. It must \b not be used within
+ *           non-ISR code.
+ *  @param   item The item which is going to be put into the queue
+ *  @return  @c true if the item was successfully queued, @c false if not
+ */
+template <class dataType>
+inline bool Queue<dataType>::ISR_put (const dataType item)
+{
+    return (ISR_put_n (&item, 1) == 1);
+}
+
+
+/** @brief   Put as many of a block of items as will fit into the queue.
+ *  @details The items which fit are copied in and published together. Any
+ *           which do not fit are dropped and counted as overflows.
+ *           <b>This method must not be used within an ISR.</b>
+ *  @param   p_items Pointer to the first of the items to be put
+ *  @param   count The number of items to be put
+ *  @return  The number of items which were put into the queue, which is zero
+ *           if the queue is not usable
+ */
+template <class dataType>
+uint32_t Queue<dataType>::put_n (const dataType* p_items, uint32_t count)
+{
+    if (!usable ())
+    {
+        return 0;
+    }
+
+    uint32_t room = space (count);
+    uint32_t to_put = (count < room) ? count : room;
+
+    overflows.store (overflows.load (std::memory_order_relaxed)
+                     + (count - to_put), std::memory_order_relaxed);
+    if (to_put == 0)
+    {
+        return 0;
+    }
+
+    copy_in (p_items, to_put);
+    TaskHandle_t sleeper = release_items (to_put);
+    if (sleeper != NULL)
+    {
+        xTaskNotifyGive (sleeper);
+    }
+    return to_put;
+}
+
+
+/** @brief   Put a block of items into the queue from within an ISR.
+ *  @details This method works as @c put_n() does, but wakes the consumer with
+ *           the ISR version of the notification call. It must \b not be used
+ *           within non-ISR code.
+ *  @param   p_items Pointer to the first of the items to be put
+ *  @param   count The number of items to be put
+ *  @return  The number of items which were put into the queue, which is zero
+ *           if the queue is not usable
+ */
+template <class dataType>
+uint32_t Queue<dataType>::ISR_put_n (const dataType* p_items, uint32_t count)
+{
+    if (!usable ())
+    {
+        return 0;
+    }
+
+    uint32_t room = space (count);
+    uint32_t to_put = (count < room) ? count : room;
+
+    overflows.store (overflows.load (std::memory_order_relaxed)
+                     + (count - to_put), std::memory_order_relaxed);
+    if (to_put == 0)
+    {
+        return 0;
+    }
+
+    copy_in (p_items, to_put);
+    TaskHandle_t sleeper = release_items (to_put);
+    if (sleeper != NULL)
+    {
+        BaseType_t higher_priority_woken = pdFALSE;
+        vTaskNotifyGiveFromISR (sleeper, &higher_priority_woken);
+        portYIELD_FROM_ISR (higher_priority_woken);
+    }
+    return to_put;
+}
+
+
+/** @brief   Take up to a given number of items from the queue.
+ *  @details If the queue is empty, this method waits as @c get() does until
+ *           at least one item arrives. It then takes all the items waiting,
+ *           up to @c max_count, and frees their space in one step.
+ *           <b>This method must not be used within an ISR.</b>
+ *  @param   p_items Pointer to an array which receives the items
+ *  @param   max_count The most items to take, which is the array's size
+ *  @return  The number of items taken, which is zero if the wait timed out
+ *           or the queue is not usable
+ */
+template <class dataType>
+uint32_t Queue<dataType>::get_n (dataType* p_items, uint32_t max_count)
+{
+    if (!usable () || wait_for_data () == 0)
+    {
+        return 0;
+    }
+
+    uint32_t count = filled (max_count);
+    if (count > max_count)
+    {
+        count = max_count;
+    }
+    copy_out (p_items, count);
+    return count;
+}
+
+
+/** @brief   Print the queue's status to a serial device.
+ *  @details This method prints the number of items in the queue and its size,
+ *           the most items which have ever been in it, and how many items have
+ *           been dropped because it was full. It then calls this same method
+ *           for the next item of thread-safe data in the linked list of items.
+ *  @param   print_dev Reference to the serial device on which to print
+ */
+template <class dataType>
+void Queue<dataType>::print_in_list (Print& print_dev)
+{
+    // Print this task's name and pad it to 16 characters
+    print_dev.printf ("%-16squeue\t", name);
+
+    // Print the depth and size, high-water mark and overflows, or an error
+    // message if this queue can't be used (probably due to a memory error)
+    if (usable ())
+    {
+        print_dev << available () << '/' << buf_size << " max "
+                  << high_water_mark () << " ovf " << overflow_count ();
+
+        // Add the usage statistics if they're being kept
+        SHARE_STATS_PRINT (print_dev);
+        print_dev << endl;
+    }
+    else
+    {
+        print_dev << "UNUSABLE" << endl;
+    }
+
+    // Call the next item
+    if (p_next != NULL)
+    {
+        p_next->print_in_list (print_dev);
+    }
+}
+
+#endif // _TASKQUEUE_H_
@@ -21,6 +21,8 @@
  *  @date 2020-Nov-18 JRR Critical sections not reliable; changed to a queue
  *  @date 2021-Sep-17 JRR Changed some @c put params from references to copies
  *  @date 2021-Sep-19 JRR Added overloads for @c get() which return values
+ *  @date 2026-Oct-16 Added optional usage statistics (@c SHARE_STATS)
+ *  @date 2026-Oct-16 Added optional heap-free construction (@c STATIC_ALLOC)
  *
  *  @copyright This file is copyright 2014 -- 2021 by JR Ridgely and released 
  *    under the Lesser GNU Public License, version 2. It intended for 
@@ -123,17 +125,31 @@ protected:
     /// A queue is used to hold the data, as it's portable to different CPU's
     QueueHandle_t queue;
 
+#ifdef STATIC_ALLOC
+    /// Control block of the queue, so the queue needs no heap memory
+    StaticQueue_t queue_control;
+
+    /// Storage for the one item of data in the queue
+    uint8_t queue_storage[sizeof (DataType)];
+#endif
+
 public:
     /** @brief   Construct a shared data item.
      *  @details This constructor for a shared data item creates a queue in 
      *           which to hold one item of data. Note that the data is @b not 
-     *           initialized. 
+     *           initialized. If @c STATIC_ALLOC is defined, the queue is built
+     *           in memory which is part of this object rather than on the heap.
      *  @param   p_name A name to be shown in the list of task shares 
      *           (default @c NULL)
      */
     Share<DataType> (const char* p_name = NULL) : BaseShare (p_name)
     {
+#ifdef STATIC_ALLOC
+        queue = xQueueCreateStatic (1, sizeof (DataType), queue_storage,
+                                    &queue_control);
+#else
         queue = xQueueCreate (1, sizeof (DataType));
+#endif
     }
 
     /** @brief   Put data into the shared data item.
@@ -143,6 +159,8 @@ public:
     void put (DataType new_data)
     {
         xQueueOverwrite (queue, &new_data);
+        SHARE_STATS_PUT ();
+        publish ();
     }
 
     /** @brief   Put data into the shared data item from within an ISR.
@@ -155,6 +173,8 @@ public:
     {
         BaseType_t wake_up;
         xQueueOverwriteFromISR (queue, &new_data, &wake_up);
+        SHARE_STATS_PUT ();
+        ISR_publish ();
     }
 
     /** @brief   Operator which inserts data into the share.
@@ -172,10 +192,14 @@ public:
         {
             BaseType_t wake_up;
             xQueueOverwriteFromISR (queue, &new_data, &wake_up);
+            SHARE_STATS_PUT ();
+            ISR_publish ();
         }
         else
         {
             xQueueOverwrite (queue, &new_data);
+            SHARE_STATS_PUT ();
+            publish ();
         }
     }
 
@@ -202,8 +226,11 @@ public:
         }
         else
         {
+            SHARE_STATS_WAIT_START ();
             xQueuePeek (queue, &put_here, portMAX_DELAY);
+            SHARE_STATS_WAIT_END ();
         }
+        SHARE_STATS_GET ();
     }
 
     /** @brief   Read data from the shared data item into a variable.
@@ -218,7 +245,10 @@ public:
     void get (DataType& recv_data)
     {
         // Copy the data from the queue into the receiving variable
+        SHARE_STATS_WAIT_START ();
         xQueuePeek (queue, &recv_data, portMAX_DELAY);
+        SHARE_STATS_WAIT_END ();
+        SHARE_STATS_GET ();
     }
 
     /** @brief   Read and return data from the shared data item.
@@ -233,7 +263,10 @@ public:
         DataType return_this;
     
         // Copy the data from the queue into the receiving variable
+        SHARE_STATS_WAIT_START ();
         xQueuePeek (queue, &return_this, portMAX_DELAY);
+        SHARE_STATS_WAIT_END ();
+        SHARE_STATS_GET ();
 
         return return_this;
     }
@@ -248,6 +281,7 @@ public:
     void ISR_get (DataType& recv_data)
     {
         xQueuePeekFromISR (queue, &recv_data);
+        SHARE_STATS_GET ();
     }
 
     /** @brief   Read and return data from the shared data item, from within an
@@ -262,6 +296,7 @@ public:
     {
         DataType return_this;
         xQueuePeekFromISR (queue, &return_this);
+        SHARE_STATS_GET ();
         return return_this;
     }
 
@@ -285,6 +320,9 @@ void Share<DataType>::print_in_list (Print& printer)
     // Print this task's name and pad it to 16 characters
     printer.printf ("%-16sshare\t", name);
 
+    // Add the usage statistics if they're being kept
+    SHARE_STATS_PRINT (printer);
+
     // End the line
     printer << endl;
 
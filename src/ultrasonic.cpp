@@ -1,14 +1,16 @@
 /** @file ultrasonic.cpp
  *  @brief The source file for an HC_SR04 Ultrasonic Sensor class
- * 
- *  Based on an examples by Arbi Abdul Jabbaar at 
+ *
+ *  Based on an examples by Arbi Abdul Jabbaar at
  *  @c https://create.arduino.cc/projecthub/abdularbi17/ultrasonic-sensor-hc-sr04-with-arduino-tutorial-327ff6
- * 
+ *
  *  @author Arbi Abdul Jabbaar
  *  @author Damond Li
  *  @author Arielle Sampson
  *  @date 2019-Sept-17 Original file
  *  @date 2022-Nov-30 Modified for Airheads Glider Project use by Li and Sampson
+ *  @date 2026-Oct-16 Ranging driven by a timer and echo interrupts rather
+ *        than @c pulseIn(), which spun for up to a second without an echo
  *  @copyright 2019 by the author
  */
 
@@ -16,42 +18,169 @@
 #include "ultrasonic.h"
 
 /** @brief   Constructor which creates an ultrasonic sensor object
+ *  @details The sensor belongs to the task which constructs it; that task is
+ *           the one woken when each ping finishes. The first ping is sent one
+ *           period after construction.
  *  @param   echo The GPIO pin used to measure the time between ultrasonic pulses
  *  @param   trig The GPIO pin used to send out ultrasonic pulses
+ *  @param   period The time between pings (ms), which must be longer than
+ *           the sensor's longest echo of about 38 ms
  */
-Ultrasonic::Ultrasonic(uint8_t echo, uint8_t trig)
+Ultrasonic::Ultrasonic(uint8_t echo, uint8_t trig, uint32_t period)
 {
     // Establish the trigger and echo pins
     trigPin = trig;
     echoPin = echo;
+    period_ms = period;
+    cm_per_us = range_cm_per_us(20.0f);
+    p_task = xTaskGetCurrentTaskHandle();
+    portMUX_INITIALIZE(&mux);
+    state = PING_IDLE;
+    ping_us = 0;
+    rise_us = 0;
+    done_ping_us = 0;
+    done_echo_us = 0;
+    pings = 0;
+    timeouts = 0;
 
     // Set the pins accordingly
     pinMode(trigPin, OUTPUT);   // Sets the trigPin as an OUTPUT
     pinMode(echoPin, INPUT);    // Sets the echoPin as an INPUT
+    digitalWrite(trigPin, LOW);
+    attachInterruptArg(echoPin, echo_ISR, this, CHANGE);
+
+    // Send pings from the high resolution timer's task, at a steady rate
+    // whatever the owning task is doing
+    esp_timer_create_args_t timer_args = {};
+    timer_args.callback = trigger_callback;
+    timer_args.arg = this;
+    timer_args.dispatch_method = ESP_TIMER_TASK;
+    timer_args.name = "Ultrasonic";
+    esp_timer_create(&timer_args, &trigger_timer);
+    esp_timer_start_periodic(trigger_timer, (uint64_t)period_ms * 1000);
 }
 
-/** @brief   Measure the distance between the sensor and the object in front of it
- *  @returns The distance, in centimeters, between the sensor and the object in front of it
+/** @brief   Timer callback which sends a ping
+ *  @details If the previous ping's echo hasn't ended, it never will in a
+ *           useful time, so it is finished with no echo and the owning task
+ *           is woken to report it. The trigger pulse is short enough to time
+ *           by spinning.
+ *  @param   p_sensor A pointer to the @c Ultrasonic object
  */
-float Ultrasonic::get_distance (void)
+void Ultrasonic::trigger_callback(void* p_sensor)
 {
-    distance;       // variable to store calculated distance
-    duration;       // variable for the duration of sound wave travel
-          
-    // Clears the trigPin condition
-    digitalWrite(trigPin, LOW);
-    delayMicroseconds(2);
+    Ultrasonic* p_this = (Ultrasonic*)p_sensor;
 
-    // Sets the trigPin HIGH (ACTIVE) for 10 microseconds
-    digitalWrite(trigPin, HIGH);
-    delayMicroseconds(10);
-    digitalWrite(trigPin, LOW);
+    portENTER_CRITICAL(&p_this->mux);
+    bool timed_out = (p_this->state != PING_IDLE);
+    if (timed_out)
+    {
+        p_this->done_ping_us = p_this->ping_us;
+        p_this->done_echo_us = 0;
+    }
+    p_this->state = PING_SENT;
+    p_this->ping_us = micros();
+    portEXIT_CRITICAL(&p_this->mux);
 
-    // Reads the echoPin, returns the sound wave travel time in microseconds
-    duration = pulseIn(echoPin, HIGH);
+    if (timed_out)
+    {
+        p_this->timeouts++;
+        xTaskNotifyGive(p_this->p_task);
+    }
 
-    // Calculating the distance
-    distance = duration * 0.034 / 2; // Speed of sound wave divided by 2 (go and back)
-            
-    return distance; // return distance measurement in cm
-}
\ No newline at end of file
+    digitalWrite(p_this->trigPin, HIGH);
+    delayMicroseconds(ULTRASONIC_TRIGGER_US);
+    digitalWrite(p_this->trigPin, LOW);
+}
+
+/** @brief   Interrupt service routine for both edges of the echo pulse
+ *  @details The rising edge starts the echo and the falling edge ends it,
+ *           finishing the ping and waking the owning task. Edges which come
+ *           when no ping is waiting for them are ignored.
+ *  @param   p_sensor A pointer to the @c Ultrasonic object
+ */
+void IRAM_ATTR Ultrasonic::echo_ISR(void* p_sensor)
+{
+    Ultrasonic* p_this = (Ultrasonic*)p_sensor;
+    uint32_t now_us = micros();
+    bool finished = false;
+
+    portENTER_CRITICAL_ISR(&p_this->mux);
+    if (digitalRead(p_this->echoPin) == HIGH)
+    {
+        if (p_this->state == PING_SENT)
+        {
+            p_this->rise_us = now_us;
+            p_this->state = PING_ECHO;
+        }
+    }
+    else if (p_this->state == PING_ECHO)
+    {
+        p_this->done_ping_us = p_this->ping_us;
+        p_this->done_echo_us = now_us - p_this->rise_us;
+        p_this->state = PING_IDLE;
+        finished = true;
+    }
+    portEXIT_CRITICAL_ISR(&p_this->mux);
+
+    if (finished)
+    {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(p_this->p_task, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+/** @brief   Sleeps until a ping finishes, then gives its range
+ *  @details The timeout, two periods, only matters if the timer has stopped.
+ *  @param   range Set to the range measured by the ping, which is marked
+ *           invalid if it got no echo or one from too far away
+ *  @returns True if a ping finished, false on a timeout
+ */
+bool Ultrasonic::wait_for_range(Range& range)
+{
+    if (ulTaskNotifyTake(pdTRUE, 2 * period_ms / portTICK_PERIOD_MS) == 0)
+    {
+        return false;
+    }
+
+    portENTER_CRITICAL(&mux);
+    uint32_t sent_us = done_ping_us;
+    uint32_t echo_us = done_echo_us;
+    portEXIT_CRITICAL(&mux);
+
+    range.time_us = sent_us;
+    range.valid = (echo_us > 0 && echo_us <= ULTRASONIC_MAX_ECHO_US);
+    range.distance = range.valid ? echo_us * cm_per_us : 0.0f;
+    range.sequence = ++pings;
+    return true;
+}
+
+/** @brief   Corrects the speed of sound for the air temperature
+ *  @details Until this is called, the air is taken to be at 20 C. The speed
+ *           changes by about 0.17% per degree, so a sensor calibrated in a
+ *           warm room reads 3% long on a cold field.
+ *  @param   temperature The temperature of the air (C)
+ */
+void Ultrasonic::set_temperature(float temperature)
+{
+    cm_per_us = range_cm_per_us(temperature);
+}
+
+/** @brief   Changes the time between pings
+ *  @details The timer is restarted, so the next ping is sent one new period
+ *           from now. A ping still waiting for its echo is unaffected; it
+ *           times out at the next trigger as usual, so the period should not
+ *           be shorter than the longest echo of interest.
+ *  @param   period The new time between pings (ms)
+ */
+void Ultrasonic::set_period(uint32_t period)
+{
+    if (period == period_ms)
+    {
+        return;
+    }
+    period_ms = period;
+    esp_timer_stop(trigger_timer);
+    esp_timer_start_periodic(trigger_timer, (uint64_t)period_ms * 1000);
+}
@@ -1,9 +1,10 @@
 /** @file ultrasonic.h
  *  @brief The header file for an HC_SR04 Ultrasonic Sensor class
- * 
+ *
  *  @author Damond Li
  *  @author Arielle Sampson
  *  @date 2022-Nov-30 Original file
+ *  @date 2026-Oct-16 Ranging driven by a timer and echo interrupts
  */
 
 // Compile the header file only once
@@ -11,21 +12,57 @@
 #define ULTRASONIC
 
 #include <Arduino.h>
+#include <esp_timer.h>
+#include "range.h"
+#include "rangefilter.h"
+
+/// Longest echo which counts as a distance, about 4.3 m (us)
+#define ULTRASONIC_MAX_ECHO_US 25000
+
+/// Length of the trigger pulse (us)
+#define ULTRASONIC_TRIGGER_US 10
 
 /** @brief  Class for an HC_SR04 Ultrasonic Sensor
+ *  @details A timer sends a trigger pulse once every period. The echo pin's
+ *           interrupt takes the time of the echo's rising and falling edges,
+ *           and on the falling edge wakes the task which owns the sensor,
+ *           which sleeps in @c wait_for_range() in the meantime, so no CPU
+ *           time is spent waiting for the echo. A ping whose echo has not
+ *           ended by the time of the next trigger has timed out, and the
+ *           timer wakes the task to report it as invalid.
  */
-class Ultrasonic //This class operates an HC_SR04 Ultrasonic Sensor 
+class Ultrasonic //This class operates an HC_SR04 Ultrasonic Sensor
 {
 protected:
-    float distance;         ///< The distance between the ultrasonic sensor and the object in front of it
-    uint8_t echoPin;        ///< The GPIO echo pin used to measure the time between ultrasonic pulses 
-    uint8_t trigPin;        ///< The GPIO trigger pin that sends out ultrasonic pulses
-    long duration;          ///< The time between received ultrasonic pulses
+    /// How far a ping has got
+    enum PingState : uint8_t { PING_IDLE, PING_SENT, PING_ECHO };
+
+    uint8_t echoPin;                    ///< The GPIO echo pin used to measure the time between ultrasonic pulses
+    uint8_t trigPin;                    ///< The GPIO trigger pin that sends out ultrasonic pulses
+    uint32_t period_ms;                 ///< Time between pings (ms)
+    float cm_per_us;                    ///< Half the speed of sound (cm/us)
+    TaskHandle_t p_task;                ///< Task which waits for the pings
+    esp_timer_handle_t trigger_timer;   ///< Timer which sends the pings
+    portMUX_TYPE mux;                   ///< Lock for the fields shared with the interrupt and timer
+
+    volatile PingState state;           ///< How far the current ping has got
+    volatile uint32_t ping_us;          ///< micros() when the current ping was sent
+    volatile uint32_t rise_us;          ///< micros() when its echo began
+    volatile uint32_t done_ping_us;     ///< micros() when the last finished ping was sent
+    volatile uint32_t done_echo_us;     ///< Length of its echo, or zero if it timed out (us)
+    uint32_t pings;                     ///< Pings reported by wait_for_range()
+    uint32_t timeouts;                  ///< Pings which got no echo before the next one
 
+    static void echo_ISR (void* p_sensor);          ///< Interrupt for both edges of the echo
+    static void trigger_callback (void* p_sensor);  ///< Timer callback which sends a ping
 
 public:
-    Ultrasonic (uint8_t echoPin, uint8_t trigPin);          ///< Constructor for the ultrasonic sensor class
-    float get_distance (void);                              ///< The method to get the distance measured from the ultrasonic sensor
+    Ultrasonic (uint8_t echoPin, uint8_t trigPin, uint32_t period_ms = 100);   ///< Constructor for the ultrasonic sensor class
+    bool wait_for_range (Range& range);                                         ///< Sleeps until a ping finishes, then gives its range
+    void set_temperature (float temperature);                                   ///< Corrects the speed of sound for the air temperature
+    void set_period (uint32_t period_ms);                                       ///< Changes the time between pings
+    uint32_t get_period (void) { return period_ms; }                            ///< Returns the time between pings (ms)
+    uint32_t get_timeouts (void) { return timeouts; }                           ///< Returns the number of pings which got no echo
 };
 
-#endif // ULTRASONIC
\ No newline at end of file
+#endif // ULTRASONIC
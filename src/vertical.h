@@ -0,0 +1,35 @@
+/** @file vertical.h
+ *  @brief Snapshot of the glider's height, climb rate and time to contact
+ *         which is published by the IMU task.
+ *
+ *  @author ME 507 Airheads
+ *  @date 2026-Oct-16 Original file
+ */
+
+#ifndef _VERTICAL_H_
+#define _VERTICAL_H_
+
+#include <Arduino.h>
+
+/// Time to contact given when the glider is not coming down (s)
+#define VERTICAL_NO_CONTACT 99.0f
+
+/** @brief  One estimate of the glider's motion above the ground.
+ *  @details All the fields are written together into a
+ *           @c FastShare<VerticalState> after each batch of IMU samples. The
+ *           climb rate is always estimated, from the accelerometer alone if
+ *           need be, but the height and time to contact mean something only
+ *           while @c valid is true, which is while the ground is in range of
+ *           the ultrasonic sensor.
+ */
+struct VerticalState
+{
+    float height;           ///< Height of the ultrasonic sensor above the ground (cm)
+    float climb_rate;       ///< Rate of climb, negative when coming down (cm/s)
+    float time_to_contact;  ///< Time until touchdown at the present climb rate (s)
+    bool valid;             ///< True if the height is known
+    uint32_t time_us;       ///< Time of the IMU sample the estimate is for, from micros() (us)
+    uint32_t sequence;      ///< Number of estimates published, including this one
+};
+
+#endif // _VERTICAL_H_
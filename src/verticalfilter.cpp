@@ -0,0 +1,235 @@
+/** @file verticalfilter.cpp
+ *  @brief This is the source file containing the constructor and methods for
+ *         a Kalman filter on height and climb rate.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include "verticalfilter.h"
+#include "rangefilter.h"
+
+/// Standard deviation of the height before the first ping (cm)
+#define VERTICAL_INIT_HEIGHT 500.0f
+
+/// Standard deviation of the climb rate at the start (cm/s)
+#define VERTICAL_INIT_CLIMB 100.0f
+
+/// Standard deviation of the acceleration bias at the start (cm/s^2)
+#define VERTICAL_INIT_BIAS 30.0f
+
+/** @brief   Constructor which creates a filter with no height yet
+ *  @details The glider is taken to start at rest, with no bias.
+ *  @param   accel_noise Noise density of the vertical acceleration, which
+ *           includes vibration and the attitude estimate's errors
+ *           (cm/s^2/sqrt(Hz))
+ *  @param   bias_walk Rate at which the acceleration bias wanders
+ *           (cm/s^2/sqrt(s))
+ *  @param   range_noise Standard deviation of one ping (cm)
+ *  @param   ground Height the sensor reads when the glider is on the ground,
+ *           at which the time to contact is zero (cm)
+ */
+VerticalFilter::VerticalFilter(float accel_noise, float bias_walk,
+                               float range_noise, float ground)
+{
+    accel_var = accel_noise * accel_noise;
+    bias_var = bias_walk * bias_walk;
+    range_var = range_noise * range_noise;
+    ground_cm = ground;
+    first_cm = 0;
+    first_us = 0;
+    accepted = 0;
+    rejects = 0;
+    misses = 0;
+
+    x = Matrix<3, 1>::zeros();
+    P = Matrix<3, 3>::zeros();
+    P(0, 0) = VERTICAL_INIT_HEIGHT * VERTICAL_INIT_HEIGHT;
+    P(1, 1) = VERTICAL_INIT_CLIMB * VERTICAL_INIT_CLIMB;
+    P(2, 2) = VERTICAL_INIT_BIAS * VERTICAL_INIT_BIAS;
+}
+
+/** @brief   Starts the height again at one ping
+ *  @details The climb rate and bias are kept until the next ping, but their
+ *           covariance goes back to its starting value, since they may have
+ *           been pulled far off by a spurious ping.
+ *  @param   ping The ping, from @c Ultrasonic::wait_for_range()
+ */
+void VerticalFilter::restart(const Range& ping)
+{
+    x(0, 0) = ping.distance;
+    P = Matrix<3, 3>::zeros();
+    P(0, 0) = range_var;
+    P(1, 1) = VERTICAL_INIT_CLIMB * VERTICAL_INIT_CLIMB;
+    P(2, 2) = VERTICAL_INIT_BIAS * VERTICAL_INIT_BIAS;
+    first_cm = ping.distance;
+    first_us = ping.time_us;
+    accepted = 1;
+    rejects = 0;
+}
+
+/** @brief   Sets the height and climb rate from the ping after a start
+ *  @details The climb rate is the slope between the two pings, and its
+ *           covariance with the height follows from the noise of each.
+ *  @param   ping The second ping since the start
+ *  @param   age Time from when the ping was sent to the time of the states (s)
+ *  @returns True if the two pings agree on a possible climb rate, false if
+ *           the first was spurious
+ */
+bool VerticalFilter::start_climb(const Range& ping, float age)
+{
+    float dt = (int32_t)(ping.time_us - first_us) * 1e-6f;
+    if (dt <= 0)
+    {
+        return false;
+    }
+    float climb = (ping.distance - first_cm) / dt;
+    if (fabsf(climb) > VERTICAL_MAX_CLIMB)
+    {
+        return false;
+    }
+
+    x(0, 0) = ping.distance + climb * age;
+    x(1, 0) = climb;
+    P = Matrix<3, 3>::zeros();
+    P(0, 0) = range_var;
+    P(0, 1) = P(1, 0) = range_var / dt;
+    P(1, 1) = 2 * range_var / (dt * dt);
+    P(2, 2) = VERTICAL_INIT_BIAS * VERTICAL_INIT_BIAS;
+    accepted = 2;
+    return true;
+}
+
+/** @brief   Moves the states forward by one step of measured acceleration
+ *  @details With the bias taken off, the acceleration is integrated into the
+ *           climb rate and height, so the transition matrix is
+ *           [1, dt, -dt^2/2; 0, 1, -dt; 0, 0, 1]. The acceleration noise
+ *           enters as white noise on the climb rate and the bias as a random
+ *           walk.
+ *  @param   accel Upward acceleration less gravity, from the IMU (m/s^2)
+ *  @param   dt Length of the step (s)
+ */
+void VerticalFilter::predict(float accel, float dt)
+{
+    if (dt <= 0)
+    {
+        return;
+    }
+    float a = 100.0f * accel - x(2, 0);
+    x(0, 0) += (x(1, 0) + 0.5f * a * dt) * dt;
+    x(1, 0) += a * dt;
+
+    Matrix<3, 3> F =
+    {{
+        { 1, dt, -0.5f * dt * dt },
+        { 0, 1,  -dt },
+        { 0, 0,  1 }
+    }};
+    P = F * P * F.transpose();
+    float q = accel_var * dt;
+    P(0, 0) += q * dt * dt * (1.0f / 3.0f);
+    P(0, 1) += q * dt * 0.5f;
+    P(1, 0) += q * dt * 0.5f;
+    P(1, 1) += q;
+    P(2, 2) += bias_var * dt;
+    P.symmetrize();
+}
+
+/** @brief   Corrects the states with one ping
+ *  @details The ping measured the height when it was sent, @c now_us minus
+ *           its age, which the climb rate takes back to; so the measurement
+ *           matrix is [1, -age, 0].
+ *  @param   ping The ping, from @c Ultrasonic::wait_for_range()
+ *  @param   now_us The time the states are for, from micros() (us)
+ *  @returns True if the ping was used, false if it had no echo or was
+ *           rejected by the gate
+ */
+bool VerticalFilter::correct(const Range& ping, uint32_t now_us)
+{
+    if (!ping.valid)
+    {
+        if (++misses >= RANGE_MAX_MISSES)
+        {
+            accepted = 0;
+        }
+        return false;
+    }
+    misses = 0;
+
+    if (accepted == 0)
+    {
+        restart(ping);
+        return true;
+    }
+
+    // The ping may be a little newer or older than the IMU sample
+    float age = (int32_t)(now_us - ping.time_us) * 1e-6f;
+    if (accepted == 1)
+    {
+        if (!start_climb(ping, age))
+        {
+            restart(ping);
+        }
+        return true;
+    }
+    Matrix<1, 3> H = {{ { 1, -age, 0 } }};
+    float y = ping.distance - (x(0, 0) - age * x(1, 0));
+    Matrix<3, 1> PHt = P * H.transpose();
+    float S = (H * PHt)(0, 0) + range_var;
+
+    if (y * y > VERTICAL_GATE_SIGMA * VERTICAL_GATE_SIGMA * S)
+    {
+        if (++rejects > RANGE_MAX_REJECTS)
+        {
+            restart(ping);
+            return true;
+        }
+        return false;
+    }
+    rejects = 0;
+
+    Matrix<3, 1> K = PHt * (1.0f / S);
+    x = x + K * y;
+    P = P - K * PHt.transpose();
+    P.symmetrize();
+    if (accepted < 255)
+    {
+        accepted++;
+    }
+    return true;
+}
+
+/** @brief   Finds the time until touchdown at the present climb rate
+ *  @details Acceleration is left out. The flare will change it, and the time
+ *           is wanted to decide when to start the flare.
+ *  @returns The time until the sensor is at its on-the-ground height (s),
+ *           or @c VERTICAL_NO_CONTACT if the glider is not coming down
+ */
+float VerticalFilter::get_time_to_contact(void)
+{
+    float descent = -x(1, 0);
+    if (descent < VERTICAL_MIN_DESCENT)
+    {
+        return VERTICAL_NO_CONTACT;
+    }
+    float time = (x(0, 0) - ground_cm) / descent;
+    if (time < 0)
+    {
+        return 0;
+    }
+    return (time < VERTICAL_NO_CONTACT) ? time : VERTICAL_NO_CONTACT;
+}
+
+/** @brief   Fills in a snapshot of the estimate
+ *  @details The time and sequence number are left for the caller to set.
+ *  @param   state The snapshot to fill in
+ */
+void VerticalFilter::get_state(VerticalState& state)
+{
+    state.height = get_height();
+    state.climb_rate = get_climb_rate();
+    state.valid = is_valid();
+    state.time_to_contact = state.valid ? get_time_to_contact() : VERTICAL_NO_CONTACT;
+}
@@ -0,0 +1,102 @@
+/** @file verticalfilter.h
+ *  @brief The header file for a Kalman filter which fuses ultrasonic pings
+ *         with the IMU's vertical acceleration into a height, climb rate and
+ *         time to contact.
+ *
+ *  @author  ME 507 Airheads
+ *  @date    2026-Oct-16 Original file
+ */
+
+// Compile this header file only once
+#ifndef _VERTICALFILTER_H_
+#define _VERTICALFILTER_H_
+
+#include <Arduino.h>
+#include "matrix.h"
+#include "range.h"
+#include "vertical.h"
+
+/// Innovations larger than this many standard deviations are rejected
+#define VERTICAL_GATE_SIGMA 3.0f
+
+/// Fastest climb or descent which two pings in a row may show (cm/s)
+#define VERTICAL_MAX_CLIMB 500.0f
+
+/// Slowest descent for which a time to contact is given (cm/s)
+#define VERTICAL_MIN_DESCENT 5.0f
+
+/** @brief  Class which estimates height and climb rate from ultrasonic
+ *          pings and vertical acceleration.
+ *  @details The states are the height (cm), the climb rate (cm/s) and the
+ *           bias of the vertical acceleration (cm/s^2), which soaks up the
+ *           accelerometer's offset and scale error and the slight tilt of the
+ *           attitude estimate. Each batch of IMU samples predicts the states
+ *           forward with the measured acceleration, so the height and climb
+ *           rate are updated at the IMU rate rather than the ping rate.
+ *
+ *           Each ping corrects the states at the time the ping was sent,
+ *           which is up to a batch of IMU samples in the past; the predicted
+ *           height is taken back to that time with the climb rate. A ping
+ *           whose innovation is too large for the covariance, such as an echo
+ *           from grass, is dropped; if several in a row are dropped, the
+ *           ground really has moved, as over the edge of a ledge, and the
+ *           height starts again from the latest ping. After a start, the
+ *           climb rate is taken from the first two pings, since the one the
+ *           accelerometer has kept may be far off; if those two pings show an
+ *           impossible climb rate, the first was spurious and the start is
+ *           made again from the second. Several pings in a row with no echo
+ *           mean that the ground is out of range, and the height is no longer
+ *           valid, though the climb rate still follows the accelerometer.
+ */
+class VerticalFilter
+{
+protected:
+    Matrix<3, 1> x;                     ///< Height (cm), climb rate (cm/s) and acceleration bias (cm/s^2)
+    Matrix<3, 3> P;                     ///< Covariance of the states
+    float accel_var;                    ///< Acceleration noise density squared (cm^2/s^3)
+    float bias_var;                     ///< Bias random walk density squared (cm^2/s^5)
+    float range_var;                    ///< Variance of one ping (cm^2)
+    float ground_cm;                    ///< Height the sensor reads when the glider is on the ground (cm)
+    float first_cm;                     ///< Distance of the ping the height started again from (cm)
+    uint32_t first_us;                  ///< Time that ping was sent (us)
+    uint8_t accepted;                   ///< Pings accepted since the height started again
+    uint8_t rejects;                    ///< Pings in a row rejected by the gate
+    uint8_t misses;                     ///< Pings in a row with no echo
+
+    // Start the height again at one ping
+    void restart(const Range& ping);
+
+    // Set the height and climb rate from the ping after a start
+    bool start_climb(const Range& ping, float age);
+
+public:
+    // Create a filter with no height yet
+    VerticalFilter(float accel_noise = 30.0f, float bias_walk = 2.0f,
+                   float range_noise = 3.0f, float ground = 5.0f);
+
+    // Move the states forward by one step of measured acceleration
+    void predict(float accel, float dt);
+
+    // Correct the states with one ping, returning true if it was used
+    bool correct(const Range& ping, uint32_t now_us);
+
+    // Return true if the filter has a height
+    bool is_valid(void) { return accepted >= 2; }
+
+    // Return the estimated height (cm), meaningful if is_valid()
+    float get_height(void) { return x(0, 0); }
+
+    // Return the estimated climb rate (cm/s)
+    float get_climb_rate(void) { return x(1, 0); }
+
+    // Return the estimated bias of the vertical acceleration (cm/s^2)
+    float get_bias(void) { return x(2, 0); }
+
+    // Return the time until touchdown at the present climb rate (s)
+    float get_time_to_contact(void);
+
+    // Fill in a snapshot of the estimate
+    void get_state(VerticalState& state);
+};
+
+#endif // _VERTICALFILTER_H_